@@ -34,9 +34,27 @@ class Cartridge {
 	 */
 	std::unique_ptr<CartridgeMetadata> metadata;
 
+	/**
+	 * Hash of the ROM file
+	 */
+	uint64_t checksum;
+
+	/**
+	 * Hash the ROM data and parse its metadata
+	 */
+	void parse_data();
+
   public:
 	Cartridge(std::string filepath);
 
+	/**
+	 * Make a cartridge from a ROM that is already in memory. Unlike loading
+	 * from a file, the metadata is not printed.
+	 *
+	 * @param rom_data The whole ROM, at least as long as the header
+	 */
+	Cartridge(std::vector<uint8_t> rom_data);
+
 	/**
 	 * Read a value from the given address in the cartridge
 	 *
@@ -46,7 +64,8 @@ class Cartridge {
 	uint8_t read(Address address);
 
 	/**
-	 * Write data to the given address in the cartridge
+	 * Write data to the given address in the cartridge. Without a memory bank
+	 * controller there is nothing to write to, so the ROM is left as it is.
 	 *
 	 * @param address Address to write to
 	 * @param data Byte to write
@@ -71,6 +90,11 @@ class Cartridge {
 	 */
 	CartridgeMetadata *get_metadata();
 
+	/**
+	 * Get a hash of the ROM file that this cartridge was loaded from
+	 */
+	uint64_t get_checksum() const;
+
 	/**
 	 * DebuggerCore may read private members of this class
 	 */
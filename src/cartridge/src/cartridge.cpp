@@ -4,6 +4,7 @@
  */
 
 #include "cartridge/cartridge.h"
+#include "util/hash.h"
 #include "util/helpers.h"
 #include "util/log.h"
 
@@ -32,14 +33,7 @@ Cartridge::Cartridge(std::string rom_path) {
 		byte_input = std::vector<char>(rom_file_size, '\0');
 		rom_file.read(&byte_input[0], rom_file_size);
 		data = std::vector<uint8_t>(byte_input.begin(), byte_input.end());
-
-		// Parse the Meta Data of the Cartridge
-		metadata = std::make_unique<CartridgeMetadata>(data);
-		if (metadata->is_logo_valid) {
-			Log::verbose("ROM Verification Done!");
-		} else {
-			Log::error("ROM Verification Failed!");
-		}
+		parse_data();
 
 		// Display the Meta Data of the Cartridge
 		display_metadata();
@@ -50,16 +44,38 @@ Cartridge::Cartridge(std::string rom_path) {
 	}
 }
 
+Cartridge::Cartridge(std::vector<uint8_t> rom_data)
+    : data(std::move(rom_data)) {
+	parse_data();
+}
+
+void Cartridge::parse_data() {
+	checksum = hash_bytes(data.data(), data.size());
+
+	// Parse the Meta Data of the Cartridge
+	metadata = std::make_unique<CartridgeMetadata>(data);
+	if (metadata->is_logo_valid) {
+		Log::verbose("ROM Verification Done!");
+	} else {
+		Log::error("ROM Verification Failed!");
+	}
+}
+
 CartridgeMetadata *Cartridge::get_metadata() { return metadata.get(); }
 
+uint64_t Cartridge::get_checksum() const { return checksum; }
+
 uint8_t Cartridge::read(Address address) {
 	// Get data
 	return data[address];
 }
 
 void Cartridge::write(Address address, uint8_t byte) {
-	// Put data
-	data[address] = byte;
+	// Games write here to switch banks, which needs a memory bank controller
+	if (Log::is_enabled()) {
+		Log::warn("Ignoring write of " + num_to_hex(byte) + " to ROM at " +
+		          num_to_hex(address));
+	}
 }
 
 map<Address, InstructionLine> Cartridge::peek(Address start_addr, int lines) {
@@ -80,6 +80,35 @@ class Controller : public ControllerInterface {
 	 * @see ControllerInterface#release_button
 	 */
 	void release_button(Button button) override;
+
+	/**
+	 * Get the state of every button as a mask, with one bit for each button
+	 * in the same order as the buttons array
+	 *
+	 * @return Mask of buttons that are held down
+	 */
+	uint8_t get_buttons() const;
+
+	/**
+	 * Set the state of every button from a mask made by get_buttons
+	 *
+	 * @param mask Mask of buttons to hold down
+	 */
+	void set_buttons(uint8_t mask);
+
+	/**
+	 * Copy the buttons held and the selected lines
+	 *
+	 * @param state State to fill in
+	 */
+	void save_state(ControllerState &state) const;
+
+	/**
+	 * Put the controller back into a state made by save_state
+	 *
+	 * @param state State to restore
+	 */
+	void load_state(const ControllerState &state);
 };
 
 } // namespace controller
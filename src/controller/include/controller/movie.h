@@ -0,0 +1,100 @@
+/**
+ * @file movie.h
+ * Declares the InputMovie class, a recording of the buttons held each frame
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace controller {
+
+/**
+ * The buttons held down on every frame of a run, along with what is needed to
+ * check that a replay starts from the same place: a checksum of the ROM, and
+ * a hash of the emulator state before the first frame.
+ *
+ * Movies are saved as a "TVPM" header and a version byte, then the checksum,
+ * state hash and frame count as little endian uint64s. The frames follow as
+ * runs, each one a button mask byte and the number of frames that it is held
+ * for as an unsigned LEB128 number. Buttons rarely change from one frame to
+ * the next, so a movie takes a few bytes for every second of play.
+ */
+class InputMovie {
+  private:
+	/**
+	 * Checksum of the ROM that the movie was recorded with
+	 */
+	uint64_t rom_checksum;
+
+	/**
+	 * Hash of the emulator state before the first frame was run
+	 */
+	uint64_t initial_state_hash;
+
+	/**
+	 * Button mask for every frame, as made by Controller#get_buttons
+	 */
+	std::vector<uint8_t> frames;
+
+  public:
+	/**
+	 * Start an empty movie
+	 *
+	 * @param rom_checksum Checksum of the ROM being played
+	 * @param initial_state_hash Hash of the state that the movie starts from
+	 */
+	InputMovie(uint64_t rom_checksum = 0, uint64_t initial_state_hash = 0);
+
+	/**
+	 * Add the buttons held for the next frame
+	 *
+	 * @param buttons Mask of buttons held down
+	 */
+	void add_frame(uint8_t buttons);
+
+	/**
+	 * Get the buttons held on a frame. Nothing is held after the last frame.
+	 *
+	 * @param frame Index of the frame
+	 * @return Mask of buttons held down
+	 */
+	uint8_t get_frame(std::size_t frame) const;
+
+	/**
+	 * Get the number of frames in the movie
+	 */
+	std::size_t get_frame_count() const;
+
+	/**
+	 * Get the checksum of the ROM that the movie was recorded with
+	 */
+	uint64_t get_rom_checksum() const;
+
+	/**
+	 * Get the hash of the emulator state before the first frame
+	 */
+	uint64_t get_initial_state_hash() const;
+
+	/**
+	 * Write the movie to a file
+	 *
+	 * @param path Path of the file
+	 * @return True if the whole movie was written
+	 */
+	bool save(const std::string &path) const;
+
+	/**
+	 * Read a movie from a file
+	 *
+	 * @param path Path of the file
+	 * @return The movie, or nothing if the file is missing or malformed
+	 */
+	static std::optional<InputMovie> load(const std::string &path);
+};
+
+} // namespace controller
@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include "util/spsc_queue.h"
+
+#include <cstdint>
+
 namespace controller {
 
 /**
@@ -21,4 +25,47 @@ enum class Button {
 	START,
 };
 
+/**
+ * State of the controller, as plain data
+ */
+struct ControllerState {
+	/**
+	 * Mask of the buttons held down, as made by Controller#get_buttons
+	 */
+	uint8_t buttons;
+
+	/**
+	 * Whether the buttons or the directions are selected for reading
+	 */
+	bool button_flag;
+	bool direction_flag;
+};
+
+/**
+ * Represents a button being pressed or released by the user
+ */
+struct InputEvent {
+	/**
+	 * The button that changed
+	 */
+	Button button;
+
+	/**
+	 * True if the button was pressed, false if it was released
+	 */
+	bool pressed;
+
+	/**
+	 * Emulated clock cycle at which the change takes effect. Events stamped
+	 * with a cycle that has already passed are applied straight away.
+	 */
+	uint64_t cycle;
+};
+
+/**
+ * Queue of input events, from the thread that reads input to the thread that
+ * runs the emulator. Events must be pushed in order of their cycle.
+ */
+using InputQueue = SPSCQueue<InputEvent, 256>;
+
 } // namespace controller
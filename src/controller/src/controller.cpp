@@ -10,7 +10,9 @@
 
 namespace controller {
 
-Controller::Controller() : buttons(std::array<bool, 8>{}) {}
+Controller::Controller()
+    : buttons(std::array<bool, 8>{}), button_flag(false),
+      direction_flag(false) {}
 
 int Controller::button_index(Button button) {
 	// Return the corresponding index
@@ -74,4 +76,30 @@ void Controller::press_button(Button button) { set_button(button, true); }
 
 void Controller::release_button(Button button) { set_button(button, false); }
 
+uint8_t Controller::get_buttons() const {
+	auto mask = uint8_t{0};
+	for (auto i = 0u; i < buttons.size(); ++i) {
+		mask |= buttons[i] << i;
+	}
+	return mask;
+}
+
+void Controller::set_buttons(uint8_t mask) {
+	for (auto i = 0u; i < buttons.size(); ++i) {
+		buttons[i] = (mask >> i) & 1;
+	}
+}
+
+void Controller::save_state(ControllerState &state) const {
+	state.buttons = get_buttons();
+	state.button_flag = button_flag;
+	state.direction_flag = direction_flag;
+}
+
+void Controller::load_state(const ControllerState &state) {
+	set_buttons(state.buttons);
+	button_flag = state.button_flag;
+	direction_flag = state.direction_flag;
+}
+
 } // namespace controller
@@ -0,0 +1,151 @@
+/**
+ * @file movie.cpp
+ * Defines the InputMovie class
+ */
+
+#include "controller/movie.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace controller {
+
+/**
+ * Header of a movie file, and the version of the format
+ */
+const std::string MOVIE_HEADER = "TVPM";
+const uint8_t MOVIE_VERSION = 1;
+
+/**
+ * Append a little endian uint64
+ */
+static void put_u64(std::string &out, uint64_t value) {
+	for (auto i = 0; i < 8; ++i) {
+		out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+}
+
+/**
+ * Append an unsigned LEB128 number, 7 bits to a byte with the high bit set on
+ * every byte but the last
+ */
+static void put_varint(std::string &out, uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+/**
+ * Read a little endian uint64 at pos, and move past it
+ */
+static bool get_u64(const std::string &in, std::size_t &pos, uint64_t &value) {
+	if (in.size() - pos < 8) {
+		return false;
+	}
+
+	value = 0;
+	for (auto i = 0; i < 8; ++i) {
+		value |= uint64_t{static_cast<uint8_t>(in[pos++])} << (i * 8);
+	}
+	return true;
+}
+
+/**
+ * Read an unsigned LEB128 number at pos, and move past it
+ */
+static bool get_varint(const std::string &in, std::size_t &pos,
+                       uint64_t &value) {
+	value = 0;
+	for (auto shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+		auto byte = static_cast<uint8_t>(in[pos++]);
+		value |= uint64_t{byte & 0x7Fu} << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+InputMovie::InputMovie(uint64_t rom_checksum, uint64_t initial_state_hash)
+    : rom_checksum(rom_checksum), initial_state_hash(initial_state_hash) {}
+
+void InputMovie::add_frame(uint8_t buttons) { frames.push_back(buttons); }
+
+uint8_t InputMovie::get_frame(std::size_t frame) const {
+	return frame < frames.size() ? frames[frame] : 0;
+}
+
+std::size_t InputMovie::get_frame_count() const { return frames.size(); }
+
+uint64_t InputMovie::get_rom_checksum() const { return rom_checksum; }
+
+uint64_t InputMovie::get_initial_state_hash() const {
+	return initial_state_hash;
+}
+
+bool InputMovie::save(const std::string &path) const {
+	auto out = MOVIE_HEADER;
+	out.push_back(static_cast<char>(MOVIE_VERSION));
+	put_u64(out, rom_checksum);
+	put_u64(out, initial_state_hash);
+	put_u64(out, frames.size());
+
+	// Write each run of identical frames as the mask and its length
+	for (auto start = std::size_t{0}; start < frames.size();) {
+		auto end = start + 1;
+		while (end < frames.size() && frames[end] == frames[start]) {
+			end++;
+		}
+
+		out.push_back(static_cast<char>(frames[start]));
+		put_varint(out, end - start);
+		start = end;
+	}
+
+	auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+	file.write(out.data(), out.size());
+	return file.good();
+}
+
+std::optional<InputMovie> InputMovie::load(const std::string &path) {
+	auto file = std::ifstream(path, std::ios::binary);
+	if (!file.is_open()) {
+		return std::nullopt;
+	}
+	auto in = std::string(std::istreambuf_iterator<char>(file), {});
+
+	auto header_size = MOVIE_HEADER.size() + 1;
+	if (in.size() < header_size ||
+	    in.compare(0, MOVIE_HEADER.size(), MOVIE_HEADER) != 0 ||
+	    static_cast<uint8_t>(in[header_size - 1]) != MOVIE_VERSION) {
+		return std::nullopt;
+	}
+
+	auto pos = header_size;
+	auto movie = InputMovie();
+	auto frame_count = uint64_t{0};
+	if (!get_u64(in, pos, movie.rom_checksum) ||
+	    !get_u64(in, pos, movie.initial_state_hash) ||
+	    !get_u64(in, pos, frame_count)) {
+		return std::nullopt;
+	}
+
+	while (pos < in.size()) {
+		auto buttons = static_cast<uint8_t>(in[pos++]);
+		auto length = uint64_t{0};
+		if (!get_varint(in, pos, length) ||
+		    length > frame_count - movie.frames.size()) {
+			return std::nullopt;
+		}
+		movie.frames.insert(movie.frames.end(), length, buttons);
+	}
+
+	if (movie.frames.size() != frame_count) {
+		return std::nullopt;
+	}
+	return movie;
+}
+
+} // namespace controller
@@ -13,7 +13,6 @@
 #include "debugger/debugger.fwd.h"
 
 #include <cstdint>
-#include <functional>
 #include <memory>
 #include <vector>
 
@@ -54,35 +53,41 @@ class CPU : public CPUInterface {
 	 */
 	std::unique_ptr<IDblReg> sp, pc;
 
+	/**
+	 * Runs one opcode on a CPU. Handlers capture nothing, so the tables of
+	 * them are shared by every CPU.
+	 */
+	using OpcodeHandler = void (*)(CPU &cpu);
+
 	/**
 	 * A map between the opcodes and the corresponding operation to do.
 	 * Maps each of 256 possible 8-bit opcodes to action functions.
 	 */
-	std::array<std::function<void()>, 256> opcode_map;
+	static const std::array<OpcodeHandler, 256> opcode_map;
 
 	/**
 	 * Similar to the opcode map, but for the 0xcb prefixed opcodes. These
 	 * extend the instruction set to enable more bit manipulation instructions
 	 */
-	std::array<std::function<void()>, 256> cb_opcode_map;
+	static const std::array<OpcodeHandler, 256> cb_opcode_map;
 
 	/**
 	 * Contains the number of CPU cycles taken to execute each instruction,
 	 * indexed by opcode
 	 */
-	std::array<ClockCycles, 256> cycles;
+	static const std::array<ClockCycles, 256> cycles;
 
 	/**
 	 * Contains the number of CPU cycles taken to execute each instruction,
 	 * given that the branch was taken. Changes only for JP, JR, RET, CALL
 	 */
-	std::array<ClockCycles, 256> cycles_branched;
+	static const std::array<ClockCycles, 256> cycles_branched;
 
 	/**
 	 * Contains the number of CPU cycles taken to execute each instruction,
 	 * for all CB prefixed instruction opcodes
 	 */
-	std::array<ClockCycles, 256> cycles_cb;
+	static const std::array<ClockCycles, 256> cycles_cb;
 
 	/**
 	 * Memory instance, for performing all reads and writes to main memory
@@ -281,6 +286,31 @@ class CPU : public CPUInterface {
 	 */
 	ClockCycles tick() override;
 
+	/**
+	 * Get the address of the next instruction
+	 */
+	uint16_t get_pc() const;
+
+	/**
+	 * Check whether the next tick fetches the instruction at the PC, rather
+	 * than handling an interrupt or staying halted
+	 */
+	bool will_fetch() const;
+
+	/**
+	 * Copy the registers and interrupt state of the CPU into a CPUState
+	 *
+	 * @param state State to fill in
+	 */
+	void save_state(CPUState &state) const;
+
+	/**
+	 * Put the CPU back into a state made by save_state
+	 *
+	 * @param state State to restore
+	 */
+	void load_state(const CPUState &state);
+
 	/**
 	 * Allow debugger to view private members of this class
 	 */
@@ -21,6 +21,42 @@ using OpCode = uint8_t;
  */
 using ClockCycles = uint64_t;
 
+/**
+ * Number of clock cycles the GameBoy runs per second
+ */
+const ClockCycles CLOCK_SPEED = 4194304;
+
+/**
+ * Everything needed to put the CPU back exactly as it was, as plain data
+ */
+struct CPUState {
+	/**
+	 * Standard 8-bit registers, in the order of the CPU fields
+	 */
+	uint8_t a, b, c, d, e, f, h, l;
+
+	/**
+	 * Stack Pointer and Program Counter
+	 */
+	uint16_t sp, pc;
+
+	/**
+	 * Interrupt Enable and Interrupt Flag registers
+	 */
+	uint8_t interrupt_enable, interrupt_flag;
+
+	/**
+	 * Halted, interrupt master enable and last branch flags
+	 */
+	bool halted, interrupt_enabled, branch_taken;
+
+	/**
+	 * Number of ticks run, and total cycles taken by them
+	 */
+	uint64_t ticks;
+	ClockCycles total_cpu_cycles;
+};
+
 /**
  * Flag Register bits reference:
  * ZERO      -> Set when the result of the previous transaction was zero
@@ -8,7 +8,6 @@
 #include "util/helpers.h"
 #include "util/log.h"
 
-#include <functional>
 #include <iostream>
 #include <memory/memory.h>
 #include <string>
@@ -32,590 +31,584 @@ CPU::CPU(std::unique_ptr<IReg> a, std::unique_ptr<IReg> b,
       hl(std::move(hl)), pc(std::move(pc)), sp(std::move(sp)),
       interrupt_flag(std::move(interrupt_flag)),
       interrupt_enable(std::move(interrupt_enable)), memory(memory),
-      halted(false), interrupt_enabled(true), branch_taken(false),
-
-      // Initialize the opcode map
-      opcode_map({
-          // clang-format off
-          /* 0x00 */ [&] { op_nop(); },
-          /* 0x01 */ [&] { op_ld_dbl(this->bc.get(), get_inst_dbl()); },
-          /* 0x02 */ [&] { op_ld(this->bc->get(), this->a->get()); },
-          /* 0x03 */ [&] { op_inc_dbl(this->bc.get()); },
-          /* 0x04 */ [&] { op_inc(this->b.get()); },
-          /* 0x05 */ [&] { op_dec(this->b.get()); },
-          /* 0x06 */ [&] { op_ld(this->b.get(), get_inst_byte()); },
-          /* 0x07 */ [&] { op_rlc_a(); },
-          /* 0x08 */ [&] { op_ld_dbl(static_cast<Address>(get_inst_dbl()), this->sp->get()); },
-          /* 0x09 */ [&] { op_add_hl(this->bc->get()); },
-          /* 0x0a */ [&] { op_ld(this->a.get(), this->memory->read(this->bc->get())); },
-          /* 0x0b */ [&] { op_dec_dbl(this->bc.get()); },
-          /* 0x0c */ [&] { op_inc(this->c.get()); },
-          /* 0x0d */ [&] { op_dec(this->c.get()); },
-          /* 0x0e */ [&] { op_ld(this->c.get(), get_inst_byte()); },
-          /* 0x0f */ [&] { op_rrc_a(); },
-          /* 0x10 */ [&] { op_stop(); },
-          /* 0x11 */ [&] { op_ld_dbl(this->de.get(), get_inst_dbl()); },
-          /* 0x12 */ [&] { op_ld(this->de->get(), this->a->get()); },
-          /* 0x13 */ [&] { op_inc_dbl(this->de.get()); },
-          /* 0x14 */ [&] { op_inc(this->d.get()); },
-          /* 0x15 */ [&] { op_dec(this->d.get()); },
-          /* 0x16 */ [&] { op_ld(this->d.get(), get_inst_byte()); },
-          /* 0x17 */ [&] { op_rl_a(); },
-          /* 0x18 */ [&] { op_jr(get_inst_byte()); },
-          /* 0x19 */ [&] { op_add_hl(this->de->get()); },
-          /* 0x1a */ [&] { op_ld(this->a.get(), this->memory->read(this->de->get())); },
-          /* 0x1b */ [&] { op_dec_dbl(this->de.get()); },
-          /* 0x1c */ [&] { op_inc(this->e.get()); },
-          /* 0x1d */ [&] { op_dec(this->e.get()); },
-          /* 0x1e */ [&] { op_ld(this->e.get(), get_inst_byte()); },
-          /* 0x1f */ [&] { op_rr_a(); },
-          /* 0x20 */ [&] { op_jr(!this->f->get_bit(flag::ZERO), get_inst_byte()); },
-          /* 0x21 */ [&] { op_ld_dbl(this->hl.get(), get_inst_dbl()); },
-          /* 0x22 */ [&] { op_ldi_addr(this->hl->get(), this->a->get()); },
-          /* 0x23 */ [&] { op_inc_dbl(this->hl.get()); },
-          /* 0x24 */ [&] { op_inc(this->h.get()); },
-          /* 0x25 */ [&] { op_dec(this->h.get()); },
-          /* 0x26 */ [&] { op_ld(this->h.get(), get_inst_byte()); },
-          /* 0x27 */ [&] { op_daa(); },
-          /* 0x28 */ [&] { op_jr(this->f->get_bit(flag::ZERO), get_inst_byte()); },
-          /* 0x29 */ [&] { op_add_hl(this->hl->get()); },
-          /* 0x2a */ [&] { op_ldi_a(this->memory->read(this->hl->get())); },
-          /* 0x2b */ [&] { op_dec_dbl(this->hl.get()); },
-          /* 0x2c */ [&] { op_inc(this->l.get()); },
-          /* 0x2d */ [&] { op_dec(this->l.get()); },
-          /* 0x2e */ [&] { op_ld(this->l.get(), get_inst_byte()); },
-          /* 0x2f */ [&] { op_cpl(); },
-          /* 0x30 */ [&] { op_jr(!this->f->get_bit(flag::CARRY), get_inst_byte()); },
-          /* 0x31 */ [&] { op_ld_dbl(this->sp.get(), get_inst_dbl()); },
-          /* 0x32 */ [&] { op_ldd_addr(static_cast<Address>(this->hl->get()), this->a->get()); },
-          /* 0x33 */ [&] { op_inc_dbl(this->sp.get()); },
-          /* 0x34 */ [&] { op_inc(static_cast<Address>(this->hl->get())); },
-          /* 0x35 */ [&] { op_dec(static_cast<Address>(this->hl->get())); },
-          /* 0x36 */ [&] { op_ld(static_cast<Address>(this->hl->get()), get_inst_byte()); },
-          /* 0x37 */ [&] { op_scf(); },
-          /* 0x38 */ [&] { op_jr(this->f->get_bit(flag::CARRY), get_inst_byte()); },
-          /* 0x39 */ [&] { op_add_hl(this->sp->get()); },
-          /* 0x3a */ [&] { op_ldd_a(this->memory->read(this->hl->get())); },
-          /* 0x3b */ [&] { op_dec_dbl(this->sp.get()); },
-          /* 0x3c */ [&] { op_inc(this->a.get()); },
-          /* 0x3d */ [&] { op_dec(this->a.get()); },
-          /* 0x3e */ [&] { op_ld(this->a.get(), get_inst_byte()); },
-          /* 0x3f */ [&] { op_ccf(); },
-          /* 0x40 */ [&] { op_ld(this->b.get(), this->b->get()); },
-          /* 0x41 */ [&] { op_ld(this->b.get(), this->c->get()); },
-          /* 0x42 */ [&] { op_ld(this->b.get(), this->d->get()); },
-          /* 0x43 */ [&] { op_ld(this->b.get(), this->e->get()); },
-          /* 0x44 */ [&] { op_ld(this->b.get(), this->h->get()); },
-          /* 0x45 */ [&] { op_ld(this->b.get(), this->l->get()); },
-          /* 0x46 */ [&] { op_ld(this->b.get(), this->memory->read(this->hl->get())); },
-          /* 0x47 */ [&] { op_ld(this->b.get(), this->a->get()); },
-          /* 0x48 */ [&] { op_ld(this->c.get(), this->b->get()); },
-          /* 0x49 */ [&] { op_ld(this->c.get(), this->c->get()); },
-          /* 0x4a */ [&] { op_ld(this->c.get(), this->d->get()); },
-          /* 0x4b */ [&] { op_ld(this->c.get(), this->e->get()); },
-          /* 0x4c */ [&] { op_ld(this->c.get(), this->h->get()); },
-          /* 0x4d */ [&] { op_ld(this->c.get(), this->l->get()); },
-          /* 0x4e */ [&] { op_ld(this->c.get(), this->memory->read(this->hl->get())); },
-          /* 0x4f */ [&] { op_ld(this->c.get(), this->a->get()); },
-          /* 0x50 */ [&] { op_ld(this->d.get(), this->b->get()); },
-          /* 0x51 */ [&] { op_ld(this->d.get(), this->c->get()); },
-          /* 0x52 */ [&] { op_ld(this->d.get(), this->d->get()); },
-          /* 0x53 */ [&] { op_ld(this->d.get(), this->e->get()); },
-          /* 0x54 */ [&] { op_ld(this->d.get(), this->h->get()); },
-          /* 0x55 */ [&] { op_ld(this->d.get(), this->l->get()); },
-          /* 0x56 */ [&] { op_ld(this->d.get(), this->memory->read(this->hl->get())); },
-          /* 0x57 */ [&] { op_ld(this->d.get(), this->a->get()); },
-          /* 0x58 */ [&] { op_ld(this->e.get(), this->b->get()); },
-          /* 0x59 */ [&] { op_ld(this->e.get(), this->c->get()); },
-          /* 0x5a */ [&] { op_ld(this->e.get(), this->d->get()); },
-          /* 0x5b */ [&] { op_ld(this->e.get(), this->e->get()); },
-          /* 0x5c */ [&] { op_ld(this->e.get(), this->h->get()); },
-          /* 0x5d */ [&] { op_ld(this->e.get(), this->l->get()); },
-          /* 0x5e */ [&] { op_ld(this->e.get(), this->memory->read(this->hl->get())); },
-          /* 0x5f */ [&] { op_ld(this->e.get(), this->a->get()); },
-          /* 0x60 */ [&] { op_ld(this->h.get(), this->b->get()); },
-          /* 0x61 */ [&] { op_ld(this->h.get(), this->c->get()); },
-          /* 0x62 */ [&] { op_ld(this->h.get(), this->d->get()); },
-          /* 0x63 */ [&] { op_ld(this->h.get(), this->e->get()); },
-          /* 0x64 */ [&] { op_ld(this->h.get(), this->h->get()); },
-          /* 0x65 */ [&] { op_ld(this->h.get(), this->l->get()); },
-          /* 0x66 */ [&] { op_ld(this->h.get(), this->memory->read(this->hl->get())); },
-          /* 0x67 */ [&] { op_ld(this->h.get(), this->a->get()); },
-          /* 0x68 */ [&] { op_ld(this->l.get(), this->b->get()); },
-          /* 0x69 */ [&] { op_ld(this->l.get(), this->c->get()); },
-          /* 0x6a */ [&] { op_ld(this->l.get(), this->d->get()); },
-          /* 0x6b */ [&] { op_ld(this->l.get(), this->e->get()); },
-          /* 0x6c */ [&] { op_ld(this->l.get(), this->h->get()); },
-          /* 0x6d */ [&] { op_ld(this->l.get(), this->l->get()); },
-          /* 0x6e */ [&] { op_ld(this->l.get(), this->memory->read(this->hl->get())); },
-          /* 0x6f */ [&] { op_ld(this->l.get(), this->a->get()); },
-          /* 0x70 */ [&] { op_ld(static_cast<Address>(this->hl->get()), this->b->get()); },
-          /* 0x71 */ [&] { op_ld(static_cast<Address>(this->hl->get()), this->c->get()); },
-          /* 0x72 */ [&] { op_ld(static_cast<Address>(this->hl->get()), this->d->get()); },
-          /* 0x73 */ [&] { op_ld(static_cast<Address>(this->hl->get()), this->e->get()); },
-          /* 0x74 */ [&] { op_ld(static_cast<Address>(this->hl->get()), this->h->get()); },
-          /* 0x75 */ [&] { op_ld(static_cast<Address>(this->hl->get()), this->l->get()); },
-          /* 0x76 */ [&] { op_halt(); },
-          /* 0x77 */ [&] { op_ld(static_cast<Address>(this->hl->get()), this->a->get()); },
-          /* 0x78 */ [&] { op_ld(this->a.get(), this->b->get()); },
-          /* 0x79 */ [&] { op_ld(this->a.get(), this->c->get()); },
-          /* 0x7a */ [&] { op_ld(this->a.get(), this->d->get()); },
-          /* 0x7b */ [&] { op_ld(this->a.get(), this->e->get()); },
-          /* 0x7c */ [&] { op_ld(this->a.get(), this->h->get()); },
-          /* 0x7d */ [&] { op_ld(this->a.get(), this->l->get()); },
-          /* 0x7e */ [&] { op_ld(this->a.get(), this->memory->read(this->hl->get())); },
-          /* 0x7f */ [&] { op_ld(this->a.get(), this->a->get()); },
-          /* 0x80 */ [&] { op_add(this->b->get()); },
-          /* 0x81 */ [&] { op_add(this->c->get()); },
-          /* 0x82 */ [&] { op_add(this->d->get()); },
-          /* 0x83 */ [&] { op_add(this->e->get()); },
-          /* 0x84 */ [&] { op_add(this->h->get()); },
-          /* 0x85 */ [&] { op_add(this->l->get()); },
-          /* 0x86 */ [&] { op_add(this->memory->read(this->hl->get())); },
-          /* 0x87 */ [&] { op_add(this->a->get()); },
-          /* 0x88 */ [&] { op_adc(this->b->get()); },
-          /* 0x89 */ [&] { op_adc(this->c->get()); },
-          /* 0x8a */ [&] { op_adc(this->d->get()); },
-          /* 0x8b */ [&] { op_adc(this->e->get()); },
-          /* 0x8c */ [&] { op_adc(this->h->get()); },
-          /* 0x8d */ [&] { op_adc(this->l->get()); },
-          /* 0x8e */ [&] { op_adc(this->memory->read(this->hl->get())); },
-          /* 0x8f */ [&] { op_adc(this->a->get()); },
-          /* 0x90 */ [&] { op_sub(this->b->get()); },
-          /* 0x91 */ [&] { op_sub(this->c->get()); },
-          /* 0x92 */ [&] { op_sub(this->d->get()); },
-          /* 0x93 */ [&] { op_sub(this->e->get()); },
-          /* 0x94 */ [&] { op_sub(this->h->get()); },
-          /* 0x95 */ [&] { op_sub(this->l->get()); },
-          /* 0x96 */ [&] { op_sub(this->memory->read(this->hl->get())); },
-          /* 0x97 */ [&] { op_sub(this->a->get()); },
-          /* 0x98 */ [&] { op_sbc(this->b->get()); },
-          /* 0x99 */ [&] { op_sbc(this->c->get()); },
-          /* 0x9a */ [&] { op_sbc(this->d->get()); },
-          /* 0x9b */ [&] { op_sbc(this->e->get()); },
-          /* 0x9c */ [&] { op_sbc(this->h->get()); },
-          /* 0x9d */ [&] { op_sbc(this->l->get()); },
-          /* 0x9e */ [&] { op_sbc(this->memory->read(this->hl->get())); },
-          /* 0x9f */ [&] { op_sbc(this->a->get()); },
-          /* 0xa0 */ [&] { op_and(this->b->get()); },
-          /* 0xa1 */ [&] { op_and(this->c->get()); },
-          /* 0xa2 */ [&] { op_and(this->d->get()); },
-          /* 0xa3 */ [&] { op_and(this->e->get()); },
-          /* 0xa4 */ [&] { op_and(this->h->get()); },
-          /* 0xa5 */ [&] { op_and(this->l->get()); },
-          /* 0xa6 */ [&] { op_and(this->memory->read(this->hl->get())); },
-          /* 0xa7 */ [&] { op_and(this->a->get()); },
-          /* 0xa8 */ [&] { op_xor(this->b->get()); },
-          /* 0xa9 */ [&] { op_xor(this->c->get()); },
-          /* 0xaa */ [&] { op_xor(this->d->get()); },
-          /* 0xab */ [&] { op_xor(this->e->get()); },
-          /* 0xac */ [&] { op_xor(this->h->get()); },
-          /* 0xad */ [&] { op_xor(this->l->get()); },
-          /* 0xae */ [&] { op_xor(this->memory->read(this->hl->get())); },
-          /* 0xaf */ [&] { op_xor(this->a->get()); },
-          /* 0xb0 */ [&] { op_or(this->b->get()); },
-          /* 0xb1 */ [&] { op_or(this->c->get()); },
-          /* 0xb2 */ [&] { op_or(this->d->get()); },
-          /* 0xb3 */ [&] { op_or(this->e->get()); },
-          /* 0xb4 */ [&] { op_or(this->h->get()); },
-          /* 0xb5 */ [&] { op_or(this->l->get()); },
-          /* 0xb6 */ [&] { op_or(this->memory->read(this->hl->get())); },
-          /* 0xb7 */ [&] { op_or(this->a->get()); },
-          /* 0xb8 */ [&] { op_cp(this->b->get()); },
-          /* 0xb9 */ [&] { op_cp(this->c->get()); },
-          /* 0xba */ [&] { op_cp(this->d->get()); },
-          /* 0xbb */ [&] { op_cp(this->e->get()); },
-          /* 0xbc */ [&] { op_cp(this->h->get()); },
-          /* 0xbd */ [&] { op_cp(this->l->get()); },
-          /* 0xbe */ [&] { op_cp(this->memory->read(this->hl->get())); },
-          /* 0xbf */ [&] { op_cp(this->a->get()); },
-          /* 0xc0 */ [&] { op_ret(!this->f->get_bit(flag::ZERO)); },
-          /* 0xc1 */ [&] { op_pop(this->bc.get()); },
-          /* 0xc2 */ [&] { op_jp(!this->f->get_bit(flag::ZERO), get_inst_dbl()); },
-          /* 0xc3 */ [&] { op_jp(get_inst_dbl()); },
-          /* 0xc4 */ [&] { op_call(!this->f->get_bit(flag::ZERO), get_inst_dbl()); },
-          /* 0xc5 */ [&] { op_push(this->bc.get()); },
-          /* 0xc6 */ [&] { op_add(get_inst_byte()); },
-          /* 0xc7 */ [&] { op_rst(0x00); },
-          /* 0xc8 */ [&] { op_ret(this->f->get_bit(flag::ZERO)); },
-          /* 0xc9 */ [&] { op_ret(); },
-          /* 0xca */ [&] { op_jp(this->f->get_bit(flag::ZERO), get_inst_dbl()); },
-          /* 0xcb */ [&] { /* CB Opcodes handled separately */ },
-          /* 0xcc */ [&] { op_call(this->f->get_bit(flag::ZERO), get_inst_dbl()); },
-          /* 0xcd */ [&] { op_call(get_inst_dbl()); },
-          /* 0xce */ [&] { op_adc(get_inst_byte()); },
-          /* 0xcf */ [&] { op_rst(0x08); },
-          /* 0xd0 */ [&] { op_ret(!this->f->get_bit(flag::CARRY)); },
-          /* 0xd1 */ [&] { op_pop(this->de.get()); },
-          /* 0xd2 */ [&] { op_jp(!this->f->get_bit(flag::CARRY), get_inst_dbl()); },
-          /* 0xd3 */ [&] { /* UNDEFINED */ },
-          /* 0xd4 */ [&] { op_call(!this->f->get_bit(flag::CARRY), get_inst_dbl()); },
-          /* 0xd5 */ [&] { op_push(this->de.get()); },
-          /* 0xd6 */ [&] { op_sub(get_inst_byte()); },
-          /* 0xd7 */ [&] { op_rst(0x10); },
-          /* 0xd8 */ [&] { op_ret(this->f->get_bit(flag::CARRY)); },
-          /* 0xd9 */ [&] { op_reti(); },
-          /* 0xda */ [&] { op_jp(this->f->get_bit(flag::CARRY), get_inst_dbl()); },
-          /* 0xdb */ [&] { /* UNDEFINED */ },
-          /* 0xdc */ [&] { op_call(this->f->get_bit(flag::CARRY), get_inst_dbl()); },
-          /* 0xdd */ [&] { /* UNDEFINED */ },
-          /* 0xde */ [&] { op_sbc(get_inst_byte()); },
-          /* 0xdf */ [&] { op_rst(0x18); },
-          /* 0xe0 */ [&] { op_ldh_addr(0xFF00 + get_inst_byte(), this->a->get()); },
-          /* 0xe1 */ [&] { op_pop(this->hl.get()); },
-          /* 0xe2 */ [&] { op_ld(static_cast<Address>(0xFF00 + this->c->get()), this->a->get()); },
-          /* 0xe3 */ [&] { /* UNDEFINED */ },
-          /* 0xe4 */ [&] { /* UNDEFINED */ },
-          /* 0xe5 */ [&] { op_push(this->hl.get()); },
-          /* 0xe6 */ [&] { op_and(get_inst_byte()); },
-          /* 0xe7 */ [&] { op_rst(0x20); },
-          /* 0xe8 */ [&] { op_add_sp(static_cast<int8_t>(get_inst_byte())); },
-          /* 0xe9 */ [&] { op_jp(this->hl->get()); },
-          /* 0xea */ [&] { op_ld(static_cast<Address>(get_inst_dbl()), this->a->get()); },
-          /* 0xeb */ [&] { /* UNDEFINED */ },
-          /* 0xec */ [&] { /* UNDEFINED */ },
-          /* 0xed */ [&] { /* UNDEFINED */ },
-          /* 0xee */ [&] { op_xor(get_inst_byte()); },
-          /* 0xef */ [&] { op_rst(0x28); },
-          /* 0xf0 */ [&] { op_ldh_a(this->memory->read(0xFF00 + get_inst_byte())); },
-          /* 0xf1 */ [&] { op_pop(this->af.get(), true); },
-          /* 0xf2 */ [&] { op_ld(this->a.get(), this->memory->read(0xFF00 + this->c->get())); },
-          /* 0xf3 */ [&] { op_di(); },
-          /* 0xf4 */ [&] { /* UNDEFINED */ },
-          /* 0xf5 */ [&] { op_push(this->af.get()); },
-          /* 0xf6 */ [&] { op_or(get_inst_byte()); },
-          /* 0xf7 */ [&] { op_rst(0x30); },
-          /* 0xf8 */ [&] { op_ld_hl_sp_offset(static_cast<int8_t>(get_inst_byte())); },
-          /* 0xf9 */ [&] { op_ld_dbl(this->sp.get(), this->hl->get()); },
-          /* 0xfa */ [&] { op_ld(this->a.get(), this->memory->read(get_inst_dbl())); },
-          /* 0xfb */ [&] { op_ei(); },
-          /* 0xfc */ [&] { /* UNDEFINED */ },
-          /* 0xfd */ [&] { /* UNDEFINED */ },
-          /* 0xfe */ [&] { op_cp(get_inst_byte()); },
-          /* 0xff */ [&] { op_rst(0x38); },
-          // clang-format on
-      }),
-
-      // Initialize the CB opcode map
-      cb_opcode_map({
-          // clang-format off
-          /* 0x00 */ [&] { op_rlc(this->b.get()); },
-          /* 0x01 */ [&] { op_rlc(this->c.get()); },
-          /* 0x02 */ [&] { op_rlc(this->d.get()); },
-          /* 0x03 */ [&] { op_rlc(this->e.get()); },
-          /* 0x04 */ [&] { op_rlc(this->h.get()); },
-          /* 0x05 */ [&] { op_rlc(this->l.get()); },
-          /* 0x06 */ [&] { op_rlc(static_cast<Address>(this->hl->get())); },
-          /* 0x07 */ [&] { op_rlc(this->a.get()); },
-          /* 0x08 */ [&] { op_rrc(this->b.get()); },
-          /* 0x09 */ [&] { op_rrc(this->c.get()); },
-          /* 0x0a */ [&] { op_rrc(this->d.get()); },
-          /* 0x0b */ [&] { op_rrc(this->e.get()); },
-          /* 0x0c */ [&] { op_rrc(this->h.get()); },
-          /* 0x0d */ [&] { op_rrc(this->l.get()); },
-          /* 0x0e */ [&] { op_rrc(static_cast<Address>(this->hl->get())); },
-          /* 0x0f */ [&] { op_rrc(this->a.get()); },
-          /* 0x10 */ [&] { op_rl(this->b.get()); },
-          /* 0x11 */ [&] { op_rl(this->c.get()); },
-          /* 0x12 */ [&] { op_rl(this->d.get()); },
-          /* 0x13 */ [&] { op_rl(this->e.get()); },
-          /* 0x14 */ [&] { op_rl(this->h.get()); },
-          /* 0x15 */ [&] { op_rl(this->l.get()); },
-          /* 0x16 */ [&] { op_rl(static_cast<Address>(this->hl->get())); },
-          /* 0x17 */ [&] { op_rl(this->a.get()); },
-          /* 0x18 */ [&] { op_rr(this->b.get()); },
-          /* 0x19 */ [&] { op_rr(this->c.get()); },
-          /* 0x1a */ [&] { op_rr(this->d.get()); },
-          /* 0x1b */ [&] { op_rr(this->e.get()); },
-          /* 0x1c */ [&] { op_rr(this->h.get()); },
-          /* 0x1d */ [&] { op_rr(this->l.get()); },
-          /* 0x1e */ [&] { op_rr(static_cast<Address>(this->hl->get())); },
-          /* 0x1f */ [&] { op_rr(this->a.get()); },
-          /* 0x20 */ [&] { op_sla(this->b.get()); },
-          /* 0x21 */ [&] { op_sla(this->c.get()); },
-          /* 0x22 */ [&] { op_sla(this->d.get()); },
-          /* 0x23 */ [&] { op_sla(this->e.get()); },
-          /* 0x24 */ [&] { op_sla(this->h.get()); },
-          /* 0x25 */ [&] { op_sla(this->l.get()); },
-          /* 0x26 */ [&] { op_sla(static_cast<Address>(this->hl->get())); },
-          /* 0x27 */ [&] { op_sla(this->a.get()); },
-          /* 0x28 */ [&] { op_sra(this->b.get()); },
-          /* 0x29 */ [&] { op_sra(this->c.get()); },
-          /* 0x2a */ [&] { op_sra(this->d.get()); },
-          /* 0x2b */ [&] { op_sra(this->e.get()); },
-          /* 0x2c */ [&] { op_sra(this->h.get()); },
-          /* 0x2d */ [&] { op_sra(this->l.get()); },
-          /* 0x2e */ [&] { op_sra(static_cast<Address>(this->hl->get())); },
-          /* 0x2f */ [&] { op_sra(this->a.get()); },
-          /* 0x30 */ [&] { op_swap(this->b.get()); },
-          /* 0x31 */ [&] { op_swap(this->c.get()); },
-          /* 0x32 */ [&] { op_swap(this->d.get()); },
-          /* 0x33 */ [&] { op_swap(this->e.get()); },
-          /* 0x34 */ [&] { op_swap(this->h.get()); },
-          /* 0x35 */ [&] { op_swap(this->l.get()); },
-          /* 0x36 */ [&] { op_swap(static_cast<Address>(this->hl->get())); },
-          /* 0x37 */ [&] { op_swap(this->a.get()); },
-          /* 0x38 */ [&] { op_srl(this->b.get()); },
-          /* 0x39 */ [&] { op_srl(this->c.get()); },
-          /* 0x3a */ [&] { op_srl(this->d.get()); },
-          /* 0x3b */ [&] { op_srl(this->e.get()); },
-          /* 0x3c */ [&] { op_srl(this->h.get()); },
-          /* 0x3d */ [&] { op_srl(this->l.get()); },
-          /* 0x3e */ [&] { op_srl(static_cast<Address>(this->hl->get())); },
-          /* 0x3f */ [&] { op_srl(this->a.get()); },
-          /* 0x40 */ [&] { op_bit(this->b.get(), 0); },
-          /* 0x41 */ [&] { op_bit(this->c.get(), 0); },
-          /* 0x42 */ [&] { op_bit(this->d.get(), 0); },
-          /* 0x43 */ [&] { op_bit(this->e.get(), 0); },
-          /* 0x44 */ [&] { op_bit(this->h.get(), 0); },
-          /* 0x45 */ [&] { op_bit(this->l.get(), 0); },
-          /* 0x46 */ [&] { op_bit(this->memory->read(this->hl->get()), 0); },
-          /* 0x47 */ [&] { op_bit(this->a.get(), 0); },
-          /* 0x48 */ [&] { op_bit(this->b.get(), 1); },
-          /* 0x49 */ [&] { op_bit(this->c.get(), 1); },
-          /* 0x4a */ [&] { op_bit(this->d.get(), 1); },
-          /* 0x4b */ [&] { op_bit(this->e.get(), 1); },
-          /* 0x4c */ [&] { op_bit(this->h.get(), 1); },
-          /* 0x4d */ [&] { op_bit(this->l.get(), 1); },
-          /* 0x4e */ [&] { op_bit(this->memory->read(this->hl->get()), 1); },
-          /* 0x4f */ [&] { op_bit(this->a.get(), 1); },
-          /* 0x50 */ [&] { op_bit(this->b.get(), 2); },
-          /* 0x51 */ [&] { op_bit(this->c.get(), 2); },
-          /* 0x52 */ [&] { op_bit(this->d.get(), 2); },
-          /* 0x53 */ [&] { op_bit(this->e.get(), 2); },
-          /* 0x54 */ [&] { op_bit(this->h.get(), 2); },
-          /* 0x55 */ [&] { op_bit(this->l.get(), 2); },
-          /* 0x56 */ [&] { op_bit(this->memory->read(this->hl->get()), 2); },
-          /* 0x57 */ [&] { op_bit(this->a.get(), 2); },
-          /* 0x58 */ [&] { op_bit(this->b.get(), 3); },
-          /* 0x59 */ [&] { op_bit(this->c.get(), 3); },
-          /* 0x5a */ [&] { op_bit(this->d.get(), 3); },
-          /* 0x5b */ [&] { op_bit(this->e.get(), 3); },
-          /* 0x5c */ [&] { op_bit(this->h.get(), 3); },
-          /* 0x5d */ [&] { op_bit(this->l.get(), 3); },
-          /* 0x5e */ [&] { op_bit(this->memory->read(this->hl->get()), 3); },
-          /* 0x5f */ [&] { op_bit(this->a.get(), 3); },
-          /* 0x60 */ [&] { op_bit(this->b.get(), 4); },
-          /* 0x61 */ [&] { op_bit(this->c.get(), 4); },
-          /* 0x62 */ [&] { op_bit(this->d.get(), 4); },
-          /* 0x63 */ [&] { op_bit(this->e.get(), 4); },
-          /* 0x64 */ [&] { op_bit(this->h.get(), 4); },
-          /* 0x65 */ [&] { op_bit(this->l.get(), 4); },
-          /* 0x66 */ [&] { op_bit(this->memory->read(this->hl->get()), 4); },
-          /* 0x67 */ [&] { op_bit(this->a.get(), 4); },
-          /* 0x68 */ [&] { op_bit(this->b.get(), 5); },
-          /* 0x69 */ [&] { op_bit(this->c.get(), 5); },
-          /* 0x6a */ [&] { op_bit(this->d.get(), 5); },
-          /* 0x6b */ [&] { op_bit(this->e.get(), 5); },
-          /* 0x6c */ [&] { op_bit(this->h.get(), 5); },
-          /* 0x6d */ [&] { op_bit(this->l.get(), 5); },
-          /* 0x6e */ [&] { op_bit(this->memory->read(this->hl->get()), 5); },
-          /* 0x6f */ [&] { op_bit(this->a.get(), 5); },
-          /* 0x70 */ [&] { op_bit(this->b.get(), 6); },
-          /* 0x71 */ [&] { op_bit(this->c.get(), 6); },
-          /* 0x72 */ [&] { op_bit(this->d.get(), 6); },
-          /* 0x73 */ [&] { op_bit(this->e.get(), 6); },
-          /* 0x74 */ [&] { op_bit(this->h.get(), 6); },
-          /* 0x75 */ [&] { op_bit(this->l.get(), 6); },
-          /* 0x76 */ [&] { op_bit(this->memory->read(this->hl->get()), 6); },
-          /* 0x77 */ [&] { op_bit(this->a.get(), 6); },
-          /* 0x78 */ [&] { op_bit(this->b.get(), 7); },
-          /* 0x79 */ [&] { op_bit(this->c.get(), 7); },
-          /* 0x7a */ [&] { op_bit(this->d.get(), 7); },
-          /* 0x7b */ [&] { op_bit(this->e.get(), 7); },
-          /* 0x7c */ [&] { op_bit(this->h.get(), 7); },
-          /* 0x7d */ [&] { op_bit(this->l.get(), 7); },
-          /* 0x7e */ [&] { op_bit(this->memory->read(this->hl->get()), 7); },
-          /* 0x7f */ [&] { op_bit(this->a.get(), 7); },
-          /* 0x80 */ [&] { op_res(this->b.get(), 0); },
-          /* 0x81 */ [&] { op_res(this->c.get(), 0); },
-          /* 0x82 */ [&] { op_res(this->d.get(), 0); },
-          /* 0x83 */ [&] { op_res(this->e.get(), 0); },
-          /* 0x84 */ [&] { op_res(this->h.get(), 0); },
-          /* 0x85 */ [&] { op_res(this->l.get(), 0); },
-          /* 0x86 */ [&] { op_res(this->hl->get(), 0); },
-          /* 0x87 */ [&] { op_res(this->a.get(), 0); },
-          /* 0x88 */ [&] { op_res(this->b.get(), 1); },
-          /* 0x89 */ [&] { op_res(this->c.get(), 1); },
-          /* 0x8a */ [&] { op_res(this->d.get(), 1); },
-          /* 0x8b */ [&] { op_res(this->e.get(), 1); },
-          /* 0x8c */ [&] { op_res(this->h.get(), 1); },
-          /* 0x8d */ [&] { op_res(this->l.get(), 1); },
-          /* 0x8e */ [&] { op_res(this->hl->get(), 1); },
-          /* 0x8f */ [&] { op_res(this->a.get(), 1); },
-          /* 0x90 */ [&] { op_res(this->b.get(), 2); },
-          /* 0x91 */ [&] { op_res(this->c.get(), 2); },
-          /* 0x92 */ [&] { op_res(this->d.get(), 2); },
-          /* 0x93 */ [&] { op_res(this->e.get(), 2); },
-          /* 0x94 */ [&] { op_res(this->h.get(), 2); },
-          /* 0x95 */ [&] { op_res(this->l.get(), 2); },
-          /* 0x96 */ [&] { op_res(this->hl->get(), 2); },
-          /* 0x97 */ [&] { op_res(this->a.get(), 2); },
-          /* 0x98 */ [&] { op_res(this->b.get(), 3); },
-          /* 0x99 */ [&] { op_res(this->c.get(), 3); },
-          /* 0x9a */ [&] { op_res(this->d.get(), 3); },
-          /* 0x9b */ [&] { op_res(this->e.get(), 3); },
-          /* 0x9c */ [&] { op_res(this->h.get(), 3); },
-          /* 0x9d */ [&] { op_res(this->l.get(), 3); },
-          /* 0x9e */ [&] { op_res(this->hl->get(), 3); },
-          /* 0x9f */ [&] { op_res(this->a.get(), 3); },
-          /* 0xa0 */ [&] { op_res(this->b.get(), 4); },
-          /* 0xa1 */ [&] { op_res(this->c.get(), 4); },
-          /* 0xa2 */ [&] { op_res(this->d.get(), 4); },
-          /* 0xa3 */ [&] { op_res(this->e.get(), 4); },
-          /* 0xa4 */ [&] { op_res(this->h.get(), 4); },
-          /* 0xa5 */ [&] { op_res(this->l.get(), 4); },
-          /* 0xa6 */ [&] { op_res(this->hl->get(), 4); },
-          /* 0xa7 */ [&] { op_res(this->a.get(), 4); },
-          /* 0xa8 */ [&] { op_res(this->b.get(), 5); },
-          /* 0xa9 */ [&] { op_res(this->c.get(), 5); },
-          /* 0xaa */ [&] { op_res(this->d.get(), 5); },
-          /* 0xab */ [&] { op_res(this->e.get(), 5); },
-          /* 0xac */ [&] { op_res(this->h.get(), 5); },
-          /* 0xad */ [&] { op_res(this->l.get(), 5); },
-          /* 0xae */ [&] { op_res(this->hl->get(), 5); },
-          /* 0xaf */ [&] { op_res(this->a.get(), 5); },
-          /* 0xb0 */ [&] { op_res(this->b.get(), 6); },
-          /* 0xb1 */ [&] { op_res(this->c.get(), 6); },
-          /* 0xb2 */ [&] { op_res(this->d.get(), 6); },
-          /* 0xb3 */ [&] { op_res(this->e.get(), 6); },
-          /* 0xb4 */ [&] { op_res(this->h.get(), 6); },
-          /* 0xb5 */ [&] { op_res(this->l.get(), 6); },
-          /* 0xb6 */ [&] { op_res(this->hl->get(), 6); },
-          /* 0xb7 */ [&] { op_res(this->a.get(), 6); },
-          /* 0xb8 */ [&] { op_res(this->b.get(), 7); },
-          /* 0xb9 */ [&] { op_res(this->c.get(), 7); },
-          /* 0xba */ [&] { op_res(this->d.get(), 7); },
-          /* 0xbb */ [&] { op_res(this->e.get(), 7); },
-          /* 0xbc */ [&] { op_res(this->h.get(), 7); },
-          /* 0xbd */ [&] { op_res(this->l.get(), 7); },
-          /* 0xbe */ [&] { op_res(this->hl->get(), 7); },
-          /* 0xbf */ [&] { op_res(this->a.get(), 7); },
-          /* 0xc0 */ [&] { op_set(this->b.get(), 0); },
-          /* 0xc1 */ [&] { op_set(this->c.get(), 0); },
-          /* 0xc2 */ [&] { op_set(this->d.get(), 0); },
-          /* 0xc3 */ [&] { op_set(this->e.get(), 0); },
-          /* 0xc4 */ [&] { op_set(this->h.get(), 0); },
-          /* 0xc5 */ [&] { op_set(this->l.get(), 0); },
-          /* 0xc6 */ [&] { op_set(this->hl->get(), 0); },
-          /* 0xc7 */ [&] { op_set(this->a.get(), 0); },
-          /* 0xc8 */ [&] { op_set(this->b.get(), 1); },
-          /* 0xc9 */ [&] { op_set(this->c.get(), 1); },
-          /* 0xca */ [&] { op_set(this->d.get(), 1); },
-          /* 0xcb */ [&] { op_set(this->e.get(), 1); },
-          /* 0xcc */ [&] { op_set(this->h.get(), 1); },
-          /* 0xcd */ [&] { op_set(this->l.get(), 1); },
-          /* 0xce */ [&] { op_set(this->hl->get(), 1); },
-          /* 0xcf */ [&] { op_set(this->a.get(), 1); },
-          /* 0xd0 */ [&] { op_set(this->b.get(), 2); },
-          /* 0xd1 */ [&] { op_set(this->c.get(), 2); },
-          /* 0xd2 */ [&] { op_set(this->d.get(), 2); },
-          /* 0xd3 */ [&] { op_set(this->e.get(), 2); },
-          /* 0xd4 */ [&] { op_set(this->h.get(), 2); },
-          /* 0xd5 */ [&] { op_set(this->l.get(), 2); },
-          /* 0xd6 */ [&] { op_set(this->hl->get(), 2); },
-          /* 0xd7 */ [&] { op_set(this->a.get(), 2); },
-          /* 0xd8 */ [&] { op_set(this->b.get(), 3); },
-          /* 0xd9 */ [&] { op_set(this->c.get(), 3); },
-          /* 0xda */ [&] { op_set(this->d.get(), 3); },
-          /* 0xdb */ [&] { op_set(this->e.get(), 3); },
-          /* 0xdc */ [&] { op_set(this->h.get(), 3); },
-          /* 0xdd */ [&] { op_set(this->l.get(), 3); },
-          /* 0xde */ [&] { op_set(this->hl->get(), 3); },
-          /* 0xdf */ [&] { op_set(this->a.get(), 3); },
-          /* 0xe0 */ [&] { op_set(this->b.get(), 4); },
-          /* 0xe1 */ [&] { op_set(this->c.get(), 4); },
-          /* 0xe2 */ [&] { op_set(this->d.get(), 4); },
-          /* 0xe3 */ [&] { op_set(this->e.get(), 4); },
-          /* 0xe4 */ [&] { op_set(this->h.get(), 4); },
-          /* 0xe5 */ [&] { op_set(this->l.get(), 4); },
-          /* 0xe6 */ [&] { op_set(this->hl->get(), 4); },
-          /* 0xe7 */ [&] { op_set(this->a.get(), 4); },
-          /* 0xe8 */ [&] { op_set(this->b.get(), 5); },
-          /* 0xe9 */ [&] { op_set(this->c.get(), 5); },
-          /* 0xea */ [&] { op_set(this->d.get(), 5); },
-          /* 0xeb */ [&] { op_set(this->e.get(), 5); },
-          /* 0xec */ [&] { op_set(this->h.get(), 5); },
-          /* 0xed */ [&] { op_set(this->l.get(), 5); },
-          /* 0xee */ [&] { op_set(this->hl->get(), 5); },
-          /* 0xef */ [&] { op_set(this->a.get(), 5); },
-          /* 0xf0 */ [&] { op_set(this->b.get(), 6); },
-          /* 0xf1 */ [&] { op_set(this->c.get(), 6); },
-          /* 0xf2 */ [&] { op_set(this->d.get(), 6); },
-          /* 0xf3 */ [&] { op_set(this->e.get(), 6); },
-          /* 0xf4 */ [&] { op_set(this->h.get(), 6); },
-          /* 0xf5 */ [&] { op_set(this->l.get(), 6); },
-          /* 0xf6 */ [&] { op_set(this->hl->get(), 6); },
-          /* 0xf7 */ [&] { op_set(this->a.get(), 6); },
-          /* 0xf8 */ [&] { op_set(this->b.get(), 7); },
-          /* 0xf9 */ [&] { op_set(this->c.get(), 7); },
-          /* 0xfa */ [&] { op_set(this->d.get(), 7); },
-          /* 0xfb */ [&] { op_set(this->e.get(), 7); },
-          /* 0xfc */ [&] { op_set(this->h.get(), 7); },
-          /* 0xfd */ [&] { op_set(this->l.get(), 7); },
-          /* 0xfe */ [&] { op_set(this->hl->get(), 7); },
-          /* 0xff */ [&] { op_set(this->a.get(), 7); },
-          // clang-format on
-      }),
-
-      // Cycles per instruction
-      // clang-format off
-      cycles({
-            1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,
-            1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
-            2, 3, 2, 2, 1, 1, 2, 1, 2, 2, 2, 2, 1, 1, 2, 1,
-            2, 3, 2, 2, 3, 3, 3, 1, 2, 2, 2, 2, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            2, 3, 3, 4, 3, 4, 2, 4, 2, 4, 3, 0, 3, 6, 2, 4,
-            2, 3, 3, 0, 3, 4, 2, 4, 2, 4, 3, 0, 3, 0, 2, 4,
-            3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,
-            3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4
-      }),
-      cycles_branched({
-            1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,
-            1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
-            3, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
-            3, 3, 2, 2, 3, 3, 3, 1, 3, 2, 2, 2, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
-            5, 3, 4, 4, 6, 4, 2, 4, 5, 4, 4, 0, 6, 6, 2, 4,
-            5, 3, 4, 0, 6, 4, 2, 4, 5, 4, 4, 0, 6, 0, 2, 4,
-            3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,
-            3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4
-      }),
-      cycles_cb({
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
-            2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
-            2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
-            2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
-            2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2
-        })
+      halted(false), interrupt_enabled(true), branch_taken(false) {}
+
+// clang-format off
+const std::array<CPU::OpcodeHandler, 256> CPU::opcode_map = {
+    /* 0x00 */ [](CPU &cpu) { cpu.op_nop(); },
+    /* 0x01 */ [](CPU &cpu) { cpu.op_ld_dbl(cpu.bc.get(), cpu.get_inst_dbl()); },
+    /* 0x02 */ [](CPU &cpu) { cpu.op_ld(cpu.bc->get(), cpu.a->get()); },
+    /* 0x03 */ [](CPU &cpu) { cpu.op_inc_dbl(cpu.bc.get()); },
+    /* 0x04 */ [](CPU &cpu) { cpu.op_inc(cpu.b.get()); },
+    /* 0x05 */ [](CPU &cpu) { cpu.op_dec(cpu.b.get()); },
+    /* 0x06 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.get_inst_byte()); },
+    /* 0x07 */ [](CPU &cpu) { cpu.op_rlc_a(); },
+    /* 0x08 */ [](CPU &cpu) { cpu.op_ld_dbl(static_cast<Address>(cpu.get_inst_dbl()), cpu.sp->get()); },
+    /* 0x09 */ [](CPU &cpu) { cpu.op_add_hl(cpu.bc->get()); },
+    /* 0x0a */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.memory->read(cpu.bc->get())); },
+    /* 0x0b */ [](CPU &cpu) { cpu.op_dec_dbl(cpu.bc.get()); },
+    /* 0x0c */ [](CPU &cpu) { cpu.op_inc(cpu.c.get()); },
+    /* 0x0d */ [](CPU &cpu) { cpu.op_dec(cpu.c.get()); },
+    /* 0x0e */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.get_inst_byte()); },
+    /* 0x0f */ [](CPU &cpu) { cpu.op_rrc_a(); },
+    /* 0x10 */ [](CPU &cpu) { cpu.op_stop(); },
+    /* 0x11 */ [](CPU &cpu) { cpu.op_ld_dbl(cpu.de.get(), cpu.get_inst_dbl()); },
+    /* 0x12 */ [](CPU &cpu) { cpu.op_ld(cpu.de->get(), cpu.a->get()); },
+    /* 0x13 */ [](CPU &cpu) { cpu.op_inc_dbl(cpu.de.get()); },
+    /* 0x14 */ [](CPU &cpu) { cpu.op_inc(cpu.d.get()); },
+    /* 0x15 */ [](CPU &cpu) { cpu.op_dec(cpu.d.get()); },
+    /* 0x16 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.get_inst_byte()); },
+    /* 0x17 */ [](CPU &cpu) { cpu.op_rl_a(); },
+    /* 0x18 */ [](CPU &cpu) { cpu.op_jr(cpu.get_inst_byte()); },
+    /* 0x19 */ [](CPU &cpu) { cpu.op_add_hl(cpu.de->get()); },
+    /* 0x1a */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.memory->read(cpu.de->get())); },
+    /* 0x1b */ [](CPU &cpu) { cpu.op_dec_dbl(cpu.de.get()); },
+    /* 0x1c */ [](CPU &cpu) { cpu.op_inc(cpu.e.get()); },
+    /* 0x1d */ [](CPU &cpu) { cpu.op_dec(cpu.e.get()); },
+    /* 0x1e */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.get_inst_byte()); },
+    /* 0x1f */ [](CPU &cpu) { cpu.op_rr_a(); },
+    /* 0x20 */ [](CPU &cpu) { cpu.op_jr(!cpu.f->get_bit(flag::ZERO), cpu.get_inst_byte()); },
+    /* 0x21 */ [](CPU &cpu) { cpu.op_ld_dbl(cpu.hl.get(), cpu.get_inst_dbl()); },
+    /* 0x22 */ [](CPU &cpu) { cpu.op_ldi_addr(cpu.hl->get(), cpu.a->get()); },
+    /* 0x23 */ [](CPU &cpu) { cpu.op_inc_dbl(cpu.hl.get()); },
+    /* 0x24 */ [](CPU &cpu) { cpu.op_inc(cpu.h.get()); },
+    /* 0x25 */ [](CPU &cpu) { cpu.op_dec(cpu.h.get()); },
+    /* 0x26 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.get_inst_byte()); },
+    /* 0x27 */ [](CPU &cpu) { cpu.op_daa(); },
+    /* 0x28 */ [](CPU &cpu) { cpu.op_jr(cpu.f->get_bit(flag::ZERO), cpu.get_inst_byte()); },
+    /* 0x29 */ [](CPU &cpu) { cpu.op_add_hl(cpu.hl->get()); },
+    /* 0x2a */ [](CPU &cpu) { cpu.op_ldi_a(cpu.memory->read(cpu.hl->get())); },
+    /* 0x2b */ [](CPU &cpu) { cpu.op_dec_dbl(cpu.hl.get()); },
+    /* 0x2c */ [](CPU &cpu) { cpu.op_inc(cpu.l.get()); },
+    /* 0x2d */ [](CPU &cpu) { cpu.op_dec(cpu.l.get()); },
+    /* 0x2e */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.get_inst_byte()); },
+    /* 0x2f */ [](CPU &cpu) { cpu.op_cpl(); },
+    /* 0x30 */ [](CPU &cpu) { cpu.op_jr(!cpu.f->get_bit(flag::CARRY), cpu.get_inst_byte()); },
+    /* 0x31 */ [](CPU &cpu) { cpu.op_ld_dbl(cpu.sp.get(), cpu.get_inst_dbl()); },
+    /* 0x32 */ [](CPU &cpu) { cpu.op_ldd_addr(static_cast<Address>(cpu.hl->get()), cpu.a->get()); },
+    /* 0x33 */ [](CPU &cpu) { cpu.op_inc_dbl(cpu.sp.get()); },
+    /* 0x34 */ [](CPU &cpu) { cpu.op_inc(static_cast<Address>(cpu.hl->get())); },
+    /* 0x35 */ [](CPU &cpu) { cpu.op_dec(static_cast<Address>(cpu.hl->get())); },
+    /* 0x36 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.get_inst_byte()); },
+    /* 0x37 */ [](CPU &cpu) { cpu.op_scf(); },
+    /* 0x38 */ [](CPU &cpu) { cpu.op_jr(cpu.f->get_bit(flag::CARRY), cpu.get_inst_byte()); },
+    /* 0x39 */ [](CPU &cpu) { cpu.op_add_hl(cpu.sp->get()); },
+    /* 0x3a */ [](CPU &cpu) { cpu.op_ldd_a(cpu.memory->read(cpu.hl->get())); },
+    /* 0x3b */ [](CPU &cpu) { cpu.op_dec_dbl(cpu.sp.get()); },
+    /* 0x3c */ [](CPU &cpu) { cpu.op_inc(cpu.a.get()); },
+    /* 0x3d */ [](CPU &cpu) { cpu.op_dec(cpu.a.get()); },
+    /* 0x3e */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.get_inst_byte()); },
+    /* 0x3f */ [](CPU &cpu) { cpu.op_ccf(); },
+    /* 0x40 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.b->get()); },
+    /* 0x41 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.c->get()); },
+    /* 0x42 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.d->get()); },
+    /* 0x43 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.e->get()); },
+    /* 0x44 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.h->get()); },
+    /* 0x45 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.l->get()); },
+    /* 0x46 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.memory->read(cpu.hl->get())); },
+    /* 0x47 */ [](CPU &cpu) { cpu.op_ld(cpu.b.get(), cpu.a->get()); },
+    /* 0x48 */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.b->get()); },
+    /* 0x49 */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.c->get()); },
+    /* 0x4a */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.d->get()); },
+    /* 0x4b */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.e->get()); },
+    /* 0x4c */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.h->get()); },
+    /* 0x4d */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.l->get()); },
+    /* 0x4e */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.memory->read(cpu.hl->get())); },
+    /* 0x4f */ [](CPU &cpu) { cpu.op_ld(cpu.c.get(), cpu.a->get()); },
+    /* 0x50 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.b->get()); },
+    /* 0x51 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.c->get()); },
+    /* 0x52 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.d->get()); },
+    /* 0x53 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.e->get()); },
+    /* 0x54 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.h->get()); },
+    /* 0x55 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.l->get()); },
+    /* 0x56 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.memory->read(cpu.hl->get())); },
+    /* 0x57 */ [](CPU &cpu) { cpu.op_ld(cpu.d.get(), cpu.a->get()); },
+    /* 0x58 */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.b->get()); },
+    /* 0x59 */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.c->get()); },
+    /* 0x5a */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.d->get()); },
+    /* 0x5b */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.e->get()); },
+    /* 0x5c */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.h->get()); },
+    /* 0x5d */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.l->get()); },
+    /* 0x5e */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.memory->read(cpu.hl->get())); },
+    /* 0x5f */ [](CPU &cpu) { cpu.op_ld(cpu.e.get(), cpu.a->get()); },
+    /* 0x60 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.b->get()); },
+    /* 0x61 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.c->get()); },
+    /* 0x62 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.d->get()); },
+    /* 0x63 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.e->get()); },
+    /* 0x64 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.h->get()); },
+    /* 0x65 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.l->get()); },
+    /* 0x66 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.memory->read(cpu.hl->get())); },
+    /* 0x67 */ [](CPU &cpu) { cpu.op_ld(cpu.h.get(), cpu.a->get()); },
+    /* 0x68 */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.b->get()); },
+    /* 0x69 */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.c->get()); },
+    /* 0x6a */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.d->get()); },
+    /* 0x6b */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.e->get()); },
+    /* 0x6c */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.h->get()); },
+    /* 0x6d */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.l->get()); },
+    /* 0x6e */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.memory->read(cpu.hl->get())); },
+    /* 0x6f */ [](CPU &cpu) { cpu.op_ld(cpu.l.get(), cpu.a->get()); },
+    /* 0x70 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.b->get()); },
+    /* 0x71 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.c->get()); },
+    /* 0x72 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.d->get()); },
+    /* 0x73 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.e->get()); },
+    /* 0x74 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.h->get()); },
+    /* 0x75 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.l->get()); },
+    /* 0x76 */ [](CPU &cpu) { cpu.op_halt(); },
+    /* 0x77 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.hl->get()), cpu.a->get()); },
+    /* 0x78 */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.b->get()); },
+    /* 0x79 */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.c->get()); },
+    /* 0x7a */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.d->get()); },
+    /* 0x7b */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.e->get()); },
+    /* 0x7c */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.h->get()); },
+    /* 0x7d */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.l->get()); },
+    /* 0x7e */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.memory->read(cpu.hl->get())); },
+    /* 0x7f */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.a->get()); },
+    /* 0x80 */ [](CPU &cpu) { cpu.op_add(cpu.b->get()); },
+    /* 0x81 */ [](CPU &cpu) { cpu.op_add(cpu.c->get()); },
+    /* 0x82 */ [](CPU &cpu) { cpu.op_add(cpu.d->get()); },
+    /* 0x83 */ [](CPU &cpu) { cpu.op_add(cpu.e->get()); },
+    /* 0x84 */ [](CPU &cpu) { cpu.op_add(cpu.h->get()); },
+    /* 0x85 */ [](CPU &cpu) { cpu.op_add(cpu.l->get()); },
+    /* 0x86 */ [](CPU &cpu) { cpu.op_add(cpu.memory->read(cpu.hl->get())); },
+    /* 0x87 */ [](CPU &cpu) { cpu.op_add(cpu.a->get()); },
+    /* 0x88 */ [](CPU &cpu) { cpu.op_adc(cpu.b->get()); },
+    /* 0x89 */ [](CPU &cpu) { cpu.op_adc(cpu.c->get()); },
+    /* 0x8a */ [](CPU &cpu) { cpu.op_adc(cpu.d->get()); },
+    /* 0x8b */ [](CPU &cpu) { cpu.op_adc(cpu.e->get()); },
+    /* 0x8c */ [](CPU &cpu) { cpu.op_adc(cpu.h->get()); },
+    /* 0x8d */ [](CPU &cpu) { cpu.op_adc(cpu.l->get()); },
+    /* 0x8e */ [](CPU &cpu) { cpu.op_adc(cpu.memory->read(cpu.hl->get())); },
+    /* 0x8f */ [](CPU &cpu) { cpu.op_adc(cpu.a->get()); },
+    /* 0x90 */ [](CPU &cpu) { cpu.op_sub(cpu.b->get()); },
+    /* 0x91 */ [](CPU &cpu) { cpu.op_sub(cpu.c->get()); },
+    /* 0x92 */ [](CPU &cpu) { cpu.op_sub(cpu.d->get()); },
+    /* 0x93 */ [](CPU &cpu) { cpu.op_sub(cpu.e->get()); },
+    /* 0x94 */ [](CPU &cpu) { cpu.op_sub(cpu.h->get()); },
+    /* 0x95 */ [](CPU &cpu) { cpu.op_sub(cpu.l->get()); },
+    /* 0x96 */ [](CPU &cpu) { cpu.op_sub(cpu.memory->read(cpu.hl->get())); },
+    /* 0x97 */ [](CPU &cpu) { cpu.op_sub(cpu.a->get()); },
+    /* 0x98 */ [](CPU &cpu) { cpu.op_sbc(cpu.b->get()); },
+    /* 0x99 */ [](CPU &cpu) { cpu.op_sbc(cpu.c->get()); },
+    /* 0x9a */ [](CPU &cpu) { cpu.op_sbc(cpu.d->get()); },
+    /* 0x9b */ [](CPU &cpu) { cpu.op_sbc(cpu.e->get()); },
+    /* 0x9c */ [](CPU &cpu) { cpu.op_sbc(cpu.h->get()); },
+    /* 0x9d */ [](CPU &cpu) { cpu.op_sbc(cpu.l->get()); },
+    /* 0x9e */ [](CPU &cpu) { cpu.op_sbc(cpu.memory->read(cpu.hl->get())); },
+    /* 0x9f */ [](CPU &cpu) { cpu.op_sbc(cpu.a->get()); },
+    /* 0xa0 */ [](CPU &cpu) { cpu.op_and(cpu.b->get()); },
+    /* 0xa1 */ [](CPU &cpu) { cpu.op_and(cpu.c->get()); },
+    /* 0xa2 */ [](CPU &cpu) { cpu.op_and(cpu.d->get()); },
+    /* 0xa3 */ [](CPU &cpu) { cpu.op_and(cpu.e->get()); },
+    /* 0xa4 */ [](CPU &cpu) { cpu.op_and(cpu.h->get()); },
+    /* 0xa5 */ [](CPU &cpu) { cpu.op_and(cpu.l->get()); },
+    /* 0xa6 */ [](CPU &cpu) { cpu.op_and(cpu.memory->read(cpu.hl->get())); },
+    /* 0xa7 */ [](CPU &cpu) { cpu.op_and(cpu.a->get()); },
+    /* 0xa8 */ [](CPU &cpu) { cpu.op_xor(cpu.b->get()); },
+    /* 0xa9 */ [](CPU &cpu) { cpu.op_xor(cpu.c->get()); },
+    /* 0xaa */ [](CPU &cpu) { cpu.op_xor(cpu.d->get()); },
+    /* 0xab */ [](CPU &cpu) { cpu.op_xor(cpu.e->get()); },
+    /* 0xac */ [](CPU &cpu) { cpu.op_xor(cpu.h->get()); },
+    /* 0xad */ [](CPU &cpu) { cpu.op_xor(cpu.l->get()); },
+    /* 0xae */ [](CPU &cpu) { cpu.op_xor(cpu.memory->read(cpu.hl->get())); },
+    /* 0xaf */ [](CPU &cpu) { cpu.op_xor(cpu.a->get()); },
+    /* 0xb0 */ [](CPU &cpu) { cpu.op_or(cpu.b->get()); },
+    /* 0xb1 */ [](CPU &cpu) { cpu.op_or(cpu.c->get()); },
+    /* 0xb2 */ [](CPU &cpu) { cpu.op_or(cpu.d->get()); },
+    /* 0xb3 */ [](CPU &cpu) { cpu.op_or(cpu.e->get()); },
+    /* 0xb4 */ [](CPU &cpu) { cpu.op_or(cpu.h->get()); },
+    /* 0xb5 */ [](CPU &cpu) { cpu.op_or(cpu.l->get()); },
+    /* 0xb6 */ [](CPU &cpu) { cpu.op_or(cpu.memory->read(cpu.hl->get())); },
+    /* 0xb7 */ [](CPU &cpu) { cpu.op_or(cpu.a->get()); },
+    /* 0xb8 */ [](CPU &cpu) { cpu.op_cp(cpu.b->get()); },
+    /* 0xb9 */ [](CPU &cpu) { cpu.op_cp(cpu.c->get()); },
+    /* 0xba */ [](CPU &cpu) { cpu.op_cp(cpu.d->get()); },
+    /* 0xbb */ [](CPU &cpu) { cpu.op_cp(cpu.e->get()); },
+    /* 0xbc */ [](CPU &cpu) { cpu.op_cp(cpu.h->get()); },
+    /* 0xbd */ [](CPU &cpu) { cpu.op_cp(cpu.l->get()); },
+    /* 0xbe */ [](CPU &cpu) { cpu.op_cp(cpu.memory->read(cpu.hl->get())); },
+    /* 0xbf */ [](CPU &cpu) { cpu.op_cp(cpu.a->get()); },
+    /* 0xc0 */ [](CPU &cpu) { cpu.op_ret(!cpu.f->get_bit(flag::ZERO)); },
+    /* 0xc1 */ [](CPU &cpu) { cpu.op_pop(cpu.bc.get()); },
+    /* 0xc2 */ [](CPU &cpu) { cpu.op_jp(!cpu.f->get_bit(flag::ZERO), cpu.get_inst_dbl()); },
+    /* 0xc3 */ [](CPU &cpu) { cpu.op_jp(cpu.get_inst_dbl()); },
+    /* 0xc4 */ [](CPU &cpu) { cpu.op_call(!cpu.f->get_bit(flag::ZERO), cpu.get_inst_dbl()); },
+    /* 0xc5 */ [](CPU &cpu) { cpu.op_push(cpu.bc.get()); },
+    /* 0xc6 */ [](CPU &cpu) { cpu.op_add(cpu.get_inst_byte()); },
+    /* 0xc7 */ [](CPU &cpu) { cpu.op_rst(0x00); },
+    /* 0xc8 */ [](CPU &cpu) { cpu.op_ret(cpu.f->get_bit(flag::ZERO)); },
+    /* 0xc9 */ [](CPU &cpu) { cpu.op_ret(); },
+    /* 0xca */ [](CPU &cpu) { cpu.op_jp(cpu.f->get_bit(flag::ZERO), cpu.get_inst_dbl()); },
+    /* 0xcb */ [](CPU &) { /* CB Opcodes handled separately */ },
+    /* 0xcc */ [](CPU &cpu) { cpu.op_call(cpu.f->get_bit(flag::ZERO), cpu.get_inst_dbl()); },
+    /* 0xcd */ [](CPU &cpu) { cpu.op_call(cpu.get_inst_dbl()); },
+    /* 0xce */ [](CPU &cpu) { cpu.op_adc(cpu.get_inst_byte()); },
+    /* 0xcf */ [](CPU &cpu) { cpu.op_rst(0x08); },
+    /* 0xd0 */ [](CPU &cpu) { cpu.op_ret(!cpu.f->get_bit(flag::CARRY)); },
+    /* 0xd1 */ [](CPU &cpu) { cpu.op_pop(cpu.de.get()); },
+    /* 0xd2 */ [](CPU &cpu) { cpu.op_jp(!cpu.f->get_bit(flag::CARRY), cpu.get_inst_dbl()); },
+    /* 0xd3 */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xd4 */ [](CPU &cpu) { cpu.op_call(!cpu.f->get_bit(flag::CARRY), cpu.get_inst_dbl()); },
+    /* 0xd5 */ [](CPU &cpu) { cpu.op_push(cpu.de.get()); },
+    /* 0xd6 */ [](CPU &cpu) { cpu.op_sub(cpu.get_inst_byte()); },
+    /* 0xd7 */ [](CPU &cpu) { cpu.op_rst(0x10); },
+    /* 0xd8 */ [](CPU &cpu) { cpu.op_ret(cpu.f->get_bit(flag::CARRY)); },
+    /* 0xd9 */ [](CPU &cpu) { cpu.op_reti(); },
+    /* 0xda */ [](CPU &cpu) { cpu.op_jp(cpu.f->get_bit(flag::CARRY), cpu.get_inst_dbl()); },
+    /* 0xdb */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xdc */ [](CPU &cpu) { cpu.op_call(cpu.f->get_bit(flag::CARRY), cpu.get_inst_dbl()); },
+    /* 0xdd */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xde */ [](CPU &cpu) { cpu.op_sbc(cpu.get_inst_byte()); },
+    /* 0xdf */ [](CPU &cpu) { cpu.op_rst(0x18); },
+    /* 0xe0 */ [](CPU &cpu) { cpu.op_ldh_addr(0xFF00 + cpu.get_inst_byte(), cpu.a->get()); },
+    /* 0xe1 */ [](CPU &cpu) { cpu.op_pop(cpu.hl.get()); },
+    /* 0xe2 */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(0xFF00 + cpu.c->get()), cpu.a->get()); },
+    /* 0xe3 */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xe4 */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xe5 */ [](CPU &cpu) { cpu.op_push(cpu.hl.get()); },
+    /* 0xe6 */ [](CPU &cpu) { cpu.op_and(cpu.get_inst_byte()); },
+    /* 0xe7 */ [](CPU &cpu) { cpu.op_rst(0x20); },
+    /* 0xe8 */ [](CPU &cpu) { cpu.op_add_sp(static_cast<int8_t>(cpu.get_inst_byte())); },
+    /* 0xe9 */ [](CPU &cpu) { cpu.op_jp(cpu.hl->get()); },
+    /* 0xea */ [](CPU &cpu) { cpu.op_ld(static_cast<Address>(cpu.get_inst_dbl()), cpu.a->get()); },
+    /* 0xeb */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xec */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xed */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xee */ [](CPU &cpu) { cpu.op_xor(cpu.get_inst_byte()); },
+    /* 0xef */ [](CPU &cpu) { cpu.op_rst(0x28); },
+    /* 0xf0 */ [](CPU &cpu) { cpu.op_ldh_a(cpu.memory->read(0xFF00 + cpu.get_inst_byte())); },
+    /* 0xf1 */ [](CPU &cpu) { cpu.op_pop(cpu.af.get(), true); },
+    /* 0xf2 */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.memory->read(0xFF00 + cpu.c->get())); },
+    /* 0xf3 */ [](CPU &cpu) { cpu.op_di(); },
+    /* 0xf4 */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xf5 */ [](CPU &cpu) { cpu.op_push(cpu.af.get()); },
+    /* 0xf6 */ [](CPU &cpu) { cpu.op_or(cpu.get_inst_byte()); },
+    /* 0xf7 */ [](CPU &cpu) { cpu.op_rst(0x30); },
+    /* 0xf8 */ [](CPU &cpu) { cpu.op_ld_hl_sp_offset(static_cast<int8_t>(cpu.get_inst_byte())); },
+    /* 0xf9 */ [](CPU &cpu) { cpu.op_ld_dbl(cpu.sp.get(), cpu.hl->get()); },
+    /* 0xfa */ [](CPU &cpu) { cpu.op_ld(cpu.a.get(), cpu.memory->read(cpu.get_inst_dbl())); },
+    /* 0xfb */ [](CPU &cpu) { cpu.op_ei(); },
+    /* 0xfc */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xfd */ [](CPU &) { /* UNDEFINED */ },
+    /* 0xfe */ [](CPU &cpu) { cpu.op_cp(cpu.get_inst_byte()); },
+    /* 0xff */ [](CPU &cpu) { cpu.op_rst(0x38); },
+};
+
+const std::array<CPU::OpcodeHandler, 256> CPU::cb_opcode_map = {
+    /* 0x00 */ [](CPU &cpu) { cpu.op_rlc(cpu.b.get()); },
+    /* 0x01 */ [](CPU &cpu) { cpu.op_rlc(cpu.c.get()); },
+    /* 0x02 */ [](CPU &cpu) { cpu.op_rlc(cpu.d.get()); },
+    /* 0x03 */ [](CPU &cpu) { cpu.op_rlc(cpu.e.get()); },
+    /* 0x04 */ [](CPU &cpu) { cpu.op_rlc(cpu.h.get()); },
+    /* 0x05 */ [](CPU &cpu) { cpu.op_rlc(cpu.l.get()); },
+    /* 0x06 */ [](CPU &cpu) { cpu.op_rlc(static_cast<Address>(cpu.hl->get())); },
+    /* 0x07 */ [](CPU &cpu) { cpu.op_rlc(cpu.a.get()); },
+    /* 0x08 */ [](CPU &cpu) { cpu.op_rrc(cpu.b.get()); },
+    /* 0x09 */ [](CPU &cpu) { cpu.op_rrc(cpu.c.get()); },
+    /* 0x0a */ [](CPU &cpu) { cpu.op_rrc(cpu.d.get()); },
+    /* 0x0b */ [](CPU &cpu) { cpu.op_rrc(cpu.e.get()); },
+    /* 0x0c */ [](CPU &cpu) { cpu.op_rrc(cpu.h.get()); },
+    /* 0x0d */ [](CPU &cpu) { cpu.op_rrc(cpu.l.get()); },
+    /* 0x0e */ [](CPU &cpu) { cpu.op_rrc(static_cast<Address>(cpu.hl->get())); },
+    /* 0x0f */ [](CPU &cpu) { cpu.op_rrc(cpu.a.get()); },
+    /* 0x10 */ [](CPU &cpu) { cpu.op_rl(cpu.b.get()); },
+    /* 0x11 */ [](CPU &cpu) { cpu.op_rl(cpu.c.get()); },
+    /* 0x12 */ [](CPU &cpu) { cpu.op_rl(cpu.d.get()); },
+    /* 0x13 */ [](CPU &cpu) { cpu.op_rl(cpu.e.get()); },
+    /* 0x14 */ [](CPU &cpu) { cpu.op_rl(cpu.h.get()); },
+    /* 0x15 */ [](CPU &cpu) { cpu.op_rl(cpu.l.get()); },
+    /* 0x16 */ [](CPU &cpu) { cpu.op_rl(static_cast<Address>(cpu.hl->get())); },
+    /* 0x17 */ [](CPU &cpu) { cpu.op_rl(cpu.a.get()); },
+    /* 0x18 */ [](CPU &cpu) { cpu.op_rr(cpu.b.get()); },
+    /* 0x19 */ [](CPU &cpu) { cpu.op_rr(cpu.c.get()); },
+    /* 0x1a */ [](CPU &cpu) { cpu.op_rr(cpu.d.get()); },
+    /* 0x1b */ [](CPU &cpu) { cpu.op_rr(cpu.e.get()); },
+    /* 0x1c */ [](CPU &cpu) { cpu.op_rr(cpu.h.get()); },
+    /* 0x1d */ [](CPU &cpu) { cpu.op_rr(cpu.l.get()); },
+    /* 0x1e */ [](CPU &cpu) { cpu.op_rr(static_cast<Address>(cpu.hl->get())); },
+    /* 0x1f */ [](CPU &cpu) { cpu.op_rr(cpu.a.get()); },
+    /* 0x20 */ [](CPU &cpu) { cpu.op_sla(cpu.b.get()); },
+    /* 0x21 */ [](CPU &cpu) { cpu.op_sla(cpu.c.get()); },
+    /* 0x22 */ [](CPU &cpu) { cpu.op_sla(cpu.d.get()); },
+    /* 0x23 */ [](CPU &cpu) { cpu.op_sla(cpu.e.get()); },
+    /* 0x24 */ [](CPU &cpu) { cpu.op_sla(cpu.h.get()); },
+    /* 0x25 */ [](CPU &cpu) { cpu.op_sla(cpu.l.get()); },
+    /* 0x26 */ [](CPU &cpu) { cpu.op_sla(static_cast<Address>(cpu.hl->get())); },
+    /* 0x27 */ [](CPU &cpu) { cpu.op_sla(cpu.a.get()); },
+    /* 0x28 */ [](CPU &cpu) { cpu.op_sra(cpu.b.get()); },
+    /* 0x29 */ [](CPU &cpu) { cpu.op_sra(cpu.c.get()); },
+    /* 0x2a */ [](CPU &cpu) { cpu.op_sra(cpu.d.get()); },
+    /* 0x2b */ [](CPU &cpu) { cpu.op_sra(cpu.e.get()); },
+    /* 0x2c */ [](CPU &cpu) { cpu.op_sra(cpu.h.get()); },
+    /* 0x2d */ [](CPU &cpu) { cpu.op_sra(cpu.l.get()); },
+    /* 0x2e */ [](CPU &cpu) { cpu.op_sra(static_cast<Address>(cpu.hl->get())); },
+    /* 0x2f */ [](CPU &cpu) { cpu.op_sra(cpu.a.get()); },
+    /* 0x30 */ [](CPU &cpu) { cpu.op_swap(cpu.b.get()); },
+    /* 0x31 */ [](CPU &cpu) { cpu.op_swap(cpu.c.get()); },
+    /* 0x32 */ [](CPU &cpu) { cpu.op_swap(cpu.d.get()); },
+    /* 0x33 */ [](CPU &cpu) { cpu.op_swap(cpu.e.get()); },
+    /* 0x34 */ [](CPU &cpu) { cpu.op_swap(cpu.h.get()); },
+    /* 0x35 */ [](CPU &cpu) { cpu.op_swap(cpu.l.get()); },
+    /* 0x36 */ [](CPU &cpu) { cpu.op_swap(static_cast<Address>(cpu.hl->get())); },
+    /* 0x37 */ [](CPU &cpu) { cpu.op_swap(cpu.a.get()); },
+    /* 0x38 */ [](CPU &cpu) { cpu.op_srl(cpu.b.get()); },
+    /* 0x39 */ [](CPU &cpu) { cpu.op_srl(cpu.c.get()); },
+    /* 0x3a */ [](CPU &cpu) { cpu.op_srl(cpu.d.get()); },
+    /* 0x3b */ [](CPU &cpu) { cpu.op_srl(cpu.e.get()); },
+    /* 0x3c */ [](CPU &cpu) { cpu.op_srl(cpu.h.get()); },
+    /* 0x3d */ [](CPU &cpu) { cpu.op_srl(cpu.l.get()); },
+    /* 0x3e */ [](CPU &cpu) { cpu.op_srl(static_cast<Address>(cpu.hl->get())); },
+    /* 0x3f */ [](CPU &cpu) { cpu.op_srl(cpu.a.get()); },
+    /* 0x40 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 0); },
+    /* 0x41 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 0); },
+    /* 0x42 */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 0); },
+    /* 0x43 */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 0); },
+    /* 0x44 */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 0); },
+    /* 0x45 */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 0); },
+    /* 0x46 */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 0); },
+    /* 0x47 */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 0); },
+    /* 0x48 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 1); },
+    /* 0x49 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 1); },
+    /* 0x4a */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 1); },
+    /* 0x4b */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 1); },
+    /* 0x4c */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 1); },
+    /* 0x4d */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 1); },
+    /* 0x4e */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 1); },
+    /* 0x4f */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 1); },
+    /* 0x50 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 2); },
+    /* 0x51 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 2); },
+    /* 0x52 */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 2); },
+    /* 0x53 */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 2); },
+    /* 0x54 */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 2); },
+    /* 0x55 */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 2); },
+    /* 0x56 */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 2); },
+    /* 0x57 */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 2); },
+    /* 0x58 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 3); },
+    /* 0x59 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 3); },
+    /* 0x5a */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 3); },
+    /* 0x5b */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 3); },
+    /* 0x5c */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 3); },
+    /* 0x5d */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 3); },
+    /* 0x5e */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 3); },
+    /* 0x5f */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 3); },
+    /* 0x60 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 4); },
+    /* 0x61 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 4); },
+    /* 0x62 */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 4); },
+    /* 0x63 */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 4); },
+    /* 0x64 */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 4); },
+    /* 0x65 */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 4); },
+    /* 0x66 */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 4); },
+    /* 0x67 */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 4); },
+    /* 0x68 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 5); },
+    /* 0x69 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 5); },
+    /* 0x6a */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 5); },
+    /* 0x6b */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 5); },
+    /* 0x6c */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 5); },
+    /* 0x6d */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 5); },
+    /* 0x6e */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 5); },
+    /* 0x6f */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 5); },
+    /* 0x70 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 6); },
+    /* 0x71 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 6); },
+    /* 0x72 */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 6); },
+    /* 0x73 */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 6); },
+    /* 0x74 */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 6); },
+    /* 0x75 */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 6); },
+    /* 0x76 */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 6); },
+    /* 0x77 */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 6); },
+    /* 0x78 */ [](CPU &cpu) { cpu.op_bit(cpu.b.get(), 7); },
+    /* 0x79 */ [](CPU &cpu) { cpu.op_bit(cpu.c.get(), 7); },
+    /* 0x7a */ [](CPU &cpu) { cpu.op_bit(cpu.d.get(), 7); },
+    /* 0x7b */ [](CPU &cpu) { cpu.op_bit(cpu.e.get(), 7); },
+    /* 0x7c */ [](CPU &cpu) { cpu.op_bit(cpu.h.get(), 7); },
+    /* 0x7d */ [](CPU &cpu) { cpu.op_bit(cpu.l.get(), 7); },
+    /* 0x7e */ [](CPU &cpu) { cpu.op_bit(cpu.memory->read(cpu.hl->get()), 7); },
+    /* 0x7f */ [](CPU &cpu) { cpu.op_bit(cpu.a.get(), 7); },
+    /* 0x80 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 0); },
+    /* 0x81 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 0); },
+    /* 0x82 */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 0); },
+    /* 0x83 */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 0); },
+    /* 0x84 */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 0); },
+    /* 0x85 */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 0); },
+    /* 0x86 */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 0); },
+    /* 0x87 */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 0); },
+    /* 0x88 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 1); },
+    /* 0x89 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 1); },
+    /* 0x8a */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 1); },
+    /* 0x8b */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 1); },
+    /* 0x8c */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 1); },
+    /* 0x8d */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 1); },
+    /* 0x8e */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 1); },
+    /* 0x8f */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 1); },
+    /* 0x90 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 2); },
+    /* 0x91 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 2); },
+    /* 0x92 */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 2); },
+    /* 0x93 */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 2); },
+    /* 0x94 */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 2); },
+    /* 0x95 */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 2); },
+    /* 0x96 */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 2); },
+    /* 0x97 */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 2); },
+    /* 0x98 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 3); },
+    /* 0x99 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 3); },
+    /* 0x9a */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 3); },
+    /* 0x9b */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 3); },
+    /* 0x9c */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 3); },
+    /* 0x9d */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 3); },
+    /* 0x9e */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 3); },
+    /* 0x9f */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 3); },
+    /* 0xa0 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 4); },
+    /* 0xa1 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 4); },
+    /* 0xa2 */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 4); },
+    /* 0xa3 */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 4); },
+    /* 0xa4 */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 4); },
+    /* 0xa5 */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 4); },
+    /* 0xa6 */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 4); },
+    /* 0xa7 */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 4); },
+    /* 0xa8 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 5); },
+    /* 0xa9 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 5); },
+    /* 0xaa */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 5); },
+    /* 0xab */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 5); },
+    /* 0xac */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 5); },
+    /* 0xad */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 5); },
+    /* 0xae */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 5); },
+    /* 0xaf */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 5); },
+    /* 0xb0 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 6); },
+    /* 0xb1 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 6); },
+    /* 0xb2 */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 6); },
+    /* 0xb3 */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 6); },
+    /* 0xb4 */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 6); },
+    /* 0xb5 */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 6); },
+    /* 0xb6 */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 6); },
+    /* 0xb7 */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 6); },
+    /* 0xb8 */ [](CPU &cpu) { cpu.op_res(cpu.b.get(), 7); },
+    /* 0xb9 */ [](CPU &cpu) { cpu.op_res(cpu.c.get(), 7); },
+    /* 0xba */ [](CPU &cpu) { cpu.op_res(cpu.d.get(), 7); },
+    /* 0xbb */ [](CPU &cpu) { cpu.op_res(cpu.e.get(), 7); },
+    /* 0xbc */ [](CPU &cpu) { cpu.op_res(cpu.h.get(), 7); },
+    /* 0xbd */ [](CPU &cpu) { cpu.op_res(cpu.l.get(), 7); },
+    /* 0xbe */ [](CPU &cpu) { cpu.op_res(cpu.hl->get(), 7); },
+    /* 0xbf */ [](CPU &cpu) { cpu.op_res(cpu.a.get(), 7); },
+    /* 0xc0 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 0); },
+    /* 0xc1 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 0); },
+    /* 0xc2 */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 0); },
+    /* 0xc3 */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 0); },
+    /* 0xc4 */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 0); },
+    /* 0xc5 */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 0); },
+    /* 0xc6 */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 0); },
+    /* 0xc7 */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 0); },
+    /* 0xc8 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 1); },
+    /* 0xc9 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 1); },
+    /* 0xca */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 1); },
+    /* 0xcb */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 1); },
+    /* 0xcc */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 1); },
+    /* 0xcd */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 1); },
+    /* 0xce */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 1); },
+    /* 0xcf */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 1); },
+    /* 0xd0 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 2); },
+    /* 0xd1 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 2); },
+    /* 0xd2 */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 2); },
+    /* 0xd3 */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 2); },
+    /* 0xd4 */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 2); },
+    /* 0xd5 */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 2); },
+    /* 0xd6 */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 2); },
+    /* 0xd7 */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 2); },
+    /* 0xd8 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 3); },
+    /* 0xd9 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 3); },
+    /* 0xda */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 3); },
+    /* 0xdb */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 3); },
+    /* 0xdc */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 3); },
+    /* 0xdd */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 3); },
+    /* 0xde */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 3); },
+    /* 0xdf */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 3); },
+    /* 0xe0 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 4); },
+    /* 0xe1 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 4); },
+    /* 0xe2 */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 4); },
+    /* 0xe3 */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 4); },
+    /* 0xe4 */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 4); },
+    /* 0xe5 */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 4); },
+    /* 0xe6 */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 4); },
+    /* 0xe7 */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 4); },
+    /* 0xe8 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 5); },
+    /* 0xe9 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 5); },
+    /* 0xea */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 5); },
+    /* 0xeb */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 5); },
+    /* 0xec */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 5); },
+    /* 0xed */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 5); },
+    /* 0xee */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 5); },
+    /* 0xef */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 5); },
+    /* 0xf0 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 6); },
+    /* 0xf1 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 6); },
+    /* 0xf2 */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 6); },
+    /* 0xf3 */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 6); },
+    /* 0xf4 */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 6); },
+    /* 0xf5 */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 6); },
+    /* 0xf6 */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 6); },
+    /* 0xf7 */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 6); },
+    /* 0xf8 */ [](CPU &cpu) { cpu.op_set(cpu.b.get(), 7); },
+    /* 0xf9 */ [](CPU &cpu) { cpu.op_set(cpu.c.get(), 7); },
+    /* 0xfa */ [](CPU &cpu) { cpu.op_set(cpu.d.get(), 7); },
+    /* 0xfb */ [](CPU &cpu) { cpu.op_set(cpu.e.get(), 7); },
+    /* 0xfc */ [](CPU &cpu) { cpu.op_set(cpu.h.get(), 7); },
+    /* 0xfd */ [](CPU &cpu) { cpu.op_set(cpu.l.get(), 7); },
+    /* 0xfe */ [](CPU &cpu) { cpu.op_set(cpu.hl->get(), 7); },
+    /* 0xff */ [](CPU &cpu) { cpu.op_set(cpu.a.get(), 7); },
+};
+
+const std::array<ClockCycles, 256> CPU::cycles = {
+    1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,
+    1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
+    2, 3, 2, 2, 1, 1, 2, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+    2, 3, 2, 2, 3, 3, 3, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    2, 3, 3, 4, 3, 4, 2, 4, 2, 4, 3, 0, 3, 6, 2, 4,
+    2, 3, 3, 0, 3, 4, 2, 4, 2, 4, 3, 0, 3, 0, 2, 4,
+    3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,
+    3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4
+};
+
+const std::array<ClockCycles, 256> CPU::cycles_branched = {
+    1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,
+    1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
+    3, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
+    3, 3, 2, 2, 3, 3, 3, 1, 3, 2, 2, 2, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    5, 3, 4, 4, 6, 4, 2, 4, 5, 4, 4, 0, 6, 6, 2, 4,
+    5, 3, 4, 0, 6, 4, 2, 4, 5, 4, 4, 0, 6, 0, 2, 4,
+    3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,
+    3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4
+};
+
+const std::array<ClockCycles, 256> CPU::cycles_cb = {
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
+    2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
+    2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
+    2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2,
+    2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2
+};
 // clang-format on
-{}
 
 ClockCycles CPU::tick() {
 	ticks++;
@@ -633,7 +626,7 @@ ClockCycles CPU::tick() {
 	if (opcode != 0xCB) {
 		// This is a standard instruction. Call handler and get the cycle
 		// count
-		opcode_map[opcode]();
+		opcode_map[opcode](*this);
 
 		// If the instruction branched, take the count from cycles_branched
 		current_cycles =
@@ -642,7 +635,7 @@ ClockCycles CPU::tick() {
 	} else {
 		// This is a 0xCB prefixed instruction. Call the CB handler
 		opcode = get_inst_byte();
-		cb_opcode_map[opcode]();
+		cb_opcode_map[opcode](*this);
 		current_cycles = cycles_cb[opcode];
 	}
 
@@ -691,6 +684,58 @@ IReg *CPU::get_interrupt_enable() { return interrupt_enable.get(); }
 
 IReg *CPU::get_interrupt_flag() { return interrupt_flag.get(); }
 
+uint16_t CPU::get_pc() const { return pc->get(); }
+
+bool CPU::will_fetch() const {
+	// Mirrors the checks at the start of tick
+	if (interrupt_enabled &&
+	    (interrupt_flag->get() & interrupt_enable->get()) != 0) {
+		return false;
+	}
+	return !halted;
+}
+
+void CPU::save_state(CPUState &state) const {
+	state.a = a->get();
+	state.b = b->get();
+	state.c = c->get();
+	state.d = d->get();
+	state.e = e->get();
+	state.f = f->get();
+	state.h = h->get();
+	state.l = l->get();
+	state.sp = sp->get();
+	state.pc = pc->get();
+	state.interrupt_enable = interrupt_enable->get();
+	state.interrupt_flag = interrupt_flag->get();
+	state.halted = halted;
+	state.interrupt_enabled = interrupt_enabled;
+	state.branch_taken = branch_taken;
+	state.ticks = ticks;
+	state.total_cpu_cycles = total_cpu_cycles;
+}
+
+void CPU::load_state(const CPUState &state) {
+	// The pair registers are views over these, so they follow along
+	a->set(state.a);
+	b->set(state.b);
+	c->set(state.c);
+	d->set(state.d);
+	e->set(state.e);
+	f->set(state.f);
+	h->set(state.h);
+	l->set(state.l);
+	sp->set(state.sp);
+	pc->set(state.pc);
+	interrupt_enable->set(state.interrupt_enable);
+	interrupt_flag->set(state.interrupt_flag);
+	halted = state.halted;
+	interrupt_enabled = state.interrupt_enabled;
+	branch_taken = state.branch_taken;
+	ticks = state.ticks;
+	total_cpu_cycles = state.total_cpu_cycles;
+}
+
 uint8_t CPU::get_inst_byte() const {
 	auto byte = memory->read(pc->get());
 	(*pc)++;
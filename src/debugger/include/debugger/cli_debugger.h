@@ -11,6 +11,7 @@
 
 #include <cxxopts.hpp>
 
+#include <chrono>
 #include <map>
 #include <unordered_set>
 
@@ -28,12 +29,35 @@ class CliDebugger : public IDebugger {
 	 */
 	cxxopts::Options command_parser;
 
+	/**
+	 * Whether the prompt for the next command has been printed
+	 */
+	bool prompted = false;
+
+	/**
+	 * Run a line typed by the user
+	 * @return Whether the command succeeded
+	 */
+	bool run_line(std::string line);
+
   public:
 	/**
 	 * @brief: Overrides tick() and we take user input in this function
 	 */
 	void tick() override;
 
+	/**
+	 * @brief Like tick(), but gives up if no command is typed within the
+	 * timeout, so that the caller can check whether to stop between commands
+	 * @return Whether a command was run
+	 */
+	bool poll(std::chrono::milliseconds timeout);
+
+	/**
+	 * @brief End a run that is waiting for a breakpoint, from another thread
+	 */
+	void stop();
+
 	/**
 	 * @brief Parses commands and passes control to the debugger_core
 	 * @return A status true or false, indicating whether the given operation
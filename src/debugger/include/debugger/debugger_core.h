@@ -13,6 +13,7 @@
 #include "memory/memory.h"
 #include "memory/utils.h"
 
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -64,6 +65,11 @@ class DebuggerCore {
 	 */
 	std::unordered_set<ClockCycles> tick_breakpoints;
 
+	/**
+	 * Set from another thread to end a run before it reaches a breakpoint
+	 */
+	std::atomic<bool> stopping = false;
+
   public:
 	/**
 	 * DebuggerCore constructor
@@ -109,6 +115,12 @@ class DebuggerCore {
 	 */
 	virtual void run();
 
+	/**
+	 * @brief End a run that is waiting for a breakpoint, from another thread
+	 * such as the one that owns the window
+	 */
+	void stop();
+
 	/**
 	 * @brief Execute 1 System tick
 	 */
@@ -1,6 +1,13 @@
 #include "debugger/cli_debugger.h"
 #include "util/argv_generator.h"
 #include <iostream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <unistd.h>
+#define TVP_HAS_POLL
+#endif
 
 using namespace debugger;
 using namespace std;
@@ -65,16 +72,46 @@ void CliDebugger::tick() {
 	do {
 		cout << "(tdb) ";
 		getline(std::cin, str);
+		status = run_line(str);
+	} while (!status);
+}
+
+bool CliDebugger::poll(std::chrono::milliseconds timeout) {
+	if (!prompted) {
+		cout << "(tdb) " << flush;
+		prompted = true;
+	}
+
+	// Without poll, this blocks until a line is typed, like tick()
+#ifdef TVP_HAS_POLL
+	auto input = pollfd{STDIN_FILENO, POLLIN, 0};
+	if (::poll(&input, 1, static_cast<int>(timeout.count())) <= 0) {
+		return false;
+	}
+#endif
+
+	// Once stdin is closed, it always polls as ready, so wait out the
+	// timeout instead
+	std::string str;
+	if (!getline(std::cin, str)) {
+		std::this_thread::sleep_for(timeout);
+		return false;
+	}
+	prompted = false;
+	run_line(str);
+	return true;
+}
 
-		// A hack to make CLI parsing compatible with cxxopts.
-		str = "./tdb --" + str;
+void CliDebugger::stop() { debugger_core->stop(); }
 
-		auto argv_generator = ArgvGenerator(str);
-		auto [argc, argv] = argv_generator.get();
+bool CliDebugger::run_line(std::string line) {
+	// A hack to make CLI parsing compatible with cxxopts.
+	line = "./tdb --" + line;
 
-		status = run_command(argc, argv);
+	auto argv_generator = ArgvGenerator(line);
+	auto [argc, argv] = argv_generator.get();
 
-	} while (!status);
+	return run_command(argc, argv);
 }
 
 bool CliDebugger::run_command(int argc, char **argv) {
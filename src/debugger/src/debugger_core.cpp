@@ -111,11 +111,13 @@ void DebuggerCore::run() {
 		    cycle_breakpoints.end();
 		tick();
 	} while (!is_breakpoint_hit && !is_ticks_breakpoint_hit &&
-	         !is_cycles_breakpoint_hit);
+	         !is_cycles_breakpoint_hit && !stopping);
 
 	is_breaking = true;
 }
 
+void DebuggerCore::stop() { stopping = true; }
+
 void DebuggerCore::step() { tick(); }
 
 std::map<Address, InstructionLine> DebuggerCore::peek(Address address,
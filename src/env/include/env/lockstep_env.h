@@ -0,0 +1,214 @@
+/**
+ * @file lockstep_env.h
+ * Declares the LockstepEnv class, an experimental engine that runs the lanes
+ * of a VecEnv in lockstep
+ */
+
+#pragma once
+
+#include "cartridge/cartridge.h"
+#include "env/vec_env.h"
+#include "gameboy/gameboy.h"
+#include "gameboy/save_state.h"
+#include "gpu/utils.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace env {
+
+/**
+ * Most lanes that a LockstepEnv can run. Registers are bytes, so this many
+ * lanes of one register fill a 128 bit vector.
+ */
+constexpr std::size_t MAX_LANES = 16;
+
+/**
+ * Counts of how instructions were run by a LockstepEnv
+ */
+struct LockstepStats {
+	/**
+	 * Instructions run over all lanes, counting one for each lane
+	 */
+	uint64_t instructions;
+
+	/**
+	 * Instructions that were run across all lanes at once, counting one for
+	 * each lane
+	 */
+	uint64_t lockstep_instructions;
+
+	/**
+	 * Number of times the registers were moved into the lanes to start
+	 * running in lockstep
+	 */
+	uint64_t gathers;
+};
+
+/**
+ * The registers of every lane, stored register by register so that one
+ * operation can be done across all lanes with vector instructions
+ */
+struct LaneRegisters {
+	/**
+	 * The 8 bit registers, in the order that opcodes number them: B, C, D,
+	 * E, H, L, and A at 7. Number 6 stands for (HL) in opcodes, and is used
+	 * to hold F here.
+	 */
+	std::array<std::array<uint8_t, MAX_LANES>, 8> r;
+
+	/**
+	 * Program counters
+	 */
+	std::array<uint16_t, MAX_LANES> pc;
+
+	/**
+	 * Instructions run in lockstep by each lane since the registers were
+	 * gathered, to add to the CPU's counts
+	 */
+	std::array<uint64_t, MAX_LANES> instructions;
+};
+
+/**
+ * An experimental take on VecEnv, with the same interface apart from
+ * observations, that runs all its lanes on one thread one instruction at a
+ * time.
+ *
+ * While every lane that is still running is about to run the same simple
+ * instruction, the lanes run it together. The registers are kept in a
+ * LaneRegisters, and the instruction is done with plain loops over the
+ * lanes, which the compiler turns into vector instructions. Only instructions
+ * that work on registers alone are run this way, since anything touching
+ * memory has side effects that differ by lane. As soon as the lanes split up,
+ * the registers go back into each lane's CPU, which runs on its own.
+ *
+ * The GPU of each lane is still ticked on its own after every instruction.
+ */
+class LockstepEnv {
+  private:
+	/**
+	 * The ROM, shared by every lane
+	 */
+	std::shared_ptr<cartridge::Cartridge> cartridge;
+
+	/**
+	 * A Gameboy for each lane
+	 */
+	std::vector<std::unique_ptr<gameboy::Gameboy>> lanes;
+
+	/**
+	 * State that every lane starts in, and is reset to
+	 */
+	std::unique_ptr<gameboy::SaveState> initial_state;
+
+	/**
+	 * Frames run by each lane since its episode began
+	 */
+	std::vector<uint64_t> episode_frames;
+
+	/**
+	 * Frames after which an episode ends, or 0 for no limit
+	 */
+	uint64_t max_episode_frames;
+
+	/**
+	 * Ends episodes early, if set
+	 */
+	DoneCheck done_check;
+
+	/**
+	 * Registers of the lanes while they run in lockstep
+	 */
+	LaneRegisters registers;
+
+	/**
+	 * Set while the registers are in registers, instead of in each CPU
+	 */
+	bool gathered;
+
+	/**
+	 * Mask of the lanes that are still running this step, 0xFF or 0
+	 */
+	std::array<uint8_t, MAX_LANES> active;
+
+	/**
+	 * Counts of how instructions were run
+	 */
+	LockstepStats stats;
+
+	/**
+	 * Check whether every running lane is about to run the same instruction,
+	 * and that it can be run in lockstep
+	 *
+	 * @param opcode Where to put the opcode
+	 * @return true if it can be run in lockstep
+	 */
+	bool find_lockstep_opcode(uint8_t &opcode) const;
+
+	/**
+	 * Run an instruction on every running lane at once
+	 */
+	void run_lockstep(uint8_t opcode);
+
+	/**
+	 * Move the registers of every lane out of its CPU
+	 */
+	void gather();
+
+	/**
+	 * Move the registers of every lane back into its CPU
+	 */
+	void scatter();
+
+  public:
+	/**
+	 * Start a number of lanes of a ROM
+	 *
+	 * @param rom_path Path to the ROM
+	 * @param count Number of lanes, up to MAX_LANES
+	 * @param max_episode_frames Frames after which an episode ends, or 0 for
+	 * no limit
+	 */
+	LockstepEnv(std::string rom_path, std::size_t count,
+	            uint64_t max_episode_frames = 0);
+
+	LockstepEnv(const LockstepEnv &other) = delete;
+	LockstepEnv &operator=(const LockstepEnv &other) = delete;
+
+	/**
+	 * @see VecEnv#step
+	 */
+	void step(const uint8_t *actions, unsigned int frames_per_step,
+	          gpu::VideoBuffer *frames, bool *done);
+
+	/**
+	 * @see VecEnv#reset
+	 */
+	void reset();
+
+	/**
+	 * @see VecEnv#set_done_check
+	 */
+	void set_done_check(DoneCheck check);
+
+	/**
+	 * @see VecEnv#get_count
+	 */
+	std::size_t get_count() const;
+
+	/**
+	 * @see VecEnv#get_instance
+	 */
+	gameboy::Gameboy *get_instance(std::size_t index);
+
+	/**
+	 * Get counts of how instructions were run so far
+	 */
+	LockstepStats get_stats() const;
+};
+
+} // namespace env
@@ -0,0 +1,204 @@
+/**
+ * @file observation.h
+ * Declares the ObservationPipeline class, which turns frames into the
+ * downsampled, stacked observations that agents are trained on
+ */
+
+#pragma once
+
+#include "gpu/utils.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace env {
+
+/**
+ * How each pixel of an observation is stored
+ */
+enum class ObservationFormat {
+	/**
+	 * One byte per pixel, from 0 for black to 255 for white, in the grey
+	 * levels of the default palette
+	 */
+	GRAYSCALE,
+
+	/**
+	 * One byte per pixel, holding the Pixel shade that looks closest
+	 */
+	SHADES,
+
+	/**
+	 * Shades like SHADES, packed 4 to a byte like a PackedFrame, with the
+	 * first pixel in the lowest 2 bits
+	 */
+	PACKED,
+};
+
+/**
+ * What observations an ObservationPipeline makes
+ */
+struct ObservationConfig {
+	/**
+	 * Size of an observation in pixels, up to the size of the screen. Each
+	 * observation pixel is the mean of the screen area it covers.
+	 */
+	unsigned int width = gpu::SCREEN_WIDTH;
+	unsigned int height = gpu::SCREEN_HEIGHT;
+
+	/**
+	 * How pixels are stored
+	 */
+	ObservationFormat format = ObservationFormat::GRAYSCALE;
+
+	/**
+	 * Pool each pixel over the last two frames before downsampling. The
+	 * darker of the two is kept, since sprites are drawn dark over a light
+	 * background, and games that flicker sprites show each one every other
+	 * frame.
+	 */
+	bool max_pool = false;
+
+	/**
+	 * Number of observations in a stack, from oldest to newest
+	 */
+	unsigned int stack = 1;
+};
+
+/**
+ * Makes observations out of frames, and keeps the last few stacked in a ring
+ * owned by the caller.
+ *
+ * The ring holds two copies of the stack, and each observation is written to
+ * both. The last stack of observations is then always in one block of the
+ * ring, oldest first, so it can be handed to the agent without copying.
+ *
+ * Downsampling is done with tables of fixed point weights built up front, in
+ * plain loops over rows of pixels that the compiler turns into vector
+ * instructions. Nothing is allocated once the pipeline is built.
+ */
+class ObservationPipeline {
+  private:
+	/**
+	 * Weights of the source pixels that make up each pixel along one axis of
+	 * an observation
+	 */
+	struct AxisTaps {
+		/**
+		 * Number of source pixels that each observation pixel covers, at most
+		 */
+		unsigned int count;
+
+		/**
+		 * First source pixel of each observation pixel
+		 */
+		std::vector<uint16_t> start;
+
+		/**
+		 * Weight of source pixel start + tap, indexed by [tap][pixel]. An
+		 * observation pixel's weights add up to the size of the source axis.
+		 */
+		std::vector<uint16_t> weights;
+	};
+
+	/**
+	 * What observations are made
+	 */
+	ObservationConfig config;
+
+	/**
+	 * Taps across a row, and down a column
+	 */
+	AxisTaps columns;
+	AxisTaps rows;
+
+	/**
+	 * The closest shade to each grey level
+	 */
+	std::array<uint8_t, 256> closest_shade;
+
+	/**
+	 * Bytes taken by an observation
+	 */
+	std::size_t observation_size;
+
+	/**
+	 * Slot, counting within one copy of the stack, of the newest observation
+	 */
+	std::size_t newest;
+
+	/**
+	 * Set when the next observation is the first since a reset
+	 */
+	bool starting;
+
+	/**
+	 * Build the taps that shrink an axis of the screen
+	 *
+	 * @param source Size of the screen along the axis
+	 * @param size Size of the observation along the axis
+	 */
+	static AxisTaps build_taps(unsigned int source, unsigned int size);
+
+	/**
+	 * Make an observation
+	 *
+	 * @param frame The frame
+	 * @param previous The frame before, to pool with, or nullptr
+	 * @param output Where to write the observation
+	 */
+	void observe(const gpu::VideoBuffer &frame,
+	             const gpu::VideoBuffer *previous, uint8_t *output) const;
+
+  public:
+	/**
+	 * Set up a pipeline. Sizes out of range are clamped to it.
+	 */
+	ObservationPipeline(ObservationConfig config);
+
+	/**
+	 * Get what observations are made, after clamping
+	 */
+	const ObservationConfig &get_config() const;
+
+	/**
+	 * Get the number of bytes that one observation takes
+	 */
+	std::size_t get_observation_size() const;
+
+	/**
+	 * Get the number of bytes of ring that the caller needs to provide, which
+	 * is two stacks of observations
+	 */
+	std::size_t get_ring_size() const;
+
+	/**
+	 * Make an observation of a frame, and add it to the stack
+	 *
+	 * @param frame The frame
+	 * @param previous The frame before, to pool with if config.max_pool is
+	 * set, or nullptr if there was none. It is not used for the first
+	 * observation after a reset.
+	 * @param ring The ring, of get_ring_size() bytes
+	 */
+	void push(const gpu::VideoBuffer &frame, const gpu::VideoBuffer *previous,
+	          uint8_t *ring);
+
+	/**
+	 * Get the stack of the last observations, oldest first. It is
+	 * config.stack observations long.
+	 *
+	 * @param ring The ring that observations were pushed into
+	 */
+	const uint8_t *get_stack(const uint8_t *ring) const;
+
+	/**
+	 * Start a new stack. The next observation is copied into every slot, as
+	 * if it had been seen that many times, and is not pooled.
+	 */
+	void reset();
+};
+
+} // namespace env
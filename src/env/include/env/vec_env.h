@@ -0,0 +1,185 @@
+/**
+ * @file vec_env.h
+ * Declares the VecEnv class, which steps many Gameboys at once for training
+ */
+
+#pragma once
+
+#include "cartridge/cartridge.h"
+#include "env/observation.h"
+#include "gameboy/gameboy.h"
+#include "gameboy/save_state.h"
+#include "gpu/utils.h"
+#include "util/thread_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace env {
+
+/**
+ * Decides whether an instance's episode is over, after each step
+ */
+using DoneCheck = std::function<bool(gameboy::Gameboy &)>;
+
+/**
+ * A vector of headless Gameboys playing the same ROM, stepped together.
+ *
+ * Each step holds one set of buttons on every instance for a number of
+ * frames, and draws only the last frame, straight into the caller's buffer.
+ * The instances are split evenly over a pool of pinned threads, and each
+ * instance is always stepped on the same thread, so it stays in that core's
+ * caches.
+ *
+ * An instance whose episode ends is reset to the state it started in, ready
+ * for the next step. The frame returned with the done flag is the last frame
+ * of the episode.
+ *
+ * Each step can also turn the frames into observations for an agent, with an
+ * ObservationPipeline per instance, which are stacked in rings owned by the
+ * caller.
+ */
+class VecEnv {
+  private:
+	/**
+	 * The ROM, shared by every instance
+	 */
+	std::shared_ptr<cartridge::Cartridge> cartridge;
+
+	/**
+	 * Threads that step the instances
+	 */
+	ThreadPool pool;
+
+	/**
+	 * The instances
+	 */
+	std::vector<std::unique_ptr<gameboy::Gameboy>> instances;
+
+	/**
+	 * State that every instance starts in, and is reset to
+	 */
+	std::unique_ptr<gameboy::SaveState> initial_state;
+
+	/**
+	 * Frames run by each instance since its episode began
+	 */
+	std::vector<uint64_t> episode_frames;
+
+	/**
+	 * Frames after which an episode ends, or 0 for no limit
+	 */
+	uint64_t max_episode_frames;
+
+	/**
+	 * Ends episodes early, if set
+	 */
+	DoneCheck done_check;
+
+	/**
+	 * Makes each instance's observations, if they are on
+	 */
+	std::vector<ObservationPipeline> pipelines;
+
+	/**
+	 * Caller's rings of observations, one after another, or nullptr if
+	 * observations are off
+	 */
+	uint8_t *observation_rings;
+
+	/**
+	 * Where the frame before the last of each step is drawn, for pooling
+	 */
+	std::vector<std::unique_ptr<gpu::VideoBuffer>> pooled_frames;
+
+	/**
+	 * Call a function with the index of every instance, each on the thread
+	 * that the instance belongs to
+	 */
+	void for_each_instance(const std::function<void(std::size_t)> &function);
+
+  public:
+	/**
+	 * Start a number of instances of a ROM
+	 *
+	 * @param rom_path Path to the ROM
+	 * @param count Number of instances
+	 * @param max_episode_frames Frames after which an episode ends, or 0 for
+	 * no limit
+	 * @param thread_count Number of threads to step the instances on. 0 uses
+	 * one per hardware thread. There are never more threads than instances.
+	 */
+	VecEnv(std::string rom_path, std::size_t count,
+	       uint64_t max_episode_frames = 0, std::size_t thread_count = 0);
+
+	VecEnv(const VecEnv &other) = delete;
+	VecEnv &operator=(const VecEnv &other) = delete;
+
+	/**
+	 * Run every instance for some frames
+	 *
+	 * @param actions Buttons to hold on each instance, as a mask like
+	 * Controller#set_buttons. One for each instance.
+	 * @param frames_per_step Number of frames to hold the buttons for
+	 * @param frames Where to draw the last frame of each instance, one after
+	 * another. This is a [count][144][160] array of pixels.
+	 * @param done Set for each instance whose episode ended, in which case it
+	 * has been reset. One for each instance.
+	 */
+	void step(const uint8_t *actions, unsigned int frames_per_step,
+	          gpu::VideoBuffer *frames, bool *done);
+
+	/**
+	 * Reset every instance to the state it started in. Observation stacks
+	 * start over on the next step.
+	 */
+	void reset();
+
+	/**
+	 * Turn observations on or off. While they are on, each step pushes an
+	 * observation of every instance's last frame into its ring, and the
+	 * stack starts over once an episode ends.
+	 *
+	 * @param config What observations to make
+	 * @param rings Where to keep the observations, a ring of
+	 * ObservationPipeline#get_ring_size bytes for each instance one after
+	 * another, or nullptr to turn observations off
+	 */
+	void set_observations(const ObservationConfig &config, uint8_t *rings);
+
+	/**
+	 * Get the stack of an instance's last observations, oldest first
+	 *
+	 * @param index Index of the instance
+	 * @return The stack, which is in the rings, or nullptr if observations
+	 * are off
+	 */
+	const uint8_t *get_observations(std::size_t index) const;
+
+	/**
+	 * Set a check that ends an episode, such as on a game over. It is called
+	 * after each step, on the thread that steps the instance.
+	 *
+	 * @param check Check to use, or nullptr for none
+	 */
+	void set_done_check(DoneCheck check);
+
+	/**
+	 * Get the number of instances
+	 */
+	std::size_t get_count() const;
+
+	/**
+	 * Get an instance, for example to read its memory. It must not be used
+	 * during a step.
+	 *
+	 * @param index Index of the instance
+	 */
+	gameboy::Gameboy *get_instance(std::size_t index);
+};
+
+} // namespace env
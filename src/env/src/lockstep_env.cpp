@@ -0,0 +1,378 @@
+/**
+ * @file lockstep_env.cpp
+ * Defines the LockstepEnv class
+ */
+
+#include "env/lockstep_env.h"
+#include "util/log.h"
+
+#include <algorithm>
+
+namespace env {
+
+/**
+ * Where F is kept in LaneRegisters, in place of (HL)
+ */
+constexpr std::size_t REG_F = 6;
+
+/**
+ * Bits of the F register
+ */
+constexpr uint8_t FLAG_Z = 0x80;
+constexpr uint8_t FLAG_N = 0x40;
+constexpr uint8_t FLAG_H = 0x20;
+constexpr uint8_t FLAG_C = 0x10;
+
+/**
+ * Check whether an opcode only works on registers, and so can be run in
+ * lockstep. These are NOP, INC r, DEC r, LD r, r and the 8 bit arithmetic on
+ * A, without the (HL) forms.
+ */
+static bool is_lockstep_opcode(uint8_t opcode) {
+	auto x = (opcode >> 3) & 7;
+	auto y = opcode & 7;
+	if (opcode == 0x00) {
+		return true;
+	}
+	if (opcode < 0x40) {
+		return (y == 4 || y == 5) && x != REG_F;
+	}
+	if (opcode < 0x80) {
+		return x != REG_F && y != REG_F;
+	}
+	return opcode < 0xC0 && y != REG_F;
+}
+
+/**
+ * Pick the new value in the lanes where mask is set, and the old value in the
+ * others
+ */
+static inline uint8_t blend(uint8_t mask, uint8_t value, uint8_t old) {
+	return static_cast<uint8_t>((value & mask) | (old & ~mask));
+}
+
+LockstepEnv::LockstepEnv(std::string rom_path, std::size_t count,
+                         uint64_t max_episode_frames)
+    : cartridge(std::make_shared<cartridge::Cartridge>(rom_path)),
+      initial_state(std::make_unique<gameboy::SaveState>()),
+      max_episode_frames(max_episode_frames), registers({}), gathered(false),
+      active({}), stats({0, 0, 0}) {
+	if (count > MAX_LANES) {
+		Log::warn("LockstepEnv only runs up to " + std::to_string(MAX_LANES) +
+		          " lanes");
+		count = MAX_LANES;
+	}
+
+	episode_frames.resize(count, 0);
+	for (auto i = std::size_t{0}; i < count; ++i) {
+		lanes.push_back(std::make_unique<gameboy::Gameboy>(
+		    cartridge, nullptr, gameboy::Footprint::MINIMAL));
+		lanes.back()->gpu->set_video_muted(true);
+	}
+
+	if (!lanes.empty()) {
+		lanes[0]->save_state(*initial_state);
+	}
+}
+
+void LockstepEnv::step(const uint8_t *actions, unsigned int frames_per_step,
+                       gpu::VideoBuffer *frames, bool *done) {
+	frames_per_step = std::max(frames_per_step, 1u);
+
+	// Each lane runs whole frames like Gameboy#run_frame, and only draws the
+	// last one, straight into the caller's buffer
+	auto count = lanes.size();
+	auto frames_left = std::vector<unsigned int>(count, frames_per_step);
+	auto frame_start = std::vector<uint64_t>(count);
+	auto frame_cycles = std::vector<cpu::ClockCycles>(count);
+	auto finished = std::vector<bool>(count, false);
+	auto running = count;
+
+	auto start_frame = [&](std::size_t lane) {
+		auto &gpu = lanes[lane]->gpu;
+		gpu->skip_current_frame(frames_left[lane] != 1);
+		frame_start[lane] = gpu->get_frame_count();
+		frame_cycles[lane] = 0;
+	};
+
+	auto end_instruction = [&](std::size_t lane, cpu::ClockCycles cycles) {
+		frame_cycles[lane] += cycles;
+		auto &gpu = lanes[lane]->gpu;
+		auto frame_done = gpu->get_frame_count() != frame_start[lane];
+		if (!frame_done && frame_cycles[lane] < 2 * gpu::CLOCKS_FRAME) {
+			return;
+		}
+
+		finished[lane] = frame_done;
+		if (--frames_left[lane] == 0) {
+			active[lane] = 0;
+			running--;
+		} else {
+			start_frame(lane);
+		}
+	};
+
+	for (auto lane = std::size_t{0}; lane < MAX_LANES; ++lane) {
+		active[lane] = lane < count ? 0xFF : 0;
+	}
+	for (auto lane = std::size_t{0}; lane < count; ++lane) {
+		lanes[lane]->gpu->set_render_target(&frames[lane]);
+		lanes[lane]->set_buttons(actions[lane]);
+		start_frame(lane);
+	}
+
+	// Every running lane runs one instruction each time around, so that
+	// lanes which split up stay in step and can come back together
+	while (running > 0) {
+		auto opcode = uint8_t{0};
+		if (find_lockstep_opcode(opcode)) {
+			if (!gathered) {
+				gather();
+			}
+			run_lockstep(opcode);
+
+			for (auto lane = std::size_t{0}; lane < count; ++lane) {
+				if (active[lane]) {
+					stats.instructions++;
+					stats.lockstep_instructions++;
+					lanes[lane]->advance(1);
+					end_instruction(lane, 1);
+				}
+			}
+		} else {
+			if (gathered) {
+				scatter();
+			}
+
+			for (auto lane = std::size_t{0}; lane < count; ++lane) {
+				if (active[lane]) {
+					stats.instructions++;
+					end_instruction(lane, lanes[lane]->step());
+				}
+			}
+		}
+	}
+	if (gathered) {
+		scatter();
+	}
+
+	for (auto lane = std::size_t{0}; lane < count; ++lane) {
+		auto &gameboy = *lanes[lane];
+		gameboy.gpu->set_render_target(nullptr);
+
+		// With the LCD off no frame is drawn, and the screen is blank
+		if (!finished[lane]) {
+			frames[lane].fill(gpu::Pixel::ZERO);
+		}
+
+		episode_frames[lane] += frames_per_step;
+		done[lane] = (max_episode_frames > 0 &&
+		              episode_frames[lane] >= max_episode_frames) ||
+		             (done_check && done_check(gameboy));
+		if (done[lane]) {
+			gameboy.load_state(*initial_state);
+			episode_frames[lane] = 0;
+		}
+	}
+}
+
+bool LockstepEnv::find_lockstep_opcode(uint8_t &opcode) const {
+	auto count = lanes.size();
+	auto first = std::find(active.begin(), active.begin() + count, 0xFF) -
+	             active.begin();
+
+	// The first lane's opcode rules out most instructions, before checking
+	// every lane
+	auto pc = gathered ? registers.pc[first] : lanes[first]->cpu->get_pc();
+	opcode = lanes[first]->memory->read(pc);
+	if (!is_lockstep_opcode(opcode)) {
+		return false;
+	}
+
+	for (auto lane = std::size_t{0}; lane < count; ++lane) {
+		if (!active[lane]) {
+			continue;
+		}
+		auto lane_pc =
+		    gathered ? registers.pc[lane] : lanes[lane]->cpu->get_pc();
+		if (lane_pc != pc || !lanes[lane]->cpu->will_fetch()) {
+			return false;
+		}
+	}
+
+	// The cartridge is shared, but below 0x100 a lane may still be in the
+	// boot ROM, and above 0x8000 is RAM, so there every lane is checked
+	if (pc < 0x100 || pc >= 0x8000) {
+		for (auto lane = std::size_t{0}; lane < count; ++lane) {
+			if (active[lane] && lanes[lane]->memory->read(pc) != opcode) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void LockstepEnv::run_lockstep(uint8_t opcode) {
+	auto &r = registers.r;
+	auto &f = r[REG_F];
+	auto &a = r[7];
+	auto x = (opcode >> 3) & 7;
+	auto y = opcode & 7;
+
+	// Each loop works on every lane, with the results blended in only where
+	// the lane is running. There are no branches or calls in them, so they
+	// compile to vector instructions.
+	if (opcode == 0x00) {
+		// NOP
+	} else if (opcode < 0x40 && y == 4) {
+		// INC r
+		auto &reg = r[x];
+		for (auto i = std::size_t{0}; i < MAX_LANES; ++i) {
+			auto value = static_cast<uint8_t>(reg[i] + 1);
+			auto flags = (value == 0 ? FLAG_Z : 0) |
+			             ((value & 0x0F) == 0 ? FLAG_H : 0);
+			auto new_f = (f[i] & ~(FLAG_Z | FLAG_N | FLAG_H)) | flags;
+			reg[i] = blend(active[i], value, reg[i]);
+			f[i] = blend(active[i], new_f, f[i]);
+		}
+	} else if (opcode < 0x40) {
+		// DEC r
+		auto &reg = r[x];
+		for (auto i = std::size_t{0}; i < MAX_LANES; ++i) {
+			auto value = static_cast<uint8_t>(reg[i] - 1);
+			auto flags = (value == 0 ? FLAG_Z : 0) | FLAG_N |
+			             ((value & 0x0F) == 0x0F ? FLAG_H : 0);
+			auto new_f = (f[i] & ~(FLAG_Z | FLAG_N | FLAG_H)) | flags;
+			reg[i] = blend(active[i], value, reg[i]);
+			f[i] = blend(active[i], new_f, f[i]);
+		}
+	} else if (opcode < 0x80) {
+		// LD r, r
+		auto &to = r[x];
+		auto &from = r[y];
+		for (auto i = std::size_t{0}; i < MAX_LANES; ++i) {
+			to[i] = blend(active[i], from[i], to[i]);
+		}
+	} else {
+		// ADD, ADC, SUB, SBC, AND, XOR, OR or CP of a register into A. Every
+		// one of them sets all four flags.
+		auto &from = r[y];
+		for (auto i = std::size_t{0}; i < MAX_LANES; ++i) {
+			auto a_val = a[i];
+			auto val = from[i];
+			auto carry = (f[i] & FLAG_C) ? 1 : 0;
+			auto result = 0;
+			auto flags = 0;
+			switch (x) {
+			case 0:
+			case 1: {
+				auto in = x == 1 ? carry : 0;
+				result = a_val + val + in;
+				flags = (((a_val & 0x0F) + (val & 0x0F) + in) > 0x0F ? FLAG_H
+				                                                      : 0) |
+				        (result > 0xFF ? FLAG_C : 0);
+				break;
+			}
+			case 2:
+			case 3:
+			case 7: {
+				auto in = x == 3 ? carry : 0;
+				result = a_val - val - in;
+				flags = FLAG_N |
+				        (((a_val & 0x0F) - (val & 0x0F) - in) < 0 ? FLAG_H
+				                                                   : 0) |
+				        (result < 0 ? FLAG_C : 0);
+				break;
+			}
+			case 4:
+				result = a_val & val;
+				flags = FLAG_H;
+				break;
+			case 5:
+				result = a_val ^ val;
+				break;
+			default:
+				result = a_val | val;
+				break;
+			}
+			auto value = static_cast<uint8_t>(result);
+			flags |= value == 0 ? FLAG_Z : 0;
+
+			// CP only sets the flags
+			if (x != 7) {
+				a[i] = blend(active[i], value, a_val);
+			}
+			f[i] = blend(active[i], (f[i] & 0x0F) | flags, f[i]);
+		}
+	}
+
+	for (auto i = std::size_t{0}; i < MAX_LANES; ++i) {
+		auto step = active[i] & 1;
+		registers.pc[i] += step;
+		registers.instructions[i] += step;
+	}
+}
+
+void LockstepEnv::gather() {
+	auto state = cpu::CPUState();
+	auto &r = registers.r;
+	for (auto lane = std::size_t{0}; lane < lanes.size(); ++lane) {
+		lanes[lane]->cpu->save_state(state);
+		r[0][lane] = state.b;
+		r[1][lane] = state.c;
+		r[2][lane] = state.d;
+		r[3][lane] = state.e;
+		r[4][lane] = state.h;
+		r[5][lane] = state.l;
+		r[REG_F][lane] = state.f;
+		r[7][lane] = state.a;
+		registers.pc[lane] = state.pc;
+		registers.instructions[lane] = 0;
+	}
+	gathered = true;
+	stats.gathers++;
+}
+
+void LockstepEnv::scatter() {
+	// Every instruction run in lockstep takes one cycle
+	auto state = cpu::CPUState();
+	auto &r = registers.r;
+	for (auto lane = std::size_t{0}; lane < lanes.size(); ++lane) {
+		auto &cpu = lanes[lane]->cpu;
+		cpu->save_state(state);
+		state.b = r[0][lane];
+		state.c = r[1][lane];
+		state.d = r[2][lane];
+		state.e = r[3][lane];
+		state.h = r[4][lane];
+		state.l = r[5][lane];
+		state.f = r[REG_F][lane];
+		state.a = r[7][lane];
+		state.pc = registers.pc[lane];
+		state.ticks += registers.instructions[lane];
+		state.total_cpu_cycles += registers.instructions[lane];
+		cpu->load_state(state);
+	}
+	gathered = false;
+}
+
+void LockstepEnv::reset() {
+	for (auto lane = std::size_t{0}; lane < lanes.size(); ++lane) {
+		lanes[lane]->load_state(*initial_state);
+		episode_frames[lane] = 0;
+	}
+}
+
+void LockstepEnv::set_done_check(DoneCheck check) {
+	done_check = std::move(check);
+}
+
+std::size_t LockstepEnv::get_count() const { return lanes.size(); }
+
+gameboy::Gameboy *LockstepEnv::get_instance(std::size_t index) {
+	return lanes[index].get();
+}
+
+LockstepStats LockstepEnv::get_stats() const { return stats; }
+
+} // namespace env
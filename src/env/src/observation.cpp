@@ -0,0 +1,239 @@
+/**
+ * @file observation.cpp
+ * Defines the ObservationPipeline class
+ */
+
+#include "env/observation.h"
+#include "util/log.h"
+#include "video/palette.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace gpu;
+
+namespace env {
+
+/**
+ * What the weights of an observation pixel add up to, over both axes
+ */
+constexpr uint32_t WEIGHT_TOTAL = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+/**
+ * Grey level of each shade, as it is shown on screen
+ */
+static const std::array<uint8_t, 4> GREY_LEVELS = {
+    video::DEFAULT_PALETTE[0][0], video::DEFAULT_PALETTE[1][0],
+    video::DEFAULT_PALETTE[2][0], video::DEFAULT_PALETTE[3][0]};
+
+/**
+ * Get the grey level of every pixel, keeping the darker of two frames if
+ * pooling. Levels are picked with masks rather than by indexing GREY_LEVELS,
+ * so that the loops can be vectorized.
+ */
+static void get_grey_levels(const VideoBuffer &frame,
+                            const VideoBuffer *previous,
+                            std::array<uint8_t, PIXEL_COUNT> &grey) {
+	auto levels = GREY_LEVELS;
+	auto to_grey = [levels](uint8_t pixel) -> uint8_t {
+		auto mask = [pixel](uint8_t shade) -> uint8_t {
+			return -static_cast<uint8_t>(pixel == shade);
+		};
+		return (mask(0) & levels[0]) | (mask(1) & levels[1]) |
+		       (mask(2) & levels[2]) | (mask(3) & levels[3]);
+	};
+
+	auto pixels = reinterpret_cast<const uint8_t *>(frame.data());
+	for (auto i = 0u; i < PIXEL_COUNT; ++i) {
+		grey[i] = to_grey(pixels[i]);
+	}
+
+	if (previous) {
+		auto previous_pixels =
+		    reinterpret_cast<const uint8_t *>(previous->data());
+		for (auto i = 0u; i < PIXEL_COUNT; ++i) {
+			grey[i] = std::min(grey[i], to_grey(previous_pixels[i]));
+		}
+	}
+}
+
+ObservationPipeline::ObservationPipeline(ObservationConfig config)
+    : config(config), newest(0), starting(true) {
+	auto &clamped = this->config;
+	clamped.width = std::clamp(config.width, 1u, unsigned{SCREEN_WIDTH});
+	clamped.height = std::clamp(config.height, 1u, unsigned{SCREEN_HEIGHT});
+	clamped.stack = std::max(config.stack, 1u);
+	if (clamped.width != config.width || clamped.height != config.height ||
+	    clamped.stack != config.stack) {
+		Log::warn("Observations are " + std::to_string(clamped.width) + "x" +
+		          std::to_string(clamped.height) + ", stacked " +
+		          std::to_string(clamped.stack) + " deep");
+	}
+
+	columns = build_taps(SCREEN_WIDTH, clamped.width);
+	rows = build_taps(SCREEN_HEIGHT, clamped.height);
+
+	for (auto level = 0u; level < closest_shade.size(); ++level) {
+		auto distance = [level](std::size_t shade) {
+			return std::abs(static_cast<int>(level) - GREY_LEVELS[shade]);
+		};
+		auto closest = std::size_t{0};
+		for (auto shade = std::size_t{1}; shade < GREY_LEVELS.size();
+		     ++shade) {
+			if (distance(shade) < distance(closest)) {
+				closest = shade;
+			}
+		}
+		closest_shade[level] = closest;
+	}
+
+	auto pixels = std::size_t{clamped.width} * clamped.height;
+	observation_size = clamped.format == ObservationFormat::PACKED
+	                       ? (pixels + 3) / 4
+	                       : pixels;
+}
+
+ObservationPipeline::AxisTaps
+ObservationPipeline::build_taps(unsigned int source, unsigned int size) {
+	// Positions are counted in 1/size of a source pixel, so that both source
+	// and observation pixels start on whole numbers. An observation pixel is
+	// then source long, and covers a source pixel by however much they
+	// overlap.
+	auto taps = AxisTaps();
+	taps.count = 0;
+	for (auto pixel = 0u; pixel < size; ++pixel) {
+		auto first = pixel * source / size;
+		auto last = ((pixel + 1) * source - 1) / size;
+		taps.count = std::max(taps.count, last - first + 1);
+	}
+	taps.start.resize(size);
+	taps.weights.assign(taps.count * size, 0);
+
+	for (auto pixel = 0u; pixel < size; ++pixel) {
+		auto begin = pixel * source;
+		auto end = begin + source;
+		auto first = begin / size;
+		auto last = (end - 1) / size;
+
+		// Taps past the last source pixel would read off the end of the row,
+		// so they are moved back to end at it, with nothing weighing them
+		auto start = std::min(first, source - taps.count);
+		taps.start[pixel] = start;
+		for (auto i = first; i <= last; ++i) {
+			auto overlap =
+			    std::min(end, (i + 1) * size) - std::max(begin, i * size);
+			taps.weights[(i - start) * size + pixel] = overlap;
+		}
+	}
+	return taps;
+}
+
+void ObservationPipeline::observe(const VideoBuffer &frame,
+                                  const VideoBuffer *previous,
+                                  uint8_t *output) const {
+	auto width = config.width;
+	auto height = config.height;
+	// Every element is written before it is read, so none are cleared
+	std::array<uint8_t, PIXEL_COUNT> grey;
+	std::array<uint16_t, SCREEN_WIDTH> column_sums;
+	std::array<uint32_t, SCREEN_WIDTH> sums;
+	get_grey_levels(frame, previous, grey);
+
+	// Packed observations are made as shades, then packed at the end, with
+	// room to pad the last byte
+	std::array<uint8_t, PIXEL_COUNT + 3> shades;
+	auto packed = config.format == ObservationFormat::PACKED;
+
+	for (auto y = 0u; y < height; ++y) {
+		// Shrink down the columns first, which works on whole rows at a time.
+		// The weights add up to the screen height, so the sums fit 16 bits.
+		column_sums.fill(0);
+		for (auto tap = 0u; tap < rows.count; ++tap) {
+			auto weight = rows.weights[tap * height + y];
+			auto row = &grey[(rows.start[y] + tap) * SCREEN_WIDTH];
+			for (auto x = 0u; x < SCREEN_WIDTH; ++x) {
+				column_sums[x] += weight * row[x];
+			}
+		}
+
+		// Then shrink across the row
+		std::fill_n(sums.begin(), width, 0);
+		for (auto tap = 0u; tap < columns.count; ++tap) {
+			auto weights = &columns.weights[tap * width];
+			auto start = columns.start.data();
+			for (auto x = 0u; x < width; ++x) {
+				sums[x] += uint32_t{weights[x]} * column_sums[start[x] + tap];
+			}
+		}
+
+		for (auto x = 0u; x < width; ++x) {
+			sums[x] = (sums[x] + WEIGHT_TOTAL / 2) / WEIGHT_TOTAL;
+		}
+
+		auto row_output = (packed ? shades.data() : output) + y * width;
+		if (config.format == ObservationFormat::GRAYSCALE) {
+			std::copy_n(sums.begin(), width, row_output);
+		} else {
+			for (auto x = 0u; x < width; ++x) {
+				row_output[x] = closest_shade[sums[x]];
+			}
+		}
+	}
+
+	if (packed) {
+		auto pixels = width * height;
+		std::fill(shades.begin() + pixels,
+		          shades.begin() + observation_size * 4, 0);
+		for (auto i = 0u; i < observation_size; ++i) {
+			output[i] = shades[i * 4] | shades[i * 4 + 1] << 2 |
+			            shades[i * 4 + 2] << 4 | shades[i * 4 + 3] << 6;
+		}
+	}
+}
+
+const ObservationConfig &ObservationPipeline::get_config() const {
+	return config;
+}
+
+std::size_t ObservationPipeline::get_observation_size() const {
+	return observation_size;
+}
+
+std::size_t ObservationPipeline::get_ring_size() const {
+	return observation_size * config.stack * 2;
+}
+
+void ObservationPipeline::push(const VideoBuffer &frame,
+                               const VideoBuffer *previous, uint8_t *ring) {
+	auto slots = std::size_t{config.stack};
+
+	// A new stack is filled with its first observation
+	if (starting) {
+		observe(frame, nullptr, ring);
+		for (auto slot = std::size_t{1}; slot < slots * 2; ++slot) {
+			std::memcpy(ring + slot * observation_size, ring,
+			            observation_size);
+		}
+		newest = slots - 1;
+		starting = false;
+		return;
+	}
+
+	newest = (newest + 1) % slots;
+	auto observation = ring + newest * observation_size;
+	observe(frame, config.max_pool ? previous : nullptr, observation);
+	std::memcpy(observation + slots * observation_size, observation,
+	            observation_size);
+}
+
+const uint8_t *ObservationPipeline::get_stack(const uint8_t *ring) const {
+	// The newest observation is also in slot newest + stack, so the stack of
+	// slots that ends there holds the last observations in order
+	return ring + (newest + 1) * observation_size;
+}
+
+void ObservationPipeline::reset() { starting = true; }
+
+} // namespace env
@@ -0,0 +1,160 @@
+/**
+ * @file vec_env.cpp
+ * Defines the VecEnv class
+ */
+
+#include "env/vec_env.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace env {
+
+/**
+ * Get the number of threads to use for some instances
+ */
+static std::size_t pick_thread_count(std::size_t thread_count,
+                                     std::size_t count) {
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	return std::max<std::size_t>(1, std::min(thread_count, count));
+}
+
+VecEnv::VecEnv(std::string rom_path, std::size_t count,
+               uint64_t max_episode_frames, std::size_t thread_count)
+    : cartridge(std::make_shared<cartridge::Cartridge>(rom_path)),
+      pool(pick_thread_count(thread_count, count)), instances(count),
+      initial_state(std::make_unique<gameboy::SaveState>()),
+      episode_frames(count, 0), max_episode_frames(max_episode_frames),
+      observation_rings(nullptr), pooled_frames(count) {
+	pool.pin_threads();
+
+	// Each instance is built on its own thread, so that its memory is
+	// allocated close to the core that runs it. Frames are drawn straight
+	// into the caller's buffer, so the instances have no frame buffers or
+	// Video drivers of their own.
+	for_each_instance([this](std::size_t index) {
+		instances[index] = std::make_unique<gameboy::Gameboy>(
+		    cartridge, nullptr, gameboy::Footprint::MINIMAL);
+		instances[index]->gpu->set_video_muted(true);
+	});
+
+	if (!instances.empty()) {
+		instances[0]->save_state(*initial_state);
+	}
+}
+
+void VecEnv::step(const uint8_t *actions, unsigned int frames_per_step,
+                  gpu::VideoBuffer *frames, bool *done) {
+	frames_per_step = std::max(frames_per_step, 1u);
+
+	for_each_instance([&](std::size_t index) {
+		auto &gameboy = *instances[index];
+		auto &frame = frames[index];
+
+		// Only the last frame is drawn, and it goes straight into the
+		// caller's buffer. When pooling observations, the frame before it
+		// is drawn too.
+		auto pooled_frame = pooled_frames[index].get();
+		gameboy.set_buttons(actions[index]);
+		auto finished = true;
+		for (auto i = 1u; i <= frames_per_step; ++i) {
+			auto last = i == frames_per_step;
+			auto pooled = pooled_frame && i + 1 == frames_per_step;
+			auto frame_count = gameboy.gpu->get_frame_count();
+			gameboy.gpu->set_render_target(last ? &frame : pooled_frame);
+			gameboy.gpu->skip_current_frame(!last && !pooled);
+			gameboy.run_frame();
+			finished = gameboy.gpu->get_frame_count() != frame_count;
+		}
+		gameboy.gpu->set_render_target(nullptr);
+
+		// With the LCD off no frame is drawn, and the screen is blank
+		if (!finished) {
+			frame.fill(gpu::Pixel::ZERO);
+		}
+
+		if (observation_rings) {
+			auto &pipeline = pipelines[index];
+			auto ring = observation_rings + index * pipeline.get_ring_size();
+			pipeline.push(frame, pooled_frame, ring);
+
+			// A step of one frame pools with the last frame of this step
+			if (pooled_frame) {
+				*pooled_frame = frame;
+			}
+		}
+
+		episode_frames[index] += frames_per_step;
+		done[index] = (max_episode_frames > 0 &&
+		               episode_frames[index] >= max_episode_frames) ||
+		              (done_check && done_check(gameboy));
+		if (done[index]) {
+			gameboy.load_state(*initial_state);
+			episode_frames[index] = 0;
+			if (observation_rings) {
+				pipelines[index].reset();
+			}
+		}
+	});
+}
+
+void VecEnv::reset() {
+	for_each_instance([this](std::size_t index) {
+		instances[index]->load_state(*initial_state);
+		episode_frames[index] = 0;
+		if (observation_rings) {
+			pipelines[index].reset();
+		}
+	});
+}
+
+void VecEnv::set_observations(const ObservationConfig &config,
+                              uint8_t *rings) {
+	observation_rings = rings;
+	pipelines.assign(rings ? instances.size() : 0, ObservationPipeline(config));
+
+	// The frames to pool with are allocated on the thread of their instance,
+	// like the instance itself
+	auto pool_frames = rings && config.max_pool;
+	for_each_instance([&](std::size_t index) {
+		if (pool_frames && !pooled_frames[index]) {
+			pooled_frames[index] = std::make_unique<gpu::VideoBuffer>();
+		} else if (!pool_frames) {
+			pooled_frames[index].reset();
+		}
+	});
+}
+
+const uint8_t *VecEnv::get_observations(std::size_t index) const {
+	if (!observation_rings) {
+		return nullptr;
+	}
+	auto &pipeline = pipelines[index];
+	return pipeline.get_stack(observation_rings +
+	                          index * pipeline.get_ring_size());
+}
+
+void VecEnv::set_done_check(DoneCheck check) { done_check = std::move(check); }
+
+std::size_t VecEnv::get_count() const { return instances.size(); }
+
+gameboy::Gameboy *VecEnv::get_instance(std::size_t index) {
+	return instances[index].get();
+}
+
+void VecEnv::for_each_instance(
+    const std::function<void(std::size_t)> &function) {
+	// Instances are split into one block per thread, which never changes
+	auto count = instances.size();
+	auto threads = pool.get_thread_count();
+	pool.run_on_each([&](std::size_t thread) {
+		auto end = (thread + 1) * count / threads;
+		for (auto index = thread * count / threads; index < end; ++index) {
+			function(index);
+		}
+	});
+}
+
+} // namespace env
@@ -9,16 +9,22 @@
 #include "cpu/cpu.h"
 #include "cpu/register/register.h"
 #include "gpu/gpu.h"
+#include "gameboy/save_state.h"
 #include "gpu/utils.h"
 #include "memory/memory.h"
+#include "util/hash.h"
 #include "util/helpers.h"
 #include "util/log.h"
-#include "video/video.h"
+#include "video/buffer_video.h"
+#include "video/null_video.h"
+#include "video/video_interface.h"
 
 #include "debugger/debugger.fwd.h"
 
+#include <chrono>
 #include <ctime>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <string>
@@ -34,15 +40,103 @@ using namespace controller;
 
 namespace gameboy {
 
+/**
+ * Creates the Video driver for a Gameboy, given the queue that it may send
+ * input through and the metadata of the loaded cartridge
+ */
+using VideoFactory = std::function<std::unique_ptr<VideoInterface>(
+    InputQueue *, CartridgeMetadata *)>;
+
+/**
+ * Summary of how long input took to show up on screen
+ */
+struct InputLatency {
+	/**
+	 * Number of input events measured
+	 */
+	uint64_t events;
+
+	/**
+	 * Mean number of clock cycles from the cycle that an event was stamped
+	 * with, to the end of the first frame emulated after it
+	 */
+	double mean_cycles;
+
+	/**
+	 * Most clock cycles taken by any one event
+	 */
+	uint64_t max_cycles;
+};
+
+/**
+ * Time taken by frames run with run_ahead
+ */
+struct RunAheadStats {
+	/**
+	 * Number of frames run
+	 */
+	uint64_t frames;
+
+	/**
+	 * Mean time taken to run each frame itself, in microseconds
+	 */
+	double frame_us;
+
+	/**
+	 * Mean time added to each frame by saving, running ahead and loading, in
+	 * microseconds
+	 */
+	double run_ahead_us;
+};
+
+/**
+ * How much a Gameboy keeps for itself, on top of the emulated hardware
+ */
+enum class Footprint {
+	/**
+	 * A frame buffer in the GPU, a Video driver and a queue of input events
+	 */
+	FULL,
+
+	/**
+	 * Only the emulated hardware, for packing many Gameboys into one host.
+	 * The GPU has no frame buffer, so frames are only drawn into a render
+	 * target. The Video driver is a NullVideo unless a factory is given, and
+	 * there is no input queue, so buttons are set on the controller.
+	 */
+	MINIMAL,
+};
+
+/**
+ * What Gameboy#reset puts the Gameboy back to
+ */
+enum class ResetMode {
+	/**
+	 * As it was built, about to run the boot ROM
+	 */
+	POWER_ON,
+
+	/**
+	 * Where the boot ROM hands over to the game at 0x100, without running
+	 * the boot ROM again
+	 */
+	POST_BOOT,
+
+	/**
+	 * The snapshot given to set_reset_snapshot
+	 */
+	SNAPSHOT,
+};
+
 /**
  * Gameboy class that initializes and contains the complete application
  */
 class Gameboy {
   public:
 	/**
-	 * Cartridge instance
+	 * Cartridge instance, shared with forks since the ROM never changes
 	 */
-	std::unique_ptr<Cartridge> cartridge;
+	std::shared_ptr<Cartridge> cartridge;
 
 	/**
 	 * Controller instance
@@ -52,7 +146,7 @@ class Gameboy {
 	/**
 	 * Video instance
 	 */
-	std::unique_ptr<Video> video;
+	std::unique_ptr<VideoInterface> video;
 
 	/**
 	 * Memory instance
@@ -69,6 +163,68 @@ class Gameboy {
 	 */
 	std::unique_ptr<GPU> gpu;
 
+	/**
+	 * Input events waiting for their cycle to come around. They can be pushed
+	 * from another thread, such as the one running the window. It is null
+	 * with Footprint::MINIMAL.
+	 */
+	std::unique_ptr<InputQueue> inputs;
+
+	/**
+	 * What the Gameboy keeps for itself, which forks keep too
+	 */
+	Footprint footprint;
+
+	/**
+	 * Number of clock cycles emulated so far
+	 */
+	uint64_t cycle_count;
+
+	/**
+	 * Frame count of the GPU as of the last tick, to notice new frames
+	 */
+	uint64_t frame_count;
+
+	/**
+	 * Input events applied since the last frame, and the sum and smallest of
+	 * their cycle stamps
+	 */
+	uint64_t pending_inputs;
+	uint64_t pending_input_cycles;
+	uint64_t oldest_input_cycle;
+
+	/**
+	 * Latency of all the input events measured so far
+	 */
+	uint64_t input_events;
+	uint64_t input_latency_total;
+	uint64_t input_latency_max;
+
+	/**
+	 * Set when a state is loaded. Queued events were stamped with cycles from
+	 * before the load, which may not come around again, so they are applied
+	 * at once instead of waiting.
+	 */
+	bool flush_inputs;
+
+	/**
+	 * State that run_ahead returns to after running ahead. It is only
+	 * allocated once needed, so that forks stay small.
+	 */
+	std::unique_ptr<SaveState> run_ahead_state;
+
+	/**
+	 * Snapshot that reset goes back to with ResetMode::SNAPSHOT, if set
+	 */
+	std::shared_ptr<const SaveState> reset_snapshot;
+
+	/**
+	 * Frames run with run_ahead, and the time spent on them
+	 */
+	uint64_t run_ahead_frames;
+	std::chrono::nanoseconds frame_time;
+	std::chrono::nanoseconds run_ahead_time;
+
 	/**
 	 * Helper method to create a CPU object
 	 *
@@ -83,22 +239,185 @@ class Gameboy {
 	 * @param memory_ptr Pointer to memory instance
 	 * @param cpu_ptr Pointer to cpu instance
 	 * @param video_ptr Pointer to video instance
+	 * @param own_frame_buffer False to build the GPU without a frame buffer
 	 * @return std::unique_ptr<GPU>
 	 */
 	std::unique_ptr<GPU> create_gpu(Memory *memory_ptr, CPU *cpu_ptr,
-	                                Video *video_ptr);
+	                                VideoInterface *video_ptr,
+	                                bool own_frame_buffer = true);
 
 	/**
 	 * @brief Construct a new Gameboy object
 	 *
 	 * @param rom_path Path to ROM File
+	 * @param video_factory Creates the Video driver. If empty, a headless
+	 * BufferVideo driver is used
 	 */
-	Gameboy(std::string rom_path);
+	Gameboy(std::string rom_path, VideoFactory video_factory = nullptr);
+
+	/**
+	 * @brief Construct a new Gameboy object around a loaded cartridge
+	 *
+	 * @param p_cartridge Cartridge to play, which may be shared
+	 * @param video_factory Creates the Video driver. If empty, a headless
+	 * BufferVideo driver is used
+	 * @param p_footprint What the Gameboy keeps for itself
+	 */
+	Gameboy(std::shared_ptr<Cartridge> p_cartridge,
+	        VideoFactory video_factory = nullptr,
+	        Footprint p_footprint = Footprint::FULL);
 
 	/**
 	 * Runs one CPU tick and corresponding GPU tick
+	 *
+	 * @return Number of clock cycles that elapsed
+	 */
+	ClockCycles tick();
+
+	/**
+	 * Runs one CPU tick and corresponding GPU tick, without applying input
+	 *
+	 * @return Number of clock cycles that elapsed
+	 */
+	ClockCycles step();
+
+	/**
+	 * Runs the rest of the Gameboy for clock cycles that the CPU has already
+	 * taken, as step does after ticking the CPU
+	 *
+	 * @param cpu_cycles Number of clock cycles that the CPU took
+	 */
+	void advance(ClockCycles cpu_cycles);
+
+	/**
+	 * Runs until the GPU finishes a frame, without applying input, so that
+	 * the buttons are the same for the whole frame. Call apply_inputs or set
+	 * the buttons first.
+	 *
+	 * @return Number of clock cycles that elapsed
+	 */
+	ClockCycles run_frame();
+
+	/**
+	 * Runs a frame like run_frame, without drawing it. Then runs further
+	 * frames ahead and draws only the last, so that it is shown with the
+	 * newest input, before going back to the end of the first frame. This
+	 * hides the frames of lag that games have between reading input and
+	 * showing the result.
+	 *
+	 * @param frames Number of frames to run ahead. With 0, the frame is drawn
+	 * and nothing else is done.
+	 * @param render False to skip drawing the frame ahead as well
+	 * @return Number of clock cycles that the first frame took
+	 */
+	ClockCycles run_ahead(unsigned int frames, bool render = true);
+
+	/**
+	 * Get the time taken by frames run with run_ahead
+	 */
+	RunAheadStats get_run_ahead_stats() const;
+
+	/**
+	 * Hash everything that decides how emulation carries on. This is the
+	 * SaveState up to the frame being drawn.
+	 */
+	uint64_t get_state_hash() const;
+
+	/**
+	 * Snapshot the whole Gameboy
+	 *
+	 * @param state State to fill in
+	 */
+	void save_state(SaveState &state) const;
+
+	/**
+	 * Put the Gameboy back into a state made by save_state. Input events that
+	 * are still queued are left alone.
+	 *
+	 * @param state State to restore
+	 * @return False if the state is from another version or another ROM, in
+	 * which case nothing is changed
+	 */
+	bool load_state(const SaveState &state);
+
+	/**
+	 * Make a new Gameboy that carries on from exactly where this one is. The
+	 * two share the cartridge and every page of memory, and a page is only
+	 * copied when one of them writes to it, so a fork costs a few kilobytes
+	 * on top of its own frame buffers.
+	 *
+	 * The fork may run on another thread, but this Gameboy must not be
+	 * running while it is forked. Queued input events are not carried over.
+	 *
+	 * @param video_factory Creates the Video driver of the fork. If empty, the
+	 * same kind of driver as a new Gameboy with this one's footprint is used
+	 * @return The new Gameboy
+	 */
+	std::unique_ptr<Gameboy> fork(VideoFactory video_factory = nullptr) const;
+
+	/**
+	 * Put the Gameboy back to the start of a run, keeping everything that it
+	 * has allocated. The power on and post boot snapshots are made once for
+	 * each ROM and kept for the rest of the program, so after the first reset
+	 * this is only a load_state.
+	 *
+	 * @param mode What to go back to
+	 * @return False if there is no snapshot to go back to, in which case
+	 * nothing is changed
+	 */
+	bool reset(ResetMode mode = ResetMode::POST_BOOT);
+
+	/**
+	 * Jump straight to where the boot ROM hands over to the game at 0x100,
+	 * without running it. The registers, the GPU and memory are set to what
+	 * the boot ROM leaves behind, including the logo in VRAM, so the game
+	 * carries on as if it had run. Only the cycle and frame counts differ,
+	 * since no time has passed. Call it on a Gameboy that was just built.
+	 */
+	void skip_boot();
+
+	/**
+	 * Set the snapshot that reset goes back to with ResetMode::SNAPSHOT. It
+	 * may be shared by many Gameboys playing the same ROM.
+	 *
+	 * @param state Snapshot made by save_state, or nullptr for none
+	 */
+	void set_reset_snapshot(std::shared_ptr<const SaveState> state);
+
+	/**
+	 * Hold the buttons in a mask, and raise the JOYPAD interrupt if any are
+	 * newly pressed. Movies, window input and the embedding APIs all set the
+	 * buttons through here, so a movie plays back the same as it was played.
+	 *
+	 * @param mask Buttons held, in the order of Controller#get_buttons
+	 */
+	void set_buttons(uint8_t mask);
+
+	/**
+	 * Apply the input events whose cycle has come, and raise the JOYPAD
+	 * interrupt for buttons that they leave newly pressed
+	 *
+	 * @param lookahead Also apply events stamped up to this many cycles
+	 * ahead. Callers that hold the buttons for a whole frame pass
+	 * CLOCKS_FRAME, so that input sent during a frame is taken at its start
+	 * instead of a frame late.
+	 */
+	void apply_inputs(ClockCycles lookahead = 0);
+
+	/**
+	 * Measure the latency of applied input events, once a frame is finished
+	 */
+	void measure_input_latency();
+
+	/**
+	 * Get the latency of input events applied so far
+	 */
+	InputLatency get_input_latency() const;
+
+	/**
+	 * Get the number of clock cycles emulated so far
 	 */
-	void tick();
+	uint64_t get_cycle_count() const;
 
 	/**
 	 * The all-seeing Debugger overlord may peep into this object, muahaha!
@@ -0,0 +1,154 @@
+/**
+ * @file rewind_buffer.h
+ * Declares the RewindBuffer class, a history of save states to rewind through
+ */
+
+#pragma once
+
+#include "gameboy/save_state.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gameboy {
+
+/**
+ * One step of the rewind history, stored as the XOR of its state with the
+ * state that came after it
+ */
+struct RewindDelta {
+	/**
+	 * The delta before it is compressed, or empty once it has been
+	 */
+	std::vector<uint8_t> raw;
+
+	/**
+	 * The delta compressed with compress_delta
+	 */
+	std::vector<uint8_t> compressed;
+
+	/**
+	 * Set once the delta has left the history, by rewinding or trimming
+	 */
+	bool dropped = false;
+};
+
+/**
+ * Keeps a history of save states within a memory budget, and steps back
+ * through it.
+ *
+ * Only the newest state is kept whole. Every older one is kept as the XOR of
+ * itself with the state after it, which is zero almost everywhere, and a
+ * background thread compresses these deltas. Rewinding a step XORs the newest
+ * delta into the newest state. When the history outgrows the budget, the
+ * oldest deltas are dropped, since nothing depends on them.
+ */
+class RewindBuffer {
+  private:
+	/**
+	 * Most memory that the deltas may take up, in bytes
+	 */
+	std::size_t budget;
+
+	/**
+	 * Newest state pushed, and whether there is one
+	 */
+	std::unique_ptr<SaveState> latest;
+	bool has_latest;
+
+	/**
+	 * Deltas from the oldest to the newest, shared with the compressor
+	 */
+	std::deque<std::shared_ptr<RewindDelta>> deltas;
+
+	/**
+	 * Memory taken up by the deltas, in bytes
+	 */
+	std::size_t used;
+
+	/**
+	 * Guards the deltas and everything below
+	 */
+	std::mutex mutex;
+
+	/**
+	 * Signalled when there is a delta to compress, or the buffer is stopping
+	 */
+	std::condition_variable work_ready;
+
+	/**
+	 * Set when the buffer is being destroyed
+	 */
+	bool stopping;
+
+	/**
+	 * Thread that compresses deltas
+	 */
+	std::thread compressor;
+
+	/**
+	 * Find the oldest delta that isn't compressed yet. Must be called with
+	 * the lock held.
+	 */
+	std::shared_ptr<RewindDelta> next_raw_delta() const;
+
+	/**
+	 * Drop the oldest deltas until the rest fit in the budget. Must be called
+	 * with the lock held.
+	 */
+	void trim();
+
+	/**
+	 * Main loop of the compressor thread
+	 */
+	void compressor_loop();
+
+  public:
+	/**
+	 * Start an empty history
+	 *
+	 * @param budget Most memory that the history may take up, in bytes
+	 */
+	RewindBuffer(std::size_t budget);
+
+	/**
+	 * Stop the compressor thread
+	 */
+	~RewindBuffer();
+
+	RewindBuffer(const RewindBuffer &other) = delete;
+	RewindBuffer &operator=(const RewindBuffer &other) = delete;
+
+	/**
+	 * Add a state to the end of the history
+	 *
+	 * @param state State to add
+	 */
+	void push(const SaveState &state);
+
+	/**
+	 * Take the newest state off the end of the history
+	 *
+	 * @param state Where to put the state
+	 * @return false if the history is empty
+	 */
+	bool pop(SaveState &state);
+
+	/**
+	 * Get the number of states in the history
+	 */
+	std::size_t get_size();
+
+	/**
+	 * Get the memory taken up by the deltas, in bytes
+	 */
+	std::size_t get_used();
+};
+
+} // namespace gameboy
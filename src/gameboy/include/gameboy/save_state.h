@@ -0,0 +1,72 @@
+/**
+ * @file save_state.h
+ * Declares the SaveState structure, a snapshot of a whole Gameboy
+ */
+
+#pragma once
+
+#include "controller/utils.h"
+#include "cpu/utils.h"
+#include "gpu/utils.h"
+#include "memory/utils.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace gameboy {
+
+/**
+ * Magic number at the start of every save state, "TVSS" in little endian
+ */
+const uint32_t SAVE_STATE_MAGIC = 0x53535654;
+
+/**
+ * Version of the SaveState layout. This must change whenever a field is
+ * added, removed or resized, so that old states are turned away.
+ */
+const uint32_t SAVE_STATE_VERSION = 2;
+
+/**
+ * Everything needed to put a Gameboy back exactly as it was, as one flat
+ * block of plain data. It holds no pointers, so it can be copied, written to
+ * a file or compared a byte at a time, and saving or loading one is only a
+ * few copies.
+ *
+ * Everything up to frame decides how emulation carries on, and is what
+ * Gameboy#get_state_hash hashes.
+ */
+struct SaveState {
+	/**
+	 * SAVE_STATE_MAGIC and SAVE_STATE_VERSION
+	 */
+	uint32_t magic;
+	uint32_t version;
+
+	/**
+	 * Checksum of the ROM that the state was saved with
+	 */
+	uint64_t rom_checksum;
+
+	/**
+	 * Number of clock cycles emulated
+	 */
+	uint64_t cycle_count;
+
+	/**
+	 * State of each part of the Gameboy
+	 */
+	cpu::CPUState cpu;
+	gpu::GPUState gpu;
+	controller::ControllerState controller;
+	MemoryState memory;
+
+	/**
+	 * The frame that the GPU is part way through drawing
+	 */
+	gpu::GPUFrameState frame;
+};
+
+static_assert(std::is_trivially_copyable<SaveState>::value,
+              "SaveState must be plain data");
+
+} // namespace gameboy
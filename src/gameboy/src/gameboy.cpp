@@ -1,14 +1,106 @@
 #include "gameboy/gameboy.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <utility>
+
 namespace gameboy {
 
-Gameboy::Gameboy(std::string rom_path) {
-	cartridge = std::make_unique<Cartridge>(rom_path);
+/**
+ * Clock cycles that the boot ROM gets to hand over to the game, which is well
+ * over the time it takes with a valid header
+ */
+constexpr uint64_t BOOT_CYCLE_LIMIT = 300 * CLOCKS_FRAME;
+
+/**
+ * Make the power on or post boot snapshot of a ROM
+ *
+ * @return The snapshot, or nullptr if the boot ROM never handed over
+ */
+static std::shared_ptr<const SaveState>
+make_boot_snapshot(const std::shared_ptr<Cartridge> &cartridge,
+                   ResetMode mode) {
+	auto gameboy = std::make_unique<Gameboy>(cartridge);
+	if (mode == ResetMode::POST_BOOT) {
+		gameboy->gpu->set_video_muted(true);
+		while (gameboy->cpu->get_pc() != 0x100 ||
+		       gameboy->memory->read(0xFF50) == 0) {
+			if (gameboy->cycle_count >= BOOT_CYCLE_LIMIT) {
+				Log::error("The boot ROM never reached the game");
+				return nullptr;
+			}
+			gameboy->step();
+		}
+	}
+
+	auto snapshot = std::make_shared<SaveState>();
+	gameboy->save_state(*snapshot);
+	return snapshot;
+}
+
+/**
+ * Get the power on or post boot snapshot of a ROM, making it the first time
+ * it is asked for. Snapshots are kept by ROM checksum, so every Gameboy
+ * playing the same ROM shares them. A ROM that fails to boot is remembered
+ * too, and isn't booted again.
+ *
+ * @return The snapshot, or nullptr if the boot ROM never handed over
+ */
+static std::shared_ptr<const SaveState>
+get_boot_snapshot(const std::shared_ptr<Cartridge> &cartridge, ResetMode mode) {
+	struct Entry {
+		std::once_flag made;
+		std::shared_ptr<const SaveState> snapshot;
+	};
+	static auto lock = std::mutex();
+	static auto entries = std::map<std::pair<uint64_t, ResetMode>, Entry>();
+
+	// The lock only guards the map. Gameboys resetting to the same ROM at
+	// once wait on its entry while it boots, and other ROMs boot alongside.
+	Entry *entry = nullptr;
+	{
+		auto guard = std::lock_guard<std::mutex>(lock);
+		entry = &entries[{cartridge->get_checksum(), mode}];
+	}
+	std::call_once(entry->made, [&] {
+		entry->snapshot = make_boot_snapshot(cartridge, mode);
+	});
+	return entry->snapshot;
+}
+
+Gameboy::Gameboy(std::string rom_path, VideoFactory video_factory)
+    : Gameboy(std::make_shared<Cartridge>(rom_path),
+              std::move(video_factory)) {}
+
+Gameboy::Gameboy(std::shared_ptr<Cartridge> p_cartridge,
+                 VideoFactory video_factory, Footprint p_footprint)
+    : cartridge(std::move(p_cartridge)), footprint(p_footprint),
+      cycle_count(0), frame_count(0),
+      pending_inputs(0), pending_input_cycles(0), oldest_input_cycle(0),
+      input_events(0), input_latency_total(0), input_latency_max(0),
+      flush_inputs(false), run_ahead_frames(0), frame_time(0),
+      run_ahead_time(0) {
+	// A minimal Gameboy leaves out everything that is only needed to show
+	// frames or take input from a window
+	auto minimal = footprint == Footprint::MINIMAL;
+	if (!minimal) {
+		inputs = std::make_unique<InputQueue>();
+	}
+
 	controller = std::make_unique<Controller>();
-	video = make_unique<Video>(controller.get(), cartridge->get_metadata());
+	if (video_factory) {
+		video = video_factory(inputs.get(), cartridge->get_metadata());
+	} else if (minimal) {
+		video = make_unique<NullVideo>();
+	} else {
+		video = make_unique<BufferVideo>();
+	}
 	memory = make_unique<Memory>(cartridge.get(), controller.get());
 	cpu = create_cpu(memory.get());
-	gpu = create_gpu(memory.get(), cpu.get(), video.get());
+	gpu = create_gpu(memory.get(), cpu.get(), video.get(), !minimal);
 
 	// Set pointers to instances of CPU, GPU, and timer in memory
 	memory->set_cpu(cpu.get());
@@ -17,11 +109,329 @@ Gameboy::Gameboy(std::string rom_path) {
 	Log::info("GameBoy Start Successful!");
 }
 
-void Gameboy::tick() {
+ClockCycles Gameboy::tick() {
+	apply_inputs();
+	return step();
+}
+
+ClockCycles Gameboy::step() {
 	auto cpu_cycles = cpu->tick();
+	advance(cpu_cycles);
+	return cpu_cycles;
+}
+
+void Gameboy::advance(ClockCycles cpu_cycles) {
 	gpu->tick(cpu_cycles);
+	cycle_count += cpu_cycles;
+
+	measure_input_latency();
+}
+
+ClockCycles Gameboy::run_frame() {
+	// With the LCD off no frames are finished, so stop after a long frame's
+	// worth of cycles instead
+	auto frame = gpu->get_frame_count();
+	auto cycles = ClockCycles{0};
+	while (gpu->get_frame_count() == frame && cycles < 2 * CLOCKS_FRAME) {
+		cycles += step();
+	}
+	return cycles;
+}
+
+ClockCycles Gameboy::run_ahead(unsigned int frames, bool render) {
+	// Only the last frame run is drawn and passed on to the Video driver, so
+	// that it sees one frame each time as usual
+	auto start = std::chrono::steady_clock::now();
+	gpu->skip_current_frame(!render || frames > 0);
+	gpu->set_video_muted(frames > 0);
+	auto cycles = run_frame();
+	auto frame_end = std::chrono::steady_clock::now();
+
+	if (frames > 0) {
+		if (!run_ahead_state) {
+			run_ahead_state = std::make_unique<SaveState>();
+		}
+		save_state(*run_ahead_state);
+
+		// The frame shown is stamped as the first one, which is where the
+		// Gameboy really is, so that input is stamped against it
+		gpu->set_frame_stamp(
+		    FrameInfo{gpu->get_frame_count() - 1, cycle_count});
+		for (auto i = 1u; i <= frames; ++i) {
+			auto last = i == frames;
+			gpu->skip_current_frame(!render || !last);
+			gpu->set_video_muted(!last);
+			run_frame();
+		}
+		gpu->set_frame_stamp(std::nullopt);
+
+		// Going back to where the Gameboy really is skips no input, so
+		// events stay held until their stamp comes
+		auto flush = flush_inputs;
+		load_state(*run_ahead_state);
+		flush_inputs = flush;
+	}
+
+	run_ahead_frames++;
+	frame_time += frame_end - start;
+	run_ahead_time += std::chrono::steady_clock::now() - frame_end;
+	return cycles;
+}
+
+RunAheadStats Gameboy::get_run_ahead_stats() const {
+	if (run_ahead_frames == 0) {
+		return RunAheadStats{0, 0.0, 0.0};
+	}
+
+	auto to_us = [this](std::chrono::nanoseconds time) {
+		return std::chrono::duration<double, std::micro>(time).count() /
+		       run_ahead_frames;
+	};
+	return RunAheadStats{run_ahead_frames, to_us(frame_time),
+	                     to_us(run_ahead_time)};
+}
+
+uint64_t Gameboy::get_state_hash() const {
+	// A value initialized state has its padding zeroed, so the hash only
+	// depends on the fields
+	auto state = std::make_unique<SaveState>();
+	save_state(*state);
+	return hash_bytes(state.get(), offsetof(SaveState, frame));
+}
+
+void Gameboy::save_state(SaveState &state) const {
+	state.magic = SAVE_STATE_MAGIC;
+	state.version = SAVE_STATE_VERSION;
+	state.rom_checksum = cartridge->get_checksum();
+	state.cycle_count = cycle_count;
+	cpu->save_state(state.cpu);
+	gpu->save_state(state.gpu, state.frame);
+	controller->save_state(state.controller);
+	memory->save_state(state.memory);
+}
+
+bool Gameboy::load_state(const SaveState &state) {
+	if (state.magic != SAVE_STATE_MAGIC ||
+	    state.version != SAVE_STATE_VERSION) {
+		Log::error("Save state is from another version of tvp");
+		return false;
+	}
+	if (state.rom_checksum != cartridge->get_checksum()) {
+		Log::error("Save state is from another ROM");
+		return false;
+	}
+
+	cycle_count = state.cycle_count;
+	cpu->load_state(state.cpu);
+	gpu->load_state(state.gpu, state.frame);
+	controller->load_state(state.controller);
+	memory->load_state(state.memory);
+
+	// Input latency is measured from here on
+	frame_count = gpu->get_frame_count();
+	pending_inputs = 0;
+	pending_input_cycles = 0;
+	flush_inputs = true;
+	return true;
+}
+
+std::unique_ptr<Gameboy> Gameboy::fork(VideoFactory video_factory) const {
+	auto child = std::make_unique<Gameboy>(
+	    cartridge, std::move(video_factory), footprint);
+
+	// Everything but memory is small, so it is copied through the same state
+	// structures as a save state
+	auto cpu_state = CPUState();
+	cpu->save_state(cpu_state);
+	child->cpu->load_state(cpu_state);
+
+	auto gpu_state = GPUState();
+	auto frame_state = std::make_unique<GPUFrameState>();
+	gpu->save_state(gpu_state, *frame_state);
+	child->gpu->load_state(gpu_state, *frame_state);
+
+	auto controller_state = ControllerState();
+	controller->save_state(controller_state);
+	child->controller->load_state(controller_state);
+
+	child->memory->share_pages(*memory);
+	child->cycle_count = cycle_count;
+	child->reset_snapshot = reset_snapshot;
+	child->frame_count = child->gpu->get_frame_count();
+	return child;
+}
+
+bool Gameboy::reset(ResetMode mode) {
+	auto snapshot = mode == ResetMode::SNAPSHOT
+	                    ? reset_snapshot
+	                    : get_boot_snapshot(cartridge, mode);
+	if (!snapshot) {
+		if (mode == ResetMode::SNAPSHOT) {
+			Log::error("No snapshot has been set to reset to");
+		}
+		return false;
+	}
+	return load_state(*snapshot);
+}
+
+void Gameboy::skip_boot() {
+	// Everything that the boot ROM doesn't touch stays as it was at power on
+	auto state = std::make_unique<SaveState>();
+	save_state(*state);
+
+	// The registers of a DMG at 0x100. The last frame of the logo leaves its
+	// VBLANK interrupt pending.
+	auto &cpu_state = state->cpu;
+	cpu_state.a = 0x01;
+	cpu_state.f = 0xB0;
+	cpu_state.b = 0x00;
+	cpu_state.c = 0x13;
+	cpu_state.d = 0x00;
+	cpu_state.e = 0xD8;
+	cpu_state.h = 0x01;
+	cpu_state.l = 0x4D;
+	cpu_state.sp = 0xFFFE;
+	cpu_state.pc = 0x0100;
+	cpu_state.interrupt_flag = 0x01;
+
+	// The LCD is on with LCDC=0x91 and BGP=0xFC, and the boot ROM hands over
+	// part way through line 0x92 of the VBlank after the logo
+	auto &gpu_state = state->gpu;
+	gpu_state.registers[0x0] = 0x91;
+	gpu_state.registers[0x1] = 0x01;
+	gpu_state.registers[0x4] = 0x92;
+	gpu_state.registers[0x8] = 0xFC;
+	gpu_state.mode = GPUMode::VBLANK;
+	gpu_state.lcd_enabled = true;
+	gpu_state.current_cycles = 419;
+
+	// The logo in the cartridge header is scaled up to twice its size into
+	// tiles 1 to 24. Each nibble becomes two rows of a tile, with each bit
+	// doubled, in the first bit plane only.
+	auto &memory_state = state->memory;
+	auto tile = Address{0x8010};
+	for (auto address = Address{0x104}; address < 0x134; ++address) {
+		auto logo = memory->read(address);
+		for (auto nibble : {logo >> 4, logo & 0x0F}) {
+			auto row = uint8_t{0};
+			for (auto bit = 3; bit >= 0; --bit) {
+				row = static_cast<uint8_t>(row << 2) |
+				      (((nibble >> bit) & 1) ? 0x03 : 0x00);
+			}
+			memory_state[tile] = row;
+			memory_state[tile + 2] = row;
+			tile += 4;
+		}
+	}
+
+	// Tile 25 is the (R) mark, which is kept in the boot ROM itself
+	for (auto i = 0; i < 8; ++i) {
+		memory_state[0x8190 + 2 * i] = boot[0xD8 + i];
+	}
+
+	// The logo is two rows of 12 tiles in the middle of the background map,
+	// with the (R) mark at the end of the first
+	for (auto i = 0; i < 12; ++i) {
+		memory_state[0x9904 + i] = static_cast<uint8_t>(1 + i);
+		memory_state[0x9924 + i] = static_cast<uint8_t>(13 + i);
+	}
+	memory_state[0x9910] = 0x19;
+
+	// Sound registers set up for the chime, as written. There is no sound
+	// hardware, so they read back as written too.
+	memory_state[0xFF11] = 0x80;
+	memory_state[0xFF12] = 0xF3;
+	memory_state[0xFF13] = 0xC1;
+	memory_state[0xFF14] = 0x87;
+	memory_state[0xFF24] = 0x77;
+	memory_state[0xFF25] = 0xF3;
+	memory_state[0xFF26] = 0x80;
+
+	// What the boot ROM's calls leave below the stack
+	memory_state[0xFFFA] = 0x39;
+	memory_state[0xFFFB] = 0x01;
+	memory_state[0xFFFC] = 0x2E;
+
+	// The boot ROM is unmapped, so the cartridge shows through below 0x100
+	memory_state[0xFF50] = 0x01;
+
+	load_state(*state);
 }
 
+void Gameboy::set_reset_snapshot(std::shared_ptr<const SaveState> state) {
+	reset_snapshot = std::move(state);
+}
+
+void Gameboy::set_buttons(uint8_t mask) {
+	// The joypad interrupt fires when a button line goes low
+	if (mask & ~controller->get_buttons()) {
+		auto bit = static_cast<uint8_t>(Interrupt::JOYPAD);
+		cpu->get_interrupt_flag()->set_bit(bit, true);
+	}
+	controller->set_buttons(mask);
+}
+
+void Gameboy::apply_inputs(ClockCycles lookahead) {
+	auto held = controller->get_buttons();
+	while (auto event = inputs ? inputs->peek() : nullptr) {
+		if (event->cycle > cycle_count + lookahead && !flush_inputs) {
+			break;
+		}
+
+		if (event->pressed) {
+			controller->press_button(event->button);
+		} else {
+			controller->release_button(event->button);
+		}
+
+		// Flushed events may be stamped ahead of the loaded state
+		auto stamp = std::min(event->cycle, cycle_count);
+		if (pending_inputs == 0) {
+			oldest_input_cycle = stamp;
+		}
+		pending_inputs++;
+		pending_input_cycles += stamp;
+
+		inputs->pop();
+	}
+	flush_inputs = false;
+
+	// Only the buttons held once the events are in are pressed, the same as
+	// a movie records them, so a press and release together are dropped
+	auto buttons = controller->get_buttons();
+	controller->set_buttons(held);
+	set_buttons(buttons);
+}
+
+void Gameboy::measure_input_latency() {
+	auto frames = gpu->get_frame_count();
+	if (frames == frame_count) {
+		return;
+	}
+	frame_count = frames;
+
+	if (pending_inputs == 0) {
+		return;
+	}
+
+	// Every event applied since the last frame is first seen in this one
+	input_events += pending_inputs;
+	input_latency_total += pending_inputs * cycle_count - pending_input_cycles;
+	input_latency_max =
+	    std::max(input_latency_max, cycle_count - oldest_input_cycle);
+	pending_inputs = 0;
+	pending_input_cycles = 0;
+}
+
+InputLatency Gameboy::get_input_latency() const {
+	auto mean = input_events == 0
+	                ? 0.0
+	                : static_cast<double>(input_latency_total) / input_events;
+	return InputLatency{input_events, mean, input_latency_max};
+}
+
+uint64_t Gameboy::get_cycle_count() const { return cycle_count; }
+
 unique_ptr<CPU> Gameboy::create_cpu(Memory *memory_ptr) {
 	auto a = make_unique<Register>();
 	auto b = make_unique<Register>();
@@ -47,7 +457,8 @@ unique_ptr<CPU> Gameboy::create_cpu(Memory *memory_ptr) {
 }
 
 unique_ptr<GPU> Gameboy::create_gpu(Memory *memory_ptr, CPU *cpu_ptr,
-                                    Video *video_ptr) {
+                                    VideoInterface *video_ptr,
+                                    bool own_frame_buffer) {
 	auto lcdc = make_unique<cpu::Register>();
 	auto stat = make_unique<cpu::Register>();
 	auto scy = make_unique<cpu::Register>();
@@ -64,7 +475,7 @@ unique_ptr<GPU> Gameboy::create_gpu(Memory *memory_ptr, CPU *cpu_ptr,
 	return make_unique<GPU>(move(lcdc), move(stat), move(scy), move(scx),
 	                        move(ly), move(lyc), move(wy), move(wx), move(bgp),
 	                        move(obp0), move(obp1), move(dma), memory_ptr,
-	                        cpu_ptr, video_ptr);
+	                        cpu_ptr, video_ptr, own_frame_buffer);
 }
 
 } // namespace gameboy
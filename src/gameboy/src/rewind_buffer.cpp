@@ -0,0 +1,149 @@
+/**
+ * @file rewind_buffer.cpp
+ * Defines the RewindBuffer class
+ */
+
+#include "gameboy/rewind_buffer.h"
+#include "util/delta.h"
+
+namespace gameboy {
+
+/**
+ * View a save state as bytes
+ */
+static uint8_t *state_bytes(SaveState &state) {
+	return reinterpret_cast<uint8_t *>(&state);
+}
+
+static const uint8_t *state_bytes(const SaveState &state) {
+	return reinterpret_cast<const uint8_t *>(&state);
+}
+
+RewindBuffer::RewindBuffer(std::size_t budget)
+    : budget(budget), latest(std::make_unique<SaveState>()),
+      has_latest(false), used(0), stopping(false),
+      compressor([this] { compressor_loop(); }) {}
+
+RewindBuffer::~RewindBuffer() {
+	{
+		auto lock = std::unique_lock<std::mutex>(mutex);
+		stopping = true;
+	}
+	work_ready.notify_all();
+	compressor.join();
+}
+
+void RewindBuffer::push(const SaveState &state) {
+	// The newest state is only used on this thread, so the delta is taken
+	// without holding the lock
+	auto delta = std::shared_ptr<RewindDelta>();
+	if (has_latest) {
+		delta = std::make_shared<RewindDelta>();
+		delta->raw.resize(sizeof(SaveState));
+		xor_bytes(state_bytes(*latest), state_bytes(state), delta->raw.data(),
+		          sizeof(SaveState));
+	}
+	*latest = state;
+	has_latest = true;
+
+	if (delta) {
+		auto lock = std::unique_lock<std::mutex>(mutex);
+		used += delta->raw.size();
+		deltas.push_back(std::move(delta));
+		trim();
+		work_ready.notify_one();
+	}
+}
+
+bool RewindBuffer::pop(SaveState &state) {
+	if (!has_latest) {
+		return false;
+	}
+	state = *latest;
+
+	// Step the newest state back through the newest delta
+	auto lock = std::unique_lock<std::mutex>(mutex);
+	if (deltas.empty()) {
+		has_latest = false;
+		return true;
+	}
+
+	auto delta = std::move(deltas.back());
+	deltas.pop_back();
+	delta->dropped = true;
+
+	if (!delta->raw.empty()) {
+		xor_bytes(state_bytes(*latest), delta->raw.data(),
+		          state_bytes(*latest), sizeof(SaveState));
+		used -= delta->raw.size();
+	} else {
+		apply_delta(delta->compressed, state_bytes(*latest),
+		            sizeof(SaveState));
+		used -= delta->compressed.size();
+	}
+	return true;
+}
+
+std::size_t RewindBuffer::get_size() {
+	auto lock = std::unique_lock<std::mutex>(mutex);
+	return deltas.size() + (has_latest ? 1 : 0);
+}
+
+std::size_t RewindBuffer::get_used() {
+	auto lock = std::unique_lock<std::mutex>(mutex);
+	return used;
+}
+
+std::shared_ptr<RewindDelta> RewindBuffer::next_raw_delta() const {
+	// Deltas are compressed in order, so the raw ones are all at the end
+	auto next = std::shared_ptr<RewindDelta>();
+	for (auto it = deltas.rbegin(); it != deltas.rend() && !(*it)->raw.empty();
+	     ++it) {
+		next = *it;
+	}
+	return next;
+}
+
+void RewindBuffer::trim() {
+	while (used > budget && !deltas.empty()) {
+		auto &oldest = deltas.front();
+		used -= oldest->raw.size() + oldest->compressed.size();
+		oldest->dropped = true;
+		deltas.pop_front();
+	}
+}
+
+void RewindBuffer::compressor_loop() {
+	auto lock = std::unique_lock<std::mutex>(mutex);
+	auto compressed = std::vector<uint8_t>();
+
+	while (true) {
+		auto delta = std::shared_ptr<RewindDelta>();
+		work_ready.wait(lock, [&] {
+			delta = next_raw_delta();
+			return stopping || delta;
+		});
+
+		if (stopping) {
+			return;
+		}
+
+		// The raw delta is never changed while it is in the history, so it
+		// can be read without the lock
+		lock.unlock();
+		compress_delta(delta->raw.data(), delta->raw.size(), compressed);
+		lock.lock();
+
+		// It may have been rewound past or trimmed in the meantime
+		if (delta->dropped) {
+			continue;
+		}
+
+		used -= delta->raw.size();
+		used += compressed.size();
+		delta->compressed = compressed;
+		delta->raw = std::vector<uint8_t>();
+	}
+}
+
+} // namespace gameboy
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #pragma once
@@ -210,19 +211,98 @@ class GPU : public GPUInterface {
 	 */
 	cpu::ClockCycles current_cycles;
 
+	/**
+	 * True if the LCD was switched on as of the last tick. While the display
+	 * is disabled through LCDC, the GPU sits idle and does no work at all, so
+	 * this is used to detect the on/off transitions.
+	 */
+	bool lcd_enabled;
+
+	/**
+	 * Set if rendering was turned off through set_skip_render
+	 */
+	bool skip_render;
+
+	/**
+	 * True if the current frame is being drawn. This is latched from
+	 * skip_render at the start of every frame, so frames are never only
+	 * partly drawn.
+	 */
+	bool render_frame;
+
+	/**
+	 * Set if finished frames are kept from the Video driver
+	 */
+	bool video_muted;
+
+	/**
+	 * Frame number and cycles given to the Video driver for finished frames
+	 * in place of their own, if set
+	 */
+	std::optional<FrameInfo> frame_stamp;
+
+	/**
+	 * Number of frames finished so far, including skipped frames
+	 */
+	uint64_t frame_count;
+
+	/**
+	 * Total number of clock cycles that the GPU has been ticked for
+	 */
+	uint64_t cycle_count;
+
+	/**
+	 * Hash of the last frame sent to the Video driver, used to tell if a new
+	 * frame is any different. It describes what the driver has, so loading a
+	 * state leaves it alone.
+	 */
+	uint64_t last_frame_hash;
+
 	/**
 	 * Video Buffer
 	 * This is a 2D array that contains the complete contents of the current
 	 * frame to be drawn. This will be sent to the Video driver every frame to
-	 * be painted on to the screen.
+	 * be painted on to the screen. It is null if the GPU was built without a
+	 * buffer of its own.
+	 */
+	std::unique_ptr<VideoBuffer> v_buffer;
+
+	/**
+	 * Buffer that frames are drawn into. This is v_buffer, unless another
+	 * render target has been set. With neither, nothing is drawn.
 	 */
-	VideoBuffer v_buffer;
+	VideoBuffer *frame_buffer;
+
+	/**
+	 * Send the finished frame to the Video driver. If it is the same as the
+	 * previous frame, the driver is only told to repeat it, which saves
+	 * copying and uploading it.
+	 */
+	void present_frame();
+
+	/**
+	 * Get the frame number and timestamp for a frame that was just finished,
+	 * and count it
+	 */
+	FrameInfo finish_frame();
 
 	/**
 	 * Set the mode and the LCD Status register bits to match
 	 */
 	void change_mode(GPUMode mode);
 
+	/**
+	 * Put the GPU into its idle state when the LCD is switched off. LY is held
+	 * at 0, and a blank frame is sent to the Video driver once.
+	 */
+	void disable_lcd();
+
+	/**
+	 * Resynchronize the GPU when the LCD is switched back on, so that the
+	 * frame starts again from the first scanline
+	 */
+	void enable_lcd();
+
 	/**
 	 * Fire a particular interrupt. Set the corresponding bit in the CPU
 	 * interrupt flag register
@@ -230,14 +310,15 @@ class GPU : public GPUInterface {
 	void fire_interrupt(cpu::Interrupt interrupt);
 
 	/**
-	 * Get's the Sprite details from the OAM, given the start address
+	 * Get's the Sprite details from the OAM, given the sprite's index in it
 	 */
-	OAMEntry get_oam_from_memory(Address address);
+	OAMEntry get_oam_from_memory(OAMSpan oam, uint8_t index);
 
 	/**
-	 * Get tile data from memory, given the tile number
+	 * Get tile data from VRAM, given the tile number
 	 */
-	Tile get_tile_from_memory(uint8_t tile_number, bool sprite = false);
+	Tile get_tile_from_memory(VRAMSpan vram, uint8_t tile_number,
+	                          bool sprite = false);
 
 	/**
 	 * Convert the given internal color value to a pixel color using the given
@@ -262,6 +343,11 @@ class GPU : public GPUInterface {
 	void write_sprites();
 
   public:
+	/**
+	 * The last parameter, own_frame_buffer, may be false to leave out the
+	 * GPU's own frame buffer. Frames are then only drawn while a render
+	 * target is set, and are otherwise run as if skipped.
+	 */
 	GPU(std::unique_ptr<cpu::IReg> lcdc, std::unique_ptr<cpu::IReg> stat,
 	    std::unique_ptr<cpu::IReg> scy, std::unique_ptr<cpu::IReg> scx,
 	    std::unique_ptr<cpu::IReg> ly, std::unique_ptr<cpu::IReg> lyc,
@@ -269,13 +355,77 @@ class GPU : public GPUInterface {
 	    std::unique_ptr<cpu::IReg> bgp, std::unique_ptr<cpu::IReg> obp0,
 	    std::unique_ptr<cpu::IReg> obp1, std::unique_ptr<cpu::IReg> dma,
 	    memory::MemoryInterface *memory, cpu::CPUInterface *cpu,
-	    video::VideoInterface *video);
+	    video::VideoInterface *video, bool own_frame_buffer = true);
 
 	/**
 	 * @see GPUInterface#tick
 	 */
 	void tick(cpu::ClockCycles cycles) override;
 
+	/**
+	 * @see GPUInterface#set_skip_render
+	 */
+	void set_skip_render(bool skip) override;
+
+	/**
+	 * Turn rendering on or off for the frame in progress, instead of from the
+	 * next one like set_skip_render. This is meant for the start of a frame,
+	 * since lines that are already drawn are left as they are.
+	 *
+	 * @param skip True to skip the rest of the frame
+	 */
+	void skip_current_frame(bool skip);
+
+	/**
+	 * Keep finished frames from the Video driver altogether, not even
+	 * telling it to repeat the last one. This is for frames that are run and
+	 * then undone, which must not show up in recordings.
+	 *
+	 * @param muted True to keep frames from the driver
+	 */
+	void set_video_muted(bool muted);
+
+	/**
+	 * Give the Video driver this frame number and cycle count for finished
+	 * frames, instead of their own. Run-ahead shows frames from the future,
+	 * and input must still be stamped against the cycle really emulated.
+	 *
+	 * @param stamp Info to give, or std::nullopt to give the frames' own
+	 */
+	void set_frame_stamp(std::optional<FrameInfo> stamp);
+
+	/**
+	 * Draw frames straight into a buffer owned by the caller, instead of the
+	 * GPU's own. Lines are drawn into it as the frame goes, so it only holds
+	 * a whole frame once the frame is finished. It must stay alive until it
+	 * is replaced.
+	 *
+	 * @param target Buffer to draw into, or nullptr for the GPU's own buffer,
+	 * if it has one
+	 */
+	void set_render_target(VideoBuffer *target);
+
+	/**
+	 * Get the number of frames finished so far, including skipped frames
+	 */
+	uint64_t get_frame_count() const;
+
+	/**
+	 * Copy the registers, mode and the frame being drawn
+	 *
+	 * @param state State to fill in
+	 * @param frame Frame state to fill in
+	 */
+	void save_state(GPUState &state, GPUFrameState &frame) const;
+
+	/**
+	 * Put the GPU back into a state made by save_state
+	 *
+	 * @param state State to restore
+	 * @param frame Frame state to restore
+	 */
+	void load_state(const GPUState &state, const GPUFrameState &frame);
+
 	/// Getters for Registers
 	/// Simply return a pointer so that Memory can manipulate these values with
 	/// easily, as each register corresponds to a memory location
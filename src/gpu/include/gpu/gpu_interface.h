@@ -22,6 +22,13 @@ class GPUInterface {
 	 */
 	virtual void tick(cpu::ClockCycles cycles) = 0;
 
+	/**
+	 * Turn off rendering, starting from the next frame. Skipped frames are
+	 * still emulated, with the same timing and interrupts, but no pixels are
+	 * drawn and the Video driver is told to repeat the last frame.
+	 */
+	virtual void set_skip_render(bool skip) = 0;
+
 	/// Getters for the 12 GPU registers
 	virtual cpu::IReg *get_lcdc() = 0;
 	virtual cpu::IReg *get_stat() = 0;
@@ -43,11 +43,71 @@ const int BG_HEIGHT = 256;
  */
 using VideoBuffer = std::array<Pixel, PIXEL_COUNT>;
 
+/**
+ * Identifies a frame produced by the GPU, and when it was finished
+ */
+struct FrameInfo {
+	/**
+	 * Number of frames produced before this one
+	 */
+	uint64_t number;
+
+	/**
+	 * Number of clock cycles emulated by the GPU when the frame was finished
+	 */
+	uint64_t cycles;
+};
+
 /**
  * Modes of the GPU frame cycle
  */
 enum class GPUMode { OAM, VRAM, HBLANK, VBLANK };
 
+/**
+ * Registers, mode and counters of the GPU, as plain data
+ */
+struct GPUState {
+	/**
+	 * LCDC, STAT, SCY, SCX, LY, LYC, WY, WX, BGP, OBP0, OBP1 and DMA, in the
+	 * order that they are mapped to memory, skipping the unused 0xFF4C
+	 */
+	std::array<uint8_t, 12> registers;
+
+	/**
+	 * Current mode, and whether the LCD was on as of the last tick
+	 */
+	GPUMode mode;
+	bool lcd_enabled;
+
+	/**
+	 * Cycles spent in the current mode
+	 */
+	cpu::ClockCycles current_cycles;
+
+	/**
+	 * Number of frames finished, and cycles ticked in total
+	 */
+	uint64_t frame_count;
+	uint64_t cycle_count;
+};
+
+/**
+ * The frame that the GPU is part way through drawing. It is kept apart from
+ * the GPUState because it only depends on what has been drawn, and doesn't
+ * change how emulation carries on.
+ */
+struct GPUFrameState {
+	/**
+	 * Whether the current frame is being drawn
+	 */
+	bool render_frame;
+
+	/**
+	 * The frame being drawn
+	 */
+	VideoBuffer v_buffer;
+};
+
 /**
  * Constants for number of clock Cycles in each stage of the GPU frame cycle
  * Steps :
@@ -133,6 +193,5 @@ const std::array<Address, 2> TILE_SET_ADDRS = {0x8800, 0x8000};
 const std::array<Address, 2> TILE_MAP_ADDRS = {0x9800, 0x9C00};
 
 const uint8_t OAM_ENTRY_SIZE = 4;
-const Address OAM_START_ADDR = 0xFE00;
 
 } // namespace gpu
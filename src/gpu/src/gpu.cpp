@@ -7,6 +7,7 @@
 #include "gpu/utils.h"
 #include "memory/utils.h"
 
+#include "util/hash.h"
 #include "util/helpers.h"
 #include "util/log.h"
 
@@ -19,15 +20,35 @@ GPU::GPU(std::unique_ptr<cpu::IReg> lcdc, std::unique_ptr<cpu::IReg> stat,
          std::unique_ptr<cpu::IReg> bgp, std::unique_ptr<cpu::IReg> obp0,
          std::unique_ptr<cpu::IReg> obp1, std::unique_ptr<cpu::IReg> dma,
          memory::MemoryInterface *memory, cpu::CPUInterface *cpu,
-         video::VideoInterface *video)
+         video::VideoInterface *video, bool own_frame_buffer)
     : lcdc(std::move(lcdc)), stat(std::move(stat)), scy(std::move(scy)),
       scx(std::move(scx)), ly(std::move(ly)), lyc(std::move(lyc)),
       wy(std::move(wy)), wx(std::move(wx)), bgp(std::move(bgp)),
       obp0(std::move(obp0)), obp1(std::move(obp1)), dma(std::move(dma)),
       memory(memory), cpu(cpu), video(video), mode(GPUMode::OAM),
-      current_cycles(0), v_buffer({}) {}
+      current_cycles(0), lcd_enabled(true), skip_render(false),
+      render_frame(true), video_muted(false), frame_count(0), cycle_count(0),
+      last_frame_hash(0),
+      v_buffer(own_frame_buffer ? std::make_unique<VideoBuffer>() : nullptr),
+      frame_buffer(v_buffer.get()) {}
 
 void GPU::tick(cpu::ClockCycles cycles_elapsed) {
+	cycle_count += cycles_elapsed;
+
+	// Games switch the LCD off for long VRAM uploads and loading screens. The
+	// GPU has nothing to do in that state, so skip the mode machine entirely
+	// and resync when the display is turned on again.
+	if (!lcdc->get_bit(lcdc_flag::DISPLAY_ENABLE)) {
+		if (lcd_enabled) {
+			disable_lcd();
+		}
+		return;
+	}
+
+	if (!lcd_enabled) {
+		enable_lcd();
+	}
+
 	// Increment local cycle count
 	current_cycles += cycles_elapsed;
 
@@ -82,7 +103,9 @@ void GPU::tick(cpu::ClockCycles cycles_elapsed) {
 		if (current_cycles >= CLOCKS_HBLANK) {
 			current_cycles -= CLOCKS_HBLANK;
 
-			write_line();
+			if (render_frame && frame_buffer) {
+				write_line();
+			}
 
 			// We've completed the HBLANK and this scanline. Increment line_y
 			(*ly)++;
@@ -108,8 +131,16 @@ void GPU::tick(cpu::ClockCycles cycles_elapsed) {
 			(*ly)++;
 
 			if (ly->get() == 154) {
-				write_sprites();
-				video->paint(v_buffer);
+				if (video_muted) {
+					finish_frame();
+				} else if (render_frame && frame_buffer) {
+					write_sprites();
+					present_frame();
+				} else {
+					video->repeat(finish_frame());
+				}
+
+				render_frame = !skip_render;
 				ly->set(0);
 				change_mode(GPUMode::OAM);
 			}
@@ -118,6 +149,86 @@ void GPU::tick(cpu::ClockCycles cycles_elapsed) {
 	};
 }
 
+void GPU::set_skip_render(bool skip) { skip_render = skip; }
+
+void GPU::skip_current_frame(bool skip) {
+	skip_render = skip;
+	render_frame = !skip;
+}
+
+void GPU::set_video_muted(bool muted) { video_muted = muted; }
+
+void GPU::set_frame_stamp(std::optional<FrameInfo> stamp) {
+	frame_stamp = stamp;
+}
+
+void GPU::set_render_target(VideoBuffer *target) {
+	frame_buffer = target != nullptr ? target : v_buffer.get();
+}
+
+uint64_t GPU::get_frame_count() const { return frame_count; }
+
+void GPU::save_state(GPUState &state, GPUFrameState &frame) const {
+	state.registers = {lcdc->get(), stat->get(), scy->get(),  scx->get(),
+	                   ly->get(),   lyc->get(),  wy->get(),   wx->get(),
+	                   bgp->get(),  obp0->get(), obp1->get(), dma->get()};
+	state.mode = mode;
+	state.lcd_enabled = lcd_enabled;
+	state.current_cycles = current_cycles;
+	state.frame_count = frame_count;
+	state.cycle_count = cycle_count;
+
+	frame.render_frame = render_frame;
+	if (frame_buffer) {
+		frame.v_buffer = *frame_buffer;
+	} else {
+		frame.v_buffer.fill(Pixel::ZERO);
+	}
+}
+
+void GPU::load_state(const GPUState &state, const GPUFrameState &frame) {
+	auto registers = {lcdc.get(), stat.get(), scy.get(),  scx.get(),
+	                  ly.get(),   lyc.get(),  wy.get(),   wx.get(),
+	                  bgp.get(),  obp0.get(), obp1.get(), dma.get()};
+	auto value = state.registers.begin();
+	for (auto reg : registers) {
+		reg->set(*value++);
+	}
+
+	mode = state.mode;
+	lcd_enabled = state.lcd_enabled;
+	current_cycles = state.current_cycles;
+	frame_count = state.frame_count;
+	cycle_count = state.cycle_count;
+
+	render_frame = frame.render_frame;
+	if (frame_buffer) {
+		*frame_buffer = frame.v_buffer;
+	}
+}
+
+void GPU::present_frame() {
+	auto info = finish_frame();
+	if (!frame_buffer) {
+		video->repeat(info);
+		return;
+	}
+
+	auto hash = hash_bytes(frame_buffer->data(), frame_buffer->size());
+	if (hash == last_frame_hash) {
+		video->repeat(info);
+		return;
+	}
+
+	last_frame_hash = hash;
+	video->paint(*frame_buffer, info);
+}
+
+FrameInfo GPU::finish_frame() {
+	auto info = FrameInfo{frame_count++, cycle_count};
+	return frame_stamp ? *frame_stamp : info;
+}
+
 void GPU::write_line() {
 	// Write background information to buffer
 	write_bg_line();
@@ -134,6 +245,10 @@ void GPU::write_bg_line() {
 	auto tile_map_addr = TILE_MAP_ADDRS[tile_map_index];
 	auto tile_set_addr = TILE_SET_ADDRS[tile_set_index];
 
+	// Tile maps and tile data both live in VRAM, so all fetches for this line
+	// are plain indexed loads from the VRAM view
+	auto vram = memory->get_vram();
+
 	// i represents the ith pixel of this scanline
 	for (int i = 0; i < SCREEN_WIDTH; ++i) {
 		// Let's find where this pixel is in the complete BG map
@@ -152,24 +267,26 @@ void GPU::write_bg_line() {
 
 		// Fetch the tile number from the tile map in memory
 		auto tile_addr = tile_map_addr + tile_index_abs;
-		auto tile_num = memory->read(tile_addr);
+		auto tile_num = vram[tile_addr - VRAM_START];
 
 		// If the tile set has been shifted to the second index, we need to
-		// shift the index from which we pull the tile's bytes as well
+		// shift the index from which we pull the tile's bytes as well. The
+		// shifted tile number wraps around, since the tile number is treated
+		// as signed in this mode
 		auto tile_shift = uint8_t{0};
 		if (tile_set_index == 0) {
 			tile_shift = 128;
 		}
 
 		// Find the addr of this tile and the specific line to be drawn
-		auto tile_offset = (tile_num + tile_shift) * TILE_SIZE;
+		auto tile_index = static_cast<uint8_t>(tile_num + tile_shift);
+		auto tile_offset = tile_index * TILE_SIZE;
 		auto tile_start_addr = tile_set_addr + tile_offset;
-		auto tile_line_index = tile_start_addr + (2 * tile_index_y);
+		auto tile_line_index =
+		    tile_start_addr + (2 * tile_index_y) - VRAM_START;
 
-		auto pix_data_high =
-		    static_cast<uint16_t>(memory->read(tile_line_index));
-		auto pix_data_low =
-		    static_cast<uint16_t>(memory->read(tile_line_index + 1));
+		auto pix_data_high = static_cast<uint16_t>(vram[tile_line_index]);
+		auto pix_data_low = static_cast<uint16_t>(vram[tile_line_index + 1]);
 
 		auto reverse_index_x = 7 - tile_index_x;
 		bool first = pix_data_high & (1 << reverse_index_x);
@@ -178,18 +295,20 @@ void GPU::write_bg_line() {
 
 		auto real_pixel = get_pixel_from_palette(gb_pixel, bgp.get());
 
-		v_buffer[current_line * SCREEN_WIDTH + i] = real_pixel;
+		(*frame_buffer)[current_line * SCREEN_WIDTH + i] = real_pixel;
 	}
 }
 
 void GPU::write_sprites() {
+	// Sprite attributes live in OAM and their tiles in VRAM
+	auto oam_data = memory->get_oam();
+	auto vram = memory->get_vram();
 
 	// For all 40 sprites in OAM...
 	for (int i = 0; i < 40; ++i) {
 
 		// Get the current sprite OAM info from memory
-		auto curr_addr = OAM_START_ADDR + (i * OAM_ENTRY_SIZE);
-		auto oam = get_oam_from_memory(curr_addr);
+		auto oam = get_oam_from_memory(oam_data, i);
 
 		// Top-left corner points are easier to work with
 		auto sprite_x = oam.pos_x - 8;
@@ -213,7 +332,7 @@ void GPU::write_sprites() {
 		auto palette_reg = oam.palette ? obp1.get() : obp0.get();
 
 		// Load this tile from memory (sprite = true)
-		auto tile = get_tile_from_memory(oam.tile_number, true);
+		auto tile = get_tile_from_memory(vram, oam.tile_number, true);
 
 		// Draw the 8x8 or 8x16 pixel by copying the right pixels from the
 		// tileset to the screen, from the rectangular tile of addresses
@@ -234,13 +353,13 @@ void GPU::write_sprites() {
 				auto pixel_y = sprite_y + rel_y;
 
 				// Bounds checks
-				if (pixel_x < 0 || pixel_x > SCREEN_WIDTH)
+				if (pixel_x < 0 || pixel_x >= SCREEN_WIDTH)
 					continue;
-				if (pixel_y < 0 || pixel_y > SCREEN_HEIGHT)
+				if (pixel_y < 0 || pixel_y >= SCREEN_HEIGHT)
 					continue;
 
 				// Draw pixel
-				v_buffer[pixel_y * SCREEN_WIDTH + pixel_x] = real_pixel;
+				(*frame_buffer)[pixel_y * SCREEN_WIDTH + pixel_x] = real_pixel;
 			}
 		}
 	}
@@ -289,22 +408,49 @@ void GPU::change_mode(GPUMode new_mode) {
 	}
 }
 
+void GPU::disable_lcd() {
+	lcd_enabled = false;
+
+	// With the LCD off, LY stays at 0 and the STAT mode bits read as HBLANK
+	current_cycles = 0;
+	ly->set(0);
+	change_mode(GPUMode::HBLANK);
+
+	// The screen goes blank. Paint it once here, since no more frames will be
+	// produced until the LCD is switched back on.
+	if (frame_buffer) {
+		frame_buffer->fill(Pixel::ZERO);
+	}
+	present_frame();
+}
+
+void GPU::enable_lcd() {
+	lcd_enabled = true;
+
+	// The display restarts from the OAM search of the first scanline
+	render_frame = !skip_render;
+	current_cycles = 0;
+	ly->set(0);
+	change_mode(GPUMode::OAM);
+}
+
 void GPU::fire_interrupt(cpu::Interrupt interrupt) {
 	// The interrupt enum value corresponds to the bit number
 	auto bit_number = static_cast<uint8_t>(interrupt);
 	cpu->get_interrupt_flag()->set_bit(bit_number, true);
 }
 
-OAMEntry GPU::get_oam_from_memory(Address address) {
+OAMEntry GPU::get_oam_from_memory(OAMSpan oam, uint8_t index) {
 	auto entry = OAMEntry{};
+	auto offset = index * OAM_ENTRY_SIZE;
 
 	// Read the first three bytes
-	entry.pos_y = memory->read(address);
-	entry.pos_x = memory->read(address + 1);
-	entry.tile_number = memory->read(address + 2);
+	entry.pos_y = oam[offset];
+	entry.pos_x = oam[offset + 1];
+	entry.tile_number = oam[offset + 2];
 
 	// Use fourth byte to set flags
-	auto flags = memory->read(address + 3);
+	auto flags = oam[offset + 3];
 	entry.priority = flags & (1 << oam_flag::BG_PRIORITY);
 	entry.flip_x = flags & (1 << oam_flag::FLIP_X);
 	entry.flip_y = flags & (1 << oam_flag::FLIP_Y);
@@ -313,7 +459,8 @@ OAMEntry GPU::get_oam_from_memory(Address address) {
 	return entry;
 }
 
-Tile GPU::get_tile_from_memory(uint8_t tile_number, bool sprite) {
+Tile GPU::get_tile_from_memory(VRAMSpan vram, uint8_t tile_number,
+                               bool sprite) {
 	// Check for double height sprites if a sprite is requested
 	auto size_multiplier = 1;
 	if (sprite && lcdc->get_bit(lcdc_flag::SPRITE_SIZE)) {
@@ -329,7 +476,7 @@ Tile GPU::get_tile_from_memory(uint8_t tile_number, bool sprite) {
 	auto tile_size = TILE_SIZE * size_multiplier;
 	auto tile_offset = tile_size * tile_number;
 
-	Address tile_start = tile_set_addr + tile_offset;
+	auto tile_start = tile_set_addr + tile_offset - VRAM_START;
 
 	// Tile Data is stored by composing the two bytes in each line of the 8x8
 	// (or 16x8) tile. For example, the first line in a tile image (where the
@@ -352,11 +499,11 @@ Tile GPU::get_tile_from_memory(uint8_t tile_number, bool sprite) {
 	for (int line = 0; line < tile_height; ++line) {
 		// Each line has two bytes
 		auto line_index = 2 * line;
-		Address line_start = tile_start + line_index;
+		auto line_start = tile_start + line_index;
 
 		// Read these two bytes
-		auto lower = memory->read(line_start);
-		auto higher = memory->read(line_start + 1);
+		auto lower = vram[line_start];
+		auto higher = vram[line_start + 1];
 
 		// Convert line bytes into colors
 		for (int i = 0; i < 8; ++i) {
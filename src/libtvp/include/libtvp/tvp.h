@@ -0,0 +1,206 @@
+/**
+ * @file tvp.h
+ * Declares the C API of libtvp, for embedding the emulator in other programs
+ * and loading it from other languages.
+ *
+ * Everything is plain C: an opaque handle, fixed size integers and buffers
+ * owned by the caller. There are no callbacks, so it can be used through
+ * Python's ctypes or any other FFI. Once a Gameboy is created, running frames
+ * and reading the screen never allocate memory.
+ *
+ * A handle may be used from any thread, but only from one at a time.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(TVP_BUILDING)
+#define TVP_API __declspec(dllexport)
+#else
+#define TVP_API __declspec(dllimport)
+#endif
+#else
+#define TVP_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Version of this API, raised whenever a function changes in a way that
+ * breaks existing callers
+ */
+#define TVP_API_VERSION 1
+
+/**
+ * Size of the screen in pixels. A frame is TVP_SCREEN_HEIGHT rows of
+ * TVP_SCREEN_WIDTH pixels, one byte each.
+ */
+#define TVP_SCREEN_WIDTH 160
+#define TVP_SCREEN_HEIGHT 144
+
+/**
+ * Buttons, to be combined into a mask for tvp_set_buttons
+ */
+#define TVP_BUTTON_RIGHT 0x01
+#define TVP_BUTTON_LEFT 0x02
+#define TVP_BUTTON_UP 0x04
+#define TVP_BUTTON_DOWN 0x08
+#define TVP_BUTTON_A 0x10
+#define TVP_BUTTON_B 0x20
+#define TVP_BUTTON_SELECT 0x40
+#define TVP_BUTTON_START 0x80
+
+/**
+ * Flags for tvp_create. TVP_SKIP_BOOT starts the game straight away, in the
+ * state that the boot ROM would leave it in.
+ */
+#define TVP_SKIP_BOOT 0x01
+
+/**
+ * A running Gameboy
+ */
+typedef struct tvp_gameboy tvp_gameboy;
+
+/**
+ * A change to a watched address during a frame
+ */
+typedef struct tvp_memory_change {
+	/**
+	 * The address that changed
+	 */
+	uint16_t address;
+
+	/**
+	 * Value before the frame, and after it
+	 */
+	uint8_t old_value;
+	uint8_t new_value;
+} tvp_memory_change;
+
+/**
+ * Get the version of the API that the library was built with, to check it
+ * against TVP_API_VERSION
+ */
+TVP_API uint32_t tvp_api_version(void);
+
+/**
+ * Create a Gameboy playing a ROM. The ROM is copied, so the buffer may be
+ * freed once this returns.
+ *
+ * @param rom The whole ROM
+ * @param rom_size Size of the ROM in bytes, at least 32KB
+ * @param flags TVP_SKIP_BOOT, or 0
+ * @return The Gameboy, or NULL if the ROM is too small or memory ran out
+ */
+TVP_API tvp_gameboy *tvp_create(const uint8_t *rom, size_t rom_size,
+                                uint32_t flags);
+
+/**
+ * Destroy a Gameboy. Pointers returned by tvp_get_frame become invalid.
+ *
+ * @param gameboy Gameboy to destroy, or NULL to do nothing
+ */
+TVP_API void tvp_destroy(tvp_gameboy *gameboy);
+
+/**
+ * Run a frame
+ *
+ * @return Number of clock cycles run
+ */
+TVP_API uint64_t tvp_run_frame(tvp_gameboy *gameboy);
+
+/**
+ * Get the screen, which is drawn in place as frames run, without copying.
+ * Each pixel is a shade from 0, the lightest, to 3, the darkest. The pointer
+ * stays the same for the life of the Gameboy.
+ */
+TVP_API const uint8_t *tvp_get_frame(const tvp_gameboy *gameboy);
+
+/**
+ * Set which buttons are held, from the next frame on
+ *
+ * @param buttons Mask of TVP_BUTTON_ values
+ */
+TVP_API void tvp_set_buttons(tvp_gameboy *gameboy, uint8_t buttons);
+
+/**
+ * Get the number of bytes that a save state takes
+ */
+TVP_API size_t tvp_state_size(void);
+
+/**
+ * Save the whole state of a Gameboy into the caller's buffer. States only fit
+ * the same build of the library.
+ *
+ * @param buffer Where to save the state
+ * @param size Size of the buffer, at least tvp_state_size()
+ * @return 1 if the state was saved, or 0 if the buffer is too small
+ */
+TVP_API int tvp_save_state(tvp_gameboy *gameboy, void *buffer, size_t size);
+
+/**
+ * Load a state saved by tvp_save_state
+ *
+ * @param buffer The state
+ * @param size Size of the buffer, at least tvp_state_size()
+ * @return 1 if the state was loaded, or 0 if the buffer is too small or the
+ * state is from another ROM or build, in which case nothing is changed
+ */
+TVP_API int tvp_load_state(tvp_gameboy *gameboy, const void *buffer,
+                           size_t size);
+
+/**
+ * Read a byte from the Gameboy's address space, as the CPU would see it
+ */
+TVP_API uint8_t tvp_read_memory(const tvp_gameboy *gameboy, uint16_t address);
+
+/**
+ * Write a byte to the Gameboy's address space, as the CPU would write it, so
+ * writing to a register has the same effect as it would for the game. Writes
+ * to ROM are ignored.
+ */
+TVP_API void tvp_write_memory(tvp_gameboy *gameboy, uint16_t address,
+                              uint8_t value);
+
+/**
+ * Watch for writes to a range of RAM, such as where a game keeps its score,
+ * so that the changes can be read after each frame with
+ * tvp_get_memory_changes. Writes are checked as the game makes them, and
+ * only on the 256 byte pages that hold watched addresses.
+ *
+ * @param start First address, from 0xC000 up
+ * @param end Last address, up to 0xFFFE
+ */
+TVP_API void tvp_watch_memory(tvp_gameboy *gameboy, uint16_t start,
+                              uint16_t end);
+
+/**
+ * Stop watching every address
+ */
+TVP_API void tvp_clear_memory_watches(tvp_gameboy *gameboy);
+
+/**
+ * Get the watched addresses that changed during the last frame. Each address
+ * is listed once, in the order they first changed, however many times it was
+ * written. One written back to where it started is still listed.
+ *
+ * @param count Where to put the number of changes
+ * @return The changes, which stay valid until the next frame is run
+ */
+TVP_API const tvp_memory_change *
+tvp_get_memory_changes(const tvp_gameboy *gameboy, size_t *count);
+
+/**
+ * Get the number of clock cycles run since the Gameboy was created. Loading a
+ * state sets it back to the count the state was saved at.
+ */
+TVP_API uint64_t tvp_get_cycle_count(const tvp_gameboy *gameboy);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file tvp.cpp
+ * Defines the C API of libtvp
+ */
+
+#include "libtvp/tvp.h"
+
+#include "gameboy/gameboy.h"
+#include "gameboy/save_state.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+static_assert(sizeof(gpu::Pixel) == 1 &&
+                  sizeof(gpu::VideoBuffer) ==
+                      TVP_SCREEN_WIDTH * TVP_SCREEN_HEIGHT,
+              "tvp_get_frame hands out the VideoBuffer as bytes");
+static_assert(sizeof(tvp_memory_change) == sizeof(memory::MemoryChange) &&
+                  offsetof(tvp_memory_change, address) ==
+                      offsetof(memory::MemoryChange, address) &&
+                  offsetof(tvp_memory_change, old_value) ==
+                      offsetof(memory::MemoryChange, old_value) &&
+                  offsetof(tvp_memory_change, new_value) ==
+                      offsetof(memory::MemoryChange, new_value),
+              "tvp_get_memory_changes hands out MemoryChanges as they are");
+
+/**
+ * A Gameboy behind the C API. It has no frame buffer or Video driver, and
+ * draws every frame into one kept here, which callers read in place.
+ */
+struct tvp_gameboy {
+	/**
+	 * The Gameboy
+	 */
+	std::unique_ptr<gameboy::Gameboy> gameboy;
+
+	/**
+	 * The screen, which the GPU draws into
+	 */
+	gpu::VideoBuffer frame;
+
+	/**
+	 * State to save into and load from when the caller's buffer is not
+	 * aligned for a SaveState. Only allocated once needed.
+	 */
+	std::unique_ptr<gameboy::SaveState> scratch_state;
+};
+
+/**
+ * Get a state to save into or load from, which is the caller's buffer if it
+ * is aligned for a SaveState, or else the scratch state
+ *
+ * @return The state, or nullptr if the scratch state could not be allocated
+ */
+static gameboy::SaveState *get_state_buffer(tvp_gameboy *instance,
+                                            const void *buffer) {
+	auto address = reinterpret_cast<std::uintptr_t>(buffer);
+	if (address % alignof(gameboy::SaveState) == 0) {
+		return static_cast<gameboy::SaveState *>(const_cast<void *>(buffer));
+	}
+	if (!instance->scratch_state) {
+		instance->scratch_state.reset(new (std::nothrow) gameboy::SaveState());
+	}
+	return instance->scratch_state.get();
+}
+
+uint32_t tvp_api_version(void) { return TVP_API_VERSION; }
+
+tvp_gameboy *tvp_create(const uint8_t *rom, size_t rom_size, uint32_t flags) {
+	// Without a memory bank controller the whole of 0x0000 to 0x7FFF is read
+	// straight from the ROM
+	if (rom == nullptr || rom_size < 0x8000) {
+		return nullptr;
+	}
+
+	// No exception may cross into C
+	try {
+		auto instance = std::make_unique<tvp_gameboy>();
+		auto cartridge = std::make_shared<cartridge::Cartridge>(
+		    std::vector<uint8_t>(rom, rom + rom_size));
+		instance->gameboy = std::make_unique<gameboy::Gameboy>(
+		    cartridge, nullptr, gameboy::Footprint::MINIMAL);
+		instance->gameboy->gpu->set_video_muted(true);
+		instance->gameboy->gpu->set_render_target(&instance->frame);
+		instance->frame.fill(gpu::Pixel::ZERO);
+		if (flags & TVP_SKIP_BOOT) {
+			instance->gameboy->skip_boot();
+		}
+		return instance.release();
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void tvp_destroy(tvp_gameboy *instance) { delete instance; }
+
+uint64_t tvp_run_frame(tvp_gameboy *instance) {
+	instance->gameboy->memory->clear_changes();
+	return instance->gameboy->run_frame();
+}
+
+const uint8_t *tvp_get_frame(const tvp_gameboy *instance) {
+	return reinterpret_cast<const uint8_t *>(instance->frame.data());
+}
+
+void tvp_set_buttons(tvp_gameboy *instance, uint8_t buttons) {
+	instance->gameboy->set_buttons(buttons);
+}
+
+size_t tvp_state_size(void) { return sizeof(gameboy::SaveState); }
+
+int tvp_save_state(tvp_gameboy *instance, void *buffer, size_t size) {
+	if (buffer == nullptr || size < sizeof(gameboy::SaveState)) {
+		return 0;
+	}
+
+	// The state is value initialized first, so that its padding is zeroed
+	// and equal states save to equal bytes
+	auto state = get_state_buffer(instance, buffer);
+	if (state == nullptr) {
+		return 0;
+	}
+	state = new (state) gameboy::SaveState();
+	instance->gameboy->save_state(*state);
+	if (state != buffer) {
+		std::memcpy(buffer, state, sizeof(gameboy::SaveState));
+	}
+	return 1;
+}
+
+int tvp_load_state(tvp_gameboy *instance, const void *buffer, size_t size) {
+	if (buffer == nullptr || size < sizeof(gameboy::SaveState)) {
+		return 0;
+	}
+
+	auto state = get_state_buffer(instance, buffer);
+	if (state == nullptr) {
+		return 0;
+	}
+	if (state != buffer) {
+		std::memcpy(state, buffer, sizeof(gameboy::SaveState));
+	}
+	return instance->gameboy->load_state(*state) ? 1 : 0;
+}
+
+uint8_t tvp_read_memory(const tvp_gameboy *instance, uint16_t address) {
+	return instance->gameboy->memory->read(address);
+}
+
+void tvp_write_memory(tvp_gameboy *instance, uint16_t address, uint8_t value) {
+	instance->gameboy->memory->write(address, value);
+}
+
+void tvp_watch_memory(tvp_gameboy *instance, uint16_t start, uint16_t end) {
+	instance->gameboy->memory->watch_range(start, end);
+}
+
+void tvp_clear_memory_watches(tvp_gameboy *instance) {
+	instance->gameboy->memory->clear_watches();
+}
+
+const tvp_memory_change *tvp_get_memory_changes(const tvp_gameboy *instance,
+                                                size_t *count) {
+	auto &changes = instance->gameboy->memory->get_changes();
+	*count = changes.size();
+	return reinterpret_cast<const tvp_memory_change *>(changes.data());
+}
+
+uint64_t tvp_get_cycle_count(const tvp_gameboy *instance) {
+	return instance->gameboy->get_cycle_count();
+}
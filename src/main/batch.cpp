@@ -0,0 +1,322 @@
+/**
+ * @file batch.cpp
+ * Main entrypoint for the tvp-batch executable, which runs many headless
+ * sessions at once
+ */
+
+#include "controller/movie.h"
+#include "gameboy/gameboy.h"
+#include "util/hash.h"
+#include "util/work_stealing_pool.h"
+#include "video/buffer_video.h"
+
+#include <cxxopts.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+
+using namespace std;
+using namespace gpu;
+using namespace video;
+using namespace gameboy;
+using namespace cartridge;
+using namespace controller;
+
+/**
+ * One session to run, from a line of the job list
+ */
+struct Job {
+	/**
+	 * Path to the ROM
+	 */
+	string rom_path;
+
+	/**
+	 * Path to a .tvpm movie to play, or empty to hold no buttons
+	 */
+	string movie_path;
+
+	/**
+	 * Number of frames to run, or 0 to run for the length of the movie
+	 */
+	uint64_t frames;
+
+	/**
+	 * Where to write the final hashes, or empty to not write them
+	 */
+	string output_path;
+};
+
+/**
+ * What came of running a Job
+ */
+struct JobResult {
+	/**
+	 * Why the job failed, or empty if it didn't
+	 */
+	string error;
+
+	/**
+	 * Frames run, and how long they took in seconds
+	 */
+	uint64_t frames = 0;
+	double seconds = 0.0;
+
+	/**
+	 * State hash and frame hash at the end of the job
+	 */
+	uint64_t state_hash = 0;
+	uint64_t frame_hash = 0;
+
+	/**
+	 * Thread that ran the job, and whether it reused that thread's Gameboy
+	 */
+	size_t worker = 0;
+	bool reused = false;
+};
+
+/**
+ * A Gameboy kept by each thread, so that jobs for the same ROM don't each
+ * build a new one
+ */
+struct WorkerInstance {
+	/**
+	 * ROM that the Gameboy was built for
+	 */
+	string rom_path;
+
+	/**
+	 * The Gameboy and its video driver
+	 */
+	unique_ptr<Gameboy> gameboy;
+	BufferVideo *video = nullptr;
+
+	/**
+	 * State of the Gameboy when it was built, loaded before each job
+	 */
+	unique_ptr<SaveState> initial_state;
+};
+
+/**
+ * Read a job list. Each line is a ROM path, a movie path or "-", a frame
+ * count, and an output path or "-". Blank lines and lines starting with #
+ * are skipped.
+ */
+static optional<vector<Job>> read_jobs(const string &path) {
+	auto file = ifstream(path);
+	if (!file) {
+		cout << "Could not open job list " << path << endl;
+		return nullopt;
+	}
+
+	auto jobs = vector<Job>();
+	auto line = string();
+	for (auto number = 1; getline(file, line); ++number) {
+		auto fields = istringstream(line);
+		auto job = Job();
+		if (!(fields >> job.rom_path) || job.rom_path[0] == '#') {
+			continue;
+		}
+
+		auto extra = string();
+		if (!(fields >> job.movie_path >> job.frames >> job.output_path) ||
+		    fields >> extra) {
+			cout << path << ":" << number
+			     << ": expected a ROM, a movie, a frame count and an output"
+			     << endl;
+			return nullopt;
+		}
+		if (job.movie_path == "-") {
+			job.movie_path.clear();
+		}
+		if (job.output_path == "-") {
+			job.output_path.clear();
+		}
+		if (job.movie_path.empty() && job.frames == 0) {
+			cout << path << ":" << number
+			     << ": a job without a movie needs a frame count" << endl;
+			return nullopt;
+		}
+		if (!ifstream(job.rom_path)) {
+			cout << path << ":" << number << ": could not open ROM "
+			     << job.rom_path << endl;
+			return nullopt;
+		}
+		jobs.push_back(job);
+	}
+	return jobs;
+}
+
+/**
+ * Get the worker's Gameboy ready for a job, from the state that it was built
+ * in
+ */
+static void prepare_instance(WorkerInstance &instance, const Job &job,
+                             const map<string, shared_ptr<Cartridge>> &roms,
+                             JobResult &result) {
+	if (instance.gameboy && instance.rom_path == job.rom_path) {
+		instance.gameboy->load_state(*instance.initial_state);
+		result.reused = true;
+		return;
+	}
+
+	auto video_factory = [&](InputQueue *, CartridgeMetadata *) {
+		auto driver = make_unique<BufferVideo>();
+		instance.video = driver.get();
+		return unique_ptr<VideoInterface>(move(driver));
+	};
+	instance.rom_path = job.rom_path;
+	instance.gameboy =
+	    make_unique<Gameboy>(roms.at(job.rom_path), video_factory);
+	if (!instance.initial_state) {
+		instance.initial_state = make_unique<SaveState>();
+	}
+	instance.gameboy->save_state(*instance.initial_state);
+}
+
+/**
+ * Run a job on the worker's Gameboy
+ */
+static JobResult run_job(const Job &job, WorkerInstance &instance,
+                         const map<string, shared_ptr<Cartridge>> &roms) {
+	auto result = JobResult();
+	auto movie = optional<InputMovie>();
+	if (!job.movie_path.empty()) {
+		movie = InputMovie::load(job.movie_path);
+		if (!movie) {
+			result.error = "could not read movie " + job.movie_path;
+			return result;
+		}
+	}
+
+	prepare_instance(instance, job, roms, result);
+	auto &gameboy = instance.gameboy;
+	if (movie &&
+	    movie->get_rom_checksum() != gameboy->cartridge->get_checksum()) {
+		result.error = "movie was recorded with a different ROM";
+		return result;
+	}
+
+	// Buttons are let go once the movie runs out. Only the last frames are
+	// drawn, so that the final frame can be checked.
+	auto frames = job.frames > 0 ? job.frames : movie->get_frame_count();
+	auto start = chrono::steady_clock::now();
+	for (auto frame = uint64_t{0}; frame < frames; ++frame) {
+		auto buttons = uint8_t{0};
+		if (movie && frame < movie->get_frame_count()) {
+			buttons = movie->get_frame(frame);
+		}
+		gameboy->gpu->set_skip_render(frame + 2 < frames);
+		gameboy->set_buttons(buttons);
+		gameboy->run_frame();
+	}
+	result.seconds =
+	    chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	result.frames = frames;
+
+	auto &buffer = instance.video->get_buffer();
+	result.state_hash = gameboy->get_state_hash();
+	result.frame_hash = hash_bytes(buffer.data(), buffer.size());
+
+	if (!job.output_path.empty()) {
+		auto output = ofstream(job.output_path);
+		output << hex << result.state_hash << " " << result.frame_hash << endl;
+		if (!output) {
+			result.error = "could not write " + job.output_path;
+		}
+	}
+	return result;
+}
+
+int main(int argc, char *argv[]) {
+	ios_base::sync_with_stdio(false);
+	Log::Disable();
+
+	auto cmdline_args_parser = cxxopts::Options(
+	    "tvp-batch", "Runs many headless GameBoy sessions across all cores");
+
+	// clang-format off
+	cmdline_args_parser.add_options()
+		("j,jobs", "Path to the job list - REQUIRED. Each line is a ROM, a "
+			".tvpm movie or \"-\", a frame count (0 for the movie's length) "
+			"and a file to write the final hashes to or \"-\"",
+			cxxopts::value<string>())
+		("t,threads", "Number of threads, 0 for one per core",
+			cxxopts::value<unsigned int>()->default_value("0"))
+		("h,help", "Print this information");
+	// clang-format on
+
+	auto parsed_args = cmdline_args_parser.parse(argc, argv);
+	if (parsed_args["help"].as<bool>()) {
+		cout << cmdline_args_parser.help();
+		exit(0);
+	}
+
+	auto jobs_path = string();
+	try {
+		jobs_path = parsed_args["jobs"].as<string>();
+	} catch (exception &e) {
+		cout << cmdline_args_parser.help();
+		exit(1);
+	}
+
+	auto jobs = read_jobs(jobs_path);
+	if (!jobs) {
+		exit(1);
+	}
+
+	// Each ROM is loaded once, and shared by every Gameboy that plays it
+	auto roms = map<string, shared_ptr<Cartridge>>();
+	for (auto &job : *jobs) {
+		if (!roms.count(job.rom_path)) {
+			roms[job.rom_path] = make_shared<Cartridge>(job.rom_path);
+		}
+	}
+
+	auto pool = WorkStealingPool(parsed_args["threads"].as<unsigned int>());
+	auto instances = vector<WorkerInstance>(pool.get_thread_count());
+	auto results = vector<JobResult>(jobs->size());
+
+	auto start = chrono::steady_clock::now();
+	pool.run(jobs->size(), [&](size_t index, size_t worker) {
+		results[index] = run_job((*jobs)[index], instances[worker], roms);
+		results[index].worker = worker;
+	});
+	auto elapsed =
+	    chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	auto total_frames = uint64_t{0};
+	auto failed = 0;
+	auto reused = 0;
+	for (auto index = size_t{0}; index < results.size(); ++index) {
+		auto &job = (*jobs)[index];
+		auto &result = results[index];
+		cout << "Job " << index + 1 << " (" << job.rom_path << "): ";
+		if (!result.error.empty()) {
+			cout << "failed, " << result.error << endl;
+			failed++;
+			continue;
+		}
+
+		total_frames += result.frames;
+		reused += result.reused ? 1 : 0;
+		cout << result.frames << " frames in " << result.seconds << "s ("
+		     << result.frames / result.seconds << " fps) on thread "
+		     << result.worker << ", final state hash " << hex
+		     << result.state_hash << ", frame hash " << result.frame_hash
+		     << dec << endl;
+	}
+
+	cout << "Ran " << results.size() - failed << " of " << results.size()
+	     << " jobs on " << pool.get_thread_count() << " threads in " << elapsed
+	     << "s: " << total_frames << " frames, " << total_frames / elapsed
+	     << " fps in total" << endl;
+	cout << "Jobs that reused a Gameboy: " << reused
+	     << ", jobs stolen by another thread: " << pool.get_steal_count()
+	     << endl;
+
+	return failed > 0 ? 1 : 0;
+}
@@ -3,12 +3,28 @@
  * Main entrypoint for the tvp executable
  */
 
+#include "controller/movie.h"
 #include "debugger/cli_debugger.h"
 #include "debugger/debugger_core.h"
 #include "gameboy/gameboy.h"
+#include "gameboy/rewind_buffer.h"
+#include "util/frame_pacer.h"
+#include "util/frame_skipper.h"
+#include "util/hash.h"
+#include "video/buffer_video.h"
+#include "video/recording_video.h"
+#include "video/shared_memory_video.h"
+#include "video/threaded_video.h"
+#include "video/video.h"
 
 #include <cxxopts.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+
 using namespace std;
 using namespace cpu;
 using namespace gpu;
@@ -33,6 +49,37 @@ int main(int argc, char *argv[]) {
 			cxxopts::value<string>())
 		("d,debug", "Enable the debugger",
 			cxxopts::value<bool>()->default_value("false"))
+		("headless", "Run without a window, as fast as possible",
+			cxxopts::value<bool>()->default_value("false"))
+		("f,frames", "Number of frames to run when headless, 0 to never stop",
+			cxxopts::value<uint64_t>()->default_value("0"))
+		("scaler", "Upscaler: none, nearest, scale2x or scale3x",
+			cxxopts::value<string>()->default_value("none"))
+		("scale", "Window size, as a multiple of the GameBoy screen",
+			cxxopts::value<unsigned int>()->default_value("3"))
+		("frameskip", "Frames to skip after each drawn frame, or \"auto\" to "
+			"skip while running behind",
+			cxxopts::value<string>()->default_value("0"))
+		("record", "Record video to a .y4m, .rgba or .tvpv file",
+			cxxopts::value<string>()->default_value(""))
+		("shm-frames", "Publish frames to POSIX shared memory with this name",
+			cxxopts::value<string>()->default_value(""))
+		("record-input", "Record the buttons held on every frame in the "
+			"window to a .tvpm movie",
+			cxxopts::value<string>()->default_value(""))
+		("play-input", "Play back a .tvpm movie without a window, as fast as "
+			"possible",
+			cxxopts::value<string>()->default_value(""))
+		("rewind", "Memory for the rewind history in MB, 0 to turn it off. "
+			"Hold R to rewind",
+			cxxopts::value<unsigned int>()->default_value("0"))
+		("rewind-interval", "Frames between each state in the rewind history",
+			cxxopts::value<unsigned int>()->default_value("4"))
+		("run-ahead", "Frames to run ahead of the input, to hide the lag "
+			"of games",
+			cxxopts::value<unsigned int>()->default_value("0"))
+		("skip-boot", "Start the game at once, without the boot ROM's logo",
+			cxxopts::value<bool>()->default_value("false"))
 		("h,help", "Print this information");
 	// clang-format on
 
@@ -54,25 +101,311 @@ int main(int argc, char *argv[]) {
 		exit(1);
 	}
 
+	// Pick the video driver. Headless runs keep frames in memory instead of
+	// opening an SFML window, and never wait on the display. Otherwise, frames
+	// are handed to the window on the main thread.
+	auto headless = parsed_args["headless"].as<bool>();
+	auto max_frames = parsed_args["frames"].as<uint64_t>();
+
+	// Movies are played back headless and unthrottled, since nobody needs to
+	// watch them. The debugger steps on its own, so it can't take part.
+	auto record_input_path = parsed_args["record-input"].as<string>();
+	auto play_input_path = parsed_args["play-input"].as<string>();
+	auto play_movie = optional<InputMovie>();
+	if (!record_input_path.empty() || !play_input_path.empty()) {
+		if (parsed_args["debug"].as<bool>()) {
+			cout << "Input movies can't be used with the debugger" << endl;
+			exit(1);
+		}
+	}
+	if (!play_input_path.empty()) {
+		play_movie = InputMovie::load(play_input_path);
+		if (!play_movie) {
+			cout << "Could not read movie " << play_input_path << endl;
+			exit(1);
+		}
+		headless = true;
+	}
+
+	// Headless runs have no input, so a recording would hold no buttons
+	if (!record_input_path.empty() && headless) {
+		cout << "Input can only be recorded from the window" << endl;
+		exit(1);
+	}
+
+	// Rewinding is only done from the window. It would break up a movie, so
+	// the two can't be used together.
+	auto rewind_size = size_t{parsed_args["rewind"].as<unsigned int>()} << 20;
+	auto rewind_interval =
+	    max(parsed_args["rewind-interval"].as<unsigned int>(), 1u);
+	if (rewind_size > 0 && !record_input_path.empty()) {
+		cout << "Rewinding can't be used while recording a movie" << endl;
+		exit(1);
+	}
+
+	// Running ahead is undone every frame, so it works with everything else
+	auto run_ahead = parsed_args["run-ahead"].as<unsigned int>();
+	auto print_run_ahead_stats = [&](Gameboy *gameboy) {
+		auto stats = gameboy->get_run_ahead_stats();
+		if (run_ahead == 0 || stats.frames == 0) {
+			return;
+		}
+		cout << "Run-ahead of " << run_ahead << " frames: " << stats.frame_us
+		     << "us per frame, plus " << stats.run_ahead_us
+		     << "us running ahead ("
+		     << 100.0 * stats.run_ahead_us / stats.frame_us << "% more)"
+		     << endl;
+	};
+
+	auto scaler_type = get_scaler_type(parsed_args["scaler"].as<string>());
+	auto scale = max(parsed_args["scale"].as<unsigned int>(), 1u);
+	if (!scaler_type) {
+		cout << cmdline_args_parser.help();
+		exit(1);
+	}
+
+	auto frameskip = parsed_args["frameskip"].as<string>();
+	auto frame_skipper = FrameSkipper();
+	try {
+		frame_skipper = frameskip == "auto"
+		                    ? FrameSkipper(0, true)
+		                    : FrameSkipper(stoul(frameskip), false);
+	} catch (exception &e) {
+		cout << cmdline_args_parser.help();
+		exit(1);
+	}
+
+	// Recording and shared memory wrap whichever driver is picked, and pass
+	// frames on to it
+	auto shm_name = parsed_args["shm-frames"].as<string>();
+	auto record_path = parsed_args["record"].as<string>();
+	auto record_format = optional<RecordFormat>();
+	if (!record_path.empty()) {
+		record_format = get_record_format(record_path);
+		if (!record_format) {
+			cout << "Recordings must be .y4m, .rgba or .tvpv files" << endl;
+			exit(1);
+		}
+	}
+
+	// The pacer keeps the emulation thread to real time when there is a
+	// window, and input from the window is stamped with its speed
+	auto pacer = FramePacer(CLOCK_SPEED);
+	BufferVideo *buffer_video = nullptr;
+	ThreadedVideo *threaded_video = nullptr;
+	auto video_factory = [&](InputQueue *inputs, CartridgeMetadata *) {
+		auto video = unique_ptr<VideoInterface>();
+		if (headless) {
+			auto driver = make_unique<BufferVideo>();
+			buffer_video = driver.get();
+			video = move(driver);
+		} else {
+			auto driver = make_unique<ThreadedVideo>(inputs, &pacer);
+			threaded_video = driver.get();
+			video = move(driver);
+		}
+
+		if (record_format) {
+			auto recorder = make_unique<RecordingVideo>(
+			    move(video), record_path, *record_format);
+			if (!recorder->is_open()) {
+				cout << "Could not open " << record_path << endl;
+				exit(1);
+			}
+			video = move(recorder);
+		}
+
+		if (!shm_name.empty()) {
+			auto shared = make_unique<SharedMemoryVideo>(move(video), shm_name);
+			if (!shared->is_open()) {
+				cout << "Could not create shared memory " << shm_name << endl;
+				exit(1);
+			}
+			video = move(shared);
+		}
+
+		return video;
+	};
+
 	// Create main gameboy instance
-	auto gameboy = make_unique<Gameboy>(rom_path);
+	auto gameboy = make_unique<Gameboy>(rom_path, video_factory);
+	auto cartridge_metadata = gameboy->cartridge->get_metadata();
+	if (parsed_args["skip-boot"].as<bool>()) {
+		gameboy->skip_boot();
+	}
 
-	// Turn on debugging if needed
-	auto debugger_on = parsed_args["debug"].as<bool>();
-	if (not debugger_on) {
-		// Start GameBoy normally
-		for (auto i = 0; /*Infinite Loop*/; i++) {
-			gameboy->tick();
+	// Movies start from the state that the ROM was loaded in
+	auto rom_checksum = gameboy->cartridge->get_checksum();
+	auto movie = InputMovie(rom_checksum, gameboy->get_state_hash());
+	auto recording_input = !record_input_path.empty();
+	if (play_movie) {
+		if (play_movie->get_rom_checksum() != rom_checksum) {
+			cout << "The movie was recorded with a different ROM" << endl;
+			exit(1);
 		}
-	} else {
-		// Start GameBoy with DebuggerCore
+		if (play_movie->get_initial_state_hash() !=
+		    movie.get_initial_state_hash()) {
+			cout << "Warning: the movie starts from a different state, and "
+			        "may not play back the same"
+			     << endl;
+		}
+	}
+
+	// Turn on debugging if needed. The debugger takes over the gameboy
+	auto debugger_on = parsed_args["debug"].as<bool>();
+	auto cli_debugger = unique_ptr<CliDebugger>();
+	if (debugger_on) {
 		auto debugger_core = std::make_unique<DebuggerCore>(std::move(gameboy));
-		auto cli_debugger =
-		    std::make_unique<CliDebugger>(std::move(debugger_core));
+		cli_debugger = std::make_unique<CliDebugger>(std::move(debugger_core));
 		Log::info("tvp DebuggerCore Started");
+	}
+
+	if (play_movie) {
+		// Hold the buttons from the movie for each frame. The last frames are
+		// always drawn, so that the final frame can be checked.
+		auto frames = play_movie->get_frame_count();
+		auto start = chrono::steady_clock::now();
+		for (auto frame = size_t{0}; frame < frames; ++frame) {
+			auto render =
+			    frame + 2 >= frames || frame_skipper.should_render(true);
+			gameboy->gpu->set_skip_render(!render);
+			gameboy->set_buttons(play_movie->get_frame(frame));
+			gameboy->run_frame();
+		}
+
+		auto elapsed = chrono::duration<double>(chrono::steady_clock::now() -
+		                                        start)
+		                   .count();
+		auto real_time = static_cast<double>(frames) * CLOCKS_FRAME /
+		                 CLOCK_SPEED;
+		auto &buffer = buffer_video->get_buffer();
+		cout << "Played " << frames << " frames in " << elapsed << "s ("
+		     << frames / elapsed << " fps, " << real_time / elapsed
+		     << "x real time)" << endl;
+		cout << "Final state hash " << hex << gameboy->get_state_hash()
+		     << ", frame hash " << hash_bytes(buffer.data(), buffer.size())
+		     << dec << endl;
+	} else if (headless and not debugger_on) {
+		// Run unthrottled until the requested number of frames is done. This
+		// is always behind real time, as far as frame skipping is concerned.
+		auto start = chrono::steady_clock::now();
+		for (auto frame = uint64_t{0}; max_frames == 0 || frame < max_frames;
+		     ++frame) {
+			auto render = frame_skipper.should_render(true);
+			gameboy->apply_inputs();
+			gameboy->run_ahead(run_ahead, render);
+		}
+
+		auto elapsed = chrono::duration<double>(chrono::steady_clock::now() -
+		                                        start)
+		                   .count();
+		cout << "Ran " << max_frames << " frames in " << elapsed << "s ("
+		     << max_frames / elapsed << " fps)" << endl;
+		print_run_ahead_stats(gameboy.get());
+	} else if (headless) {
 		for (auto i = 0; /*Infinite Loop*/; i++) {
 			cli_debugger->tick();
 		}
+	} else {
+		// The emulator runs on its own thread, so that it never waits on the
+		// display. The pacer keeps it to real time after every frame's worth
+		// of clock cycles.
+		auto running = atomic<bool>(true);
+
+		// States are pushed to the rewind history every few frames
+		auto rewind = unique_ptr<RewindBuffer>();
+		auto rewind_state = make_unique<SaveState>();
+		auto rewound = false;
+		auto frames_since_state = 0u;
+		if (rewind_size > 0 && !debugger_on) {
+			rewind = make_unique<RewindBuffer>(rewind_size);
+		}
+
+		// The debugger waits for commands on this thread too, but only for a
+		// short while at a time, so that it sees when the window is closed
+		auto emulation_thread = thread([&] {
+			while (running) {
+				if (debugger_on) {
+					cli_debugger->poll(chrono::milliseconds(100));
+					continue;
+				}
+
+				auto render = frame_skipper.should_render(pacer.is_late());
+				gameboy->gpu->set_skip_render(!render);
+
+				// While rewinding, step back through the history and show
+				// each state for a frame. Once the history runs out, the
+				// oldest state is held.
+				if (rewind && threaded_video->is_rewinding()) {
+					if (rewind->pop(*rewind_state) || rewound) {
+						gameboy->load_state(*rewind_state);
+						rewound = true;
+					}
+					pacer.pace(gameboy->run_frame());
+					continue;
+				}
+				rewound = false;
+
+				// A movie holds the buttons for whole frames, and running
+				// ahead goes a whole frame at a time, so input is only taken
+				// between frames for either
+				auto cycles = ClockCycles{0};
+				if (recording_input || run_ahead > 0) {
+					gameboy->apply_inputs(CLOCKS_FRAME);
+					if (recording_input) {
+						movie.add_frame(gameboy->controller->get_buttons());
+					}
+					cycles = gameboy->run_ahead(run_ahead, render);
+				} else {
+					while (cycles < CLOCKS_FRAME) {
+						cycles += gameboy->tick();
+					}
+				}
+
+				if (rewind && ++frames_since_state >= rewind_interval) {
+					gameboy->save_state(*rewind_state);
+					rewind->push(*rewind_state);
+					frames_since_state = 0;
+				}
+
+				pacer.pace(cycles);
+			}
+		});
+
+		// The main thread owns the window, and runs until it is closed
+		auto window = Video(threaded_video, &pacer, cartridge_metadata,
+		                    *scaler_type, scale);
+		while (window.is_open()) {
+			window.present();
+		}
+
+		running = false;
+		if (debugger_on) {
+			cli_debugger->stop();
+		}
+		emulation_thread.join();
+
+		auto stats = pacer.get_stats();
+		cout << "Frame pacing error: mean " << stats.mean_error_us
+		     << "us, 99th percentile " << stats.p99_error_us << "us" << endl;
+
+		if (!debugger_on) {
+			auto latency = gameboy->get_input_latency();
+			cout << "Input to frame latency over " << latency.events
+			     << " events: mean " << latency.mean_cycles << " cycles, max "
+			     << latency.max_cycles << " cycles" << endl;
+			print_run_ahead_stats(gameboy.get());
+		}
+	}
+
+	if (recording_input) {
+		if (!movie.save(record_input_path)) {
+			cout << "Could not write movie " << record_input_path << endl;
+			return 1;
+		}
+		cout << "Recorded " << movie.get_frame_count() << " frames to "
+		     << record_input_path << ", final state hash " << hex
+		     << gameboy->get_state_hash() << dec << endl;
 	}
 
 	return 0;
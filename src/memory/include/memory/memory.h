@@ -10,12 +10,15 @@
 #include "cpu/cpu_interface.h"
 #include "gpu/gpu_interface.h"
 #include "memory/memory_interface.h"
+#include "memory/memory_watch.h"
+#include "memory/shared_page.h"
 
 #include "debugger/debugger.fwd.h"
 
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace memory {
 
@@ -44,10 +47,28 @@ namespace memory {
 class Memory : public MemoryInterface {
   private:
 	/**
-	 * Main memory array - the GameBoy can address 65536 total bytes of memory
-	 * Not all of these wll be used, as most will be mapped to other devices
+	 * Main memory - the GameBoy can address 65536 total bytes of memory
+	 * Not all of these wll be used, as most will be mapped to other devices.
+	 * It is split into pages that are shared with forks until written to.
 	 */
-	std::array<uint8_t, 0x10000> memory;
+	std::array<SharedPage<MEMORY_PAGE_SIZE>, MEMORY_PAGE_COUNT> pages;
+
+	/**
+	 * Video RAM, kept as one page since the GPU reads it as one block. The
+	 * pages over its addresses are never used.
+	 */
+	SharedPage<VRAM_SIZE> vram;
+
+	/**
+	 * Changes to watched addresses, or null if nothing is watched
+	 */
+	std::unique_ptr<MemoryWatch> watch;
+
+	/**
+	 * Bit mask of the pages that hold watched addresses, so that writes to
+	 * other pages are not checked any further
+	 */
+	uint64_t watched_pages;
 
 	/**
 	 * Pointer to cartridge instance
@@ -74,6 +95,17 @@ class Memory : public MemoryInterface {
 	 */
 	void dma_transfer(uint8_t offset);
 
+	/**
+	 * Read a byte from the page that holds it
+	 */
+	uint8_t get_byte(Address address) const;
+
+	/**
+	 * Write a byte to the page that holds it, copying the page first if it is
+	 * shared
+	 */
+	void set_byte(Address address, uint8_t data);
+
   public:
 	/**
 	 * Default Constructor
@@ -90,6 +122,16 @@ class Memory : public MemoryInterface {
 	 */
 	void write(Address address, uint8_t data) override;
 
+	/**
+	 * @see MemoryInterface#get_vram
+	 */
+	VRAMSpan get_vram() const override;
+
+	/**
+	 * @see MemoryInterface#get_oam
+	 */
+	OAMSpan get_oam() const override;
+
 	/**
 	 * Set the CPU Object pointer for this class
 	 */
@@ -100,6 +142,62 @@ class Memory : public MemoryInterface {
 	 */
 	void set_gpu(gpu::GPUInterface *gpu) override;
 
+	/**
+	 * Copy the contents of memory. Registers owned by other devices are left
+	 * to them.
+	 *
+	 * @param state State to fill in
+	 */
+	void save_state(MemoryState &state) const;
+
+	/**
+	 * Put memory back to the contents saved by save_state
+	 *
+	 * @param state State to restore
+	 */
+	void load_state(const MemoryState &state);
+
+	/**
+	 * Take on the contents of another Memory by sharing its pages. Nothing is
+	 * copied until one of them writes to a page. The other Memory must not be
+	 * running on another thread while this is called.
+	 *
+	 * @param other Memory to share pages with
+	 */
+	void share_pages(const Memory &other);
+
+	/**
+	 * Get the number of bytes in pages that aren't shared with anything else
+	 */
+	std::size_t get_private_bytes() const;
+
+	/**
+	 * Watch for writes to a range of RAM, from Work RAM up to High RAM. Each
+	 * address that a write changes is noted, along with its old and new
+	 * value, until the changes are cleared. Writes are only checked on pages
+	 * of memory that hold watched addresses. Loading a state or sharing pages
+	 * is not a write. Echo RAM is watched as the Work RAM it mirrors.
+	 *
+	 * @param start First address, from MEMORY_PAGED_START up
+	 * @param end Last address, up to 0xFFFE
+	 */
+	void watch_range(Address start, Address end);
+
+	/**
+	 * Stop watching every address, and forget the changes
+	 */
+	void clear_watches();
+
+	/**
+	 * Get the changes to watched addresses since they were last cleared
+	 */
+	const std::vector<MemoryChange> &get_changes() const;
+
+	/**
+	 * Forget the changes so far, such as at the start of each frame
+	 */
+	void clear_changes();
+
 	/**
 	 * Allow debugger to view private members of this class
 	 */
@@ -35,6 +35,22 @@ class MemoryInterface {
 	 */
 	virtual void write(Address address, uint8_t data) = 0;
 
+	/**
+	 * Get a view over the VRAM ($8000 - $9FFF), for devices that need to read
+	 * tile data in bulk without going through the memory map
+	 *
+	 * @return Read-only span over the VRAM bytes
+	 */
+	virtual VRAMSpan get_vram() const = 0;
+
+	/**
+	 * Get a view over the OAM ($FE00 - $FE9F), for devices that need to read
+	 * sprite attributes in bulk without going through the memory map
+	 *
+	 * @return Read-only span over the OAM bytes
+	 */
+	virtual OAMSpan get_oam() const = 0;
+
 	/**
 	 * Set the CPU Object pointer for this class
 	 */
@@ -0,0 +1,95 @@
+/**
+ * @file memory_watch.h
+ * Declares the MemoryWatch class, which notes writes to watched addresses
+ */
+
+#pragma once
+
+#include "memory/utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace memory {
+
+/**
+ * A change to a watched address. It is 4 bytes with no padding, so a list of
+ * changes can be read as a plain array from other languages.
+ */
+struct MemoryChange {
+	/**
+	 * The address that changed
+	 */
+	uint16_t address;
+
+	/**
+	 * Value before the first write since changes were cleared, and after the
+	 * last one
+	 */
+	uint8_t old_value;
+	uint8_t new_value;
+};
+
+static_assert(sizeof(MemoryChange) == 4, "MemoryChange must not be padded");
+
+/**
+ * Keeps the changes made to watched addresses in paged memory, for Memory.
+ *
+ * Each address is listed at most once, however many times it is written, so
+ * the list never grows past the number of watched addresses. Room for that
+ * many is reserved as addresses are watched, so noting a change never
+ * allocates.
+ */
+class MemoryWatch {
+  private:
+	/**
+	 * What each address from MEMORY_PAGED_START up is doing: 0 if it is not
+	 * watched, 1 if it is watched and has not changed, or 2 plus the index of
+	 * its change
+	 */
+	std::vector<uint16_t> slots;
+
+	/**
+	 * Changes since they were last cleared, in the order that each address
+	 * first changed
+	 */
+	std::vector<MemoryChange> changes;
+
+	/**
+	 * Number of addresses watched
+	 */
+	std::size_t watched_count;
+
+  public:
+	MemoryWatch();
+
+	/**
+	 * Watch a range of addresses in paged memory
+	 *
+	 * @param start First address, at least MEMORY_PAGED_START
+	 * @param end Last address
+	 */
+	void add(Address start, Address end);
+
+	/**
+	 * Note a write to an address, if it is watched and changes it
+	 *
+	 * @param address Address written to, at least MEMORY_PAGED_START
+	 * @param old_value Value before the write
+	 * @param new_value Value written
+	 */
+	void record(Address address, uint8_t old_value, uint8_t new_value);
+
+	/**
+	 * Get the changes since they were last cleared
+	 */
+	const std::vector<MemoryChange> &get_changes() const;
+
+	/**
+	 * Forget the changes so far
+	 */
+	void clear_changes();
+};
+
+} // namespace memory
@@ -0,0 +1,77 @@
+/**
+ * @file shared_page.h
+ * Declares the SharedPage class, a block of memory that is copied on write
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace memory {
+
+/**
+ * A fixed size block of memory that can be shared between copies, and is only
+ * copied when one of them writes to it.
+ *
+ * Copying a SharedPage shares the block. A copy may be handed to another
+ * thread, since the block is never changed while anything else holds it.
+ */
+template <std::size_t Size> class SharedPage {
+  private:
+	/**
+	 * Get the block of zeros shared by new pages. It is held here for good,
+	 * so it is always copied before being written to.
+	 */
+	static const std::shared_ptr<std::array<uint8_t, Size>> &zeros() {
+		static const auto block =
+		    std::make_shared<std::array<uint8_t, Size>>();
+		return block;
+	}
+
+	/**
+	 * The block, shared with every copy that hasn't written since
+	 */
+	std::shared_ptr<std::array<uint8_t, Size>> block;
+
+  public:
+	/**
+	 * Share the block of zeros that every new page starts out as
+	 */
+	SharedPage() : block(zeros()) {}
+
+	/**
+	 * Get a pointer to the block for reading
+	 */
+	const uint8_t *data() const { return block->data(); }
+
+	/**
+	 * Get a pointer to the block for writing. If the block is shared, it is
+	 * copied first, so the others don't see the change.
+	 */
+	uint8_t *mutable_data() {
+		if (block.use_count() != 1) {
+			block = std::make_shared<std::array<uint8_t, Size>>(*block);
+		} else {
+			// Whoever held the block last may have read it on another thread
+			// before letting go, so see those reads finish before writing
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return block->data();
+	}
+
+	/**
+	 * Check whether the block is held by anything else
+	 */
+	bool is_shared() const { return block.use_count() != 1; }
+
+	/**
+	 * Read a byte
+	 */
+	uint8_t operator[](std::size_t index) const { return (*block)[index]; }
+};
+
+} // namespace memory
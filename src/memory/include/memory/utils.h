@@ -6,6 +6,10 @@
 #include <array>
 #include <cstdint>
 
+// Implementation of std::span
+// This is a shim and can be replaced with <span> when we get C++20
+#include <tcb/span.hpp>
+
 #pragma once
 
 /**
@@ -13,6 +17,42 @@
  */
 using Address = uint16_t;
 
+/**
+ * Size of the address space, and the contents of memory as plain data
+ */
+constexpr std::size_t MEMORY_SIZE = 0x10000;
+using MemoryState = std::array<uint8_t, MEMORY_SIZE>;
+
+/**
+ * Size and number of the pages that memory is split into, so that copies of a
+ * Memory can share the pages that neither one writes to. Pages start at Work
+ * RAM, since the cartridge below it is read through Cartridge, and VRAM is
+ * kept whole.
+ */
+constexpr std::size_t MEMORY_PAGE_SIZE = 0x100;
+constexpr std::size_t MEMORY_PAGED_START = 0xC000;
+constexpr std::size_t MEMORY_PAGE_COUNT =
+    (MEMORY_SIZE - MEMORY_PAGED_START) / MEMORY_PAGE_SIZE;
+
+/**
+ * Start address and size of the Video RAM (Character RAM and BG Maps)
+ */
+const Address VRAM_START = 0x8000;
+constexpr std::size_t VRAM_SIZE = 0x2000;
+
+/**
+ * Start address and size of the OAM (Sprite Attribute Table)
+ */
+const Address OAM_START = 0xFE00;
+constexpr std::size_t OAM_SIZE = 0xA0;
+
+/**
+ * Read-only views over the VRAM and the OAM. Index 0 of each view corresponds
+ * to the start address of that region
+ */
+using VRAMSpan = tcb::span<const uint8_t, VRAM_SIZE>;
+using OAMSpan = tcb::span<const uint8_t, OAM_SIZE>;
+
 /**
  * Boot ROM to load initial GameBoy BIOS
  */
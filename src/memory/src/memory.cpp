@@ -7,12 +7,13 @@
 #include "util/helpers.h"
 #include "util/log.h"
 
+#include <algorithm>
+
 namespace memory {
 
 Memory::Memory(cartridge::Cartridge *cartridge,
                controller::Controller *controller)
-    : memory(std::array<uint8_t, 0x10000>()), cartridge(cartridge),
-      controller(controller) {}
+    : watched_pages(0), cartridge(cartridge), controller(controller) {}
 
 bool address_in_range(Address addr, Address start, Address end) {
 	return (addr >= start && addr <= end) || (addr >= end && addr <= start);
@@ -26,12 +27,12 @@ uint8_t Memory::read(Address address) const {
 
 	// High RAM
 	if (address_in_range(address, 0xFFFE, 0xFF80)) {
-		return memory[address];
+		return get_byte(address);
 	}
 
 	// Boot ROM disable switch
 	if (address == 0xFF50) {
-		return memory[address];
+		return get_byte(address);
 	}
 
 	// GPU Registers
@@ -49,7 +50,9 @@ uint8_t Memory::read(Address address) const {
 		case 0x5:
 			return gpu->get_lyc()->get();
 		case 0x6:
-			Log::warn("Cannot read from DMA register");
+			if (Log::is_enabled()) {
+				Log::warn("Cannot read from DMA register");
+			}
 			return 0xFF; // DMA is non-readable
 		case 0x7:
 			return gpu->get_bgp()->get();
@@ -67,8 +70,11 @@ uint8_t Memory::read(Address address) const {
 	// Sound Controller Registers
 	if (address_in_range(address, 0xFF26, 0xFF10)) {
 		// TODO: Sound Controller
-		Log::warn("Attempt to read from sound register " + num_to_hex(address));
-		return memory[address];
+		if (Log::is_enabled()) {
+			Log::warn("Attempt to read from sound register " +
+			          num_to_hex(address));
+		}
+		return get_byte(address);
 	}
 
 	// Interrupt Flag register
@@ -79,15 +85,21 @@ uint8_t Memory::read(Address address) const {
 	// Timer registers
 	if (address_in_range(address, 0xFF07, 0xFF04)) {
 		// TODO: System Timers
-		Log::warn("Attempt to read from timer register " + num_to_hex(address));
-		return memory[address];
+		if (Log::is_enabled()) {
+			Log::warn("Attempt to read from timer register " +
+			          num_to_hex(address));
+		}
+		return get_byte(address);
 	}
 
 	// Serial data transfer registers
 	if (address_in_range(address, 0xFF02, 0xFF01)) {
 		// TODO: Serial Data Transfer
-		Log::warn("Attempt to read from SDT register " + num_to_hex(address));
-		return memory[address];
+		if (Log::is_enabled()) {
+			Log::warn("Attempt to read from SDT register " +
+			          num_to_hex(address));
+		}
+		return get_byte(address);
 	}
 
 	// Controller
@@ -98,41 +110,49 @@ uint8_t Memory::read(Address address) const {
 	// Restricted memory
 	if (address_in_range(address, 0xFEFF, 0xFEA0)) {
 		// Invalid Memory addresses!
-		Log::warn("Tried to access location " + num_to_hex(address));
+		if (Log::is_enabled()) {
+			Log::warn("Tried to access location " + num_to_hex(address));
+		}
 		return 0xFF;
 	}
 
 	// OAM
 	if (address_in_range(address, 0xFE9F, 0xFE00)) {
-		return memory[address];
+		return get_byte(address);
 	}
 
 	// Echo RAM, returns copy of RAM
 	if (address_in_range(address, 0xFDFF, 0xE000)) {
-		Log::warn("Reading from " + num_to_hex(address) + " which is Echo RAM");
-		return memory[address - 0x2000];
+		if (Log::is_enabled()) {
+			Log::warn("Reading from " + num_to_hex(address) +
+			          " which is Echo RAM");
+		}
+		return get_byte(address - 0x2000);
 	}
 
 	// Main Work RAM
 	if (address_in_range(address, 0xDFFF, 0xC000)) {
-		return memory[address];
+		return get_byte(address);
 	}
 
 	// Cartridge RAM
 	if (address_in_range(address, 0xBFFF, 0xA000)) {
-		Log::warn("Tried to access Cartridge RAM from " + num_to_hex(address));
+		if (Log::is_enabled()) {
+			Log::warn("Tried to access Cartridge RAM from " +
+			          num_to_hex(address));
+		}
 		return 0xFFFF;
 		// TODO: Return Cartridge RAM if available
 	}
 
 	// BG Data Maps
 	if (address_in_range(address, 0x9FFF, 0x9800)) {
-		return memory[address];
+		return get_byte(address);
 	}
 
 	// VRAM
 	if (address_in_range(address, 0x97FF, 0x8000)) {
-		return memory[address];
+		return get_byte(address);
 	}
 
 	// Cartridge Data
@@ -143,16 +163,19 @@ uint8_t Memory::read(Address address) const {
 	// Interrupt Vectors and Boot Rom
 	if (address_in_range(address, 0x00FF, 0x0000)) {
 		// If 0xFF50 is set, Boot ROM is enabled
-		if (memory[0xFF50] == 0x1) {
+		if (get_byte(0xFF50) == 0x1) {
 			return cartridge->read(address);
 		} else {
 			return boot[address];
 		}
 	}
 
-	Log::error("Default for location " + num_to_hex(address) + " returned!");
+	if (Log::is_enabled()) {
+		Log::error("Default for location " + num_to_hex(address) +
+		           " returned!");
+	}
 
-	return memory[address];
+	return get_byte(address);
 }
 
 void Memory::write(Address address, uint8_t data) {
@@ -164,19 +187,22 @@ void Memory::write(Address address, uint8_t data) {
 
 	// High RAM
 	if (address_in_range(address, 0xFFFE, 0xFF80)) {
-		memory[address] = data;
+		set_byte(address, data);
 		return;
 	}
 
 	// Unused memory that Tetris writes to
 	if (address_in_range(address, 0xFF7F, 0xFF51)) {
-		Log::warn("Attempt to write to invalid address " + num_to_hex(address));
+		if (Log::is_enabled()) {
+			Log::warn("Attempt to write to invalid address " +
+			          num_to_hex(address));
+		}
 		return;
 	}
 
 	// Boot ROM disable switch
 	if (address == 0xFF50) {
-		memory[address] = data;
+		set_byte(address, data);
 		return;
 	}
 
@@ -197,7 +223,9 @@ void Memory::write(Address address, uint8_t data) {
 			gpu->get_scx()->set(data);
 			return;
 		case 0x4:
-			Log::error("Cannot write to LY register location");
+			if (Log::is_enabled()) {
+				Log::error("Cannot write to LY register location");
+			}
 			return;
 		case 0x5:
 			gpu->get_lyc()->set(data);
@@ -226,8 +254,11 @@ void Memory::write(Address address, uint8_t data) {
 	// Sound Controller Registers
 	if (address_in_range(address, 0xFF3F, 0xFF10)) {
 		// TODO: Sound Controller
-		Log::warn("Attempt to write to sound register " + num_to_hex(address));
-		memory[address] = data;
+		if (Log::is_enabled()) {
+			Log::warn("Attempt to write to sound register " +
+			          num_to_hex(address));
+		}
+		set_byte(address, data);
 		return;
 	}
 
@@ -240,16 +271,22 @@ void Memory::write(Address address, uint8_t data) {
 	// Timer registers
 	if (address_in_range(address, 0xFF07, 0xFF04)) {
 		// TODO: System timers
-		Log::warn("Attempt to write to timer register " + num_to_hex(address));
-		memory[address] = data;
+		if (Log::is_enabled()) {
+			Log::warn("Attempt to write to timer register " +
+			          num_to_hex(address));
+		}
+		set_byte(address, data);
 		return;
 	}
 
 	// Serial data transfer registers
 	if (address_in_range(address, 0xFF02, 0xFF01)) {
 		// TODO: Serial Data Transfer
-		Log::warn("Attempt to write to SDT register " + num_to_hex(address));
-		memory[address] = data;
+		if (Log::is_enabled()) {
+			Log::warn("Attempt to write to SDT register " +
+			          num_to_hex(address));
+		}
+		set_byte(address, data);
 		return;
 	}
 
@@ -262,45 +299,52 @@ void Memory::write(Address address, uint8_t data) {
 	// Restricted memory
 	if (address_in_range(address, 0xFEFF, 0xFEA0)) {
 		// Invalid Memory addresses!
-		Log::warn("Tried to write to location " + num_to_hex(address));
+		if (Log::is_enabled()) {
+			Log::warn("Tried to write to location " + num_to_hex(address));
+		}
 		return;
 	}
 
 	// OAM
 	if (address_in_range(address, 0xFE9F, 0xFE00)) {
-		memory[address] = data;
+		set_byte(address, data);
 		return;
 	}
 
 	// Echo RAM, returns copy of RAM
 	if (address_in_range(address, 0xFDFF, 0xE000)) {
-		Log::warn("Writing to " + num_to_hex(address) + " which is Echo RAM");
-		memory[address - 0x2000] = data;
+		if (Log::is_enabled()) {
+			Log::warn("Writing to " + num_to_hex(address) +
+			          " which is Echo RAM");
+		}
+		set_byte(address - 0x2000, data);
 		return;
 	}
 
 	// Main Work RAM
 	if (address_in_range(address, 0xDFFF, 0xC000)) {
-		memory[address] = data;
+		set_byte(address, data);
 		return;
 	}
 
 	// Cartridge RAM
 	if (address_in_range(address, 0xBFFF, 0xA000)) {
 		// TODO: Return Cartridge RAM if available
-		Log::warn("Tried to write to Cart RAM from " + num_to_hex(address));
+		if (Log::is_enabled()) {
+			Log::warn("Tried to write to Cart RAM from " + num_to_hex(address));
+		}
 		return;
 	}
 
 	// BG Data Maps
 	if (address_in_range(address, 0x9FFF, 0x9800)) {
-		memory[address] = data;
+		set_byte(address, data);
 		return;
 	}
 
 	// VRAM
 	if (address_in_range(address, 0x97FF, 0x8000)) {
-		memory[address] = data;
+		set_byte(address, data);
 		return;
 	}
 
@@ -316,13 +360,147 @@ void Memory::write(Address address, uint8_t data) {
 		return;
 	}
 
-	Log::error("Attempt to write to location " + num_to_hex(address));
+	if (Log::is_enabled()) {
+		Log::error("Attempt to write to location " + num_to_hex(address));
+	}
+}
+
+VRAMSpan Memory::get_vram() const {
+	return VRAMSpan(vram.data(), VRAM_SIZE);
+}
+
+OAMSpan Memory::get_oam() const {
+	auto &page = pages[(OAM_START - MEMORY_PAGED_START) / MEMORY_PAGE_SIZE];
+	return OAMSpan(page.data() + OAM_START % MEMORY_PAGE_SIZE, OAM_SIZE);
 }
 
 void Memory::set_cpu(cpu::CPUInterface *p_cpu) { cpu = p_cpu; }
 
 void Memory::set_gpu(gpu::GPUInterface *p_gpu) { gpu = p_gpu; }
 
+void Memory::save_state(MemoryState &state) const {
+	// Nothing is kept for the cartridge, so it reads as zeros
+	std::fill_n(state.data(), MEMORY_PAGED_START, 0);
+	std::copy_n(vram.data(), VRAM_SIZE, state.data() + VRAM_START);
+	for (auto i = std::size_t{0}; i < MEMORY_PAGE_COUNT; ++i) {
+		std::copy_n(pages[i].data(), MEMORY_PAGE_SIZE,
+		            state.data() + MEMORY_PAGED_START + i * MEMORY_PAGE_SIZE);
+	}
+}
+
+/**
+ * Copy a block into a page, leaving the page shared if nothing changed
+ */
+template <std::size_t Size>
+static void load_page(SharedPage<Size> &page, const uint8_t *source) {
+	if (!std::equal(source, source + Size, page.data())) {
+		std::copy_n(source, Size, page.mutable_data());
+	}
+}
+
+void Memory::load_state(const MemoryState &state) {
+	load_page(vram, state.data() + VRAM_START);
+	for (auto i = std::size_t{0}; i < MEMORY_PAGE_COUNT; ++i) {
+		load_page(pages[i],
+		          state.data() + MEMORY_PAGED_START + i * MEMORY_PAGE_SIZE);
+	}
+}
+
+void Memory::share_pages(const Memory &other) {
+	pages = other.pages;
+	vram = other.vram;
+}
+
+std::size_t Memory::get_private_bytes() const {
+	auto bytes = vram.is_shared() ? std::size_t{0} : VRAM_SIZE;
+	for (auto &page : pages) {
+		if (!page.is_shared()) {
+			bytes += MEMORY_PAGE_SIZE;
+		}
+	}
+	return bytes;
+}
+
+uint8_t Memory::get_byte(Address address) const {
+	if (address >= MEMORY_PAGED_START) {
+		auto offset = address - MEMORY_PAGED_START;
+		return pages[offset / MEMORY_PAGE_SIZE][offset % MEMORY_PAGE_SIZE];
+	}
+	if (address >= VRAM_START && address < VRAM_START + VRAM_SIZE) {
+		return vram[address - VRAM_START];
+	}
+
+	// The cartridge is read through Cartridge, so nothing is kept for it
+	return 0;
+}
+
+void Memory::set_byte(Address address, uint8_t data) {
+	if (address >= MEMORY_PAGED_START) {
+		auto offset = address - MEMORY_PAGED_START;
+		auto page = offset / MEMORY_PAGE_SIZE;
+		auto &byte = pages[page].mutable_data()[offset % MEMORY_PAGE_SIZE];
+		if (watched_pages >> page & 1) {
+			watch->record(address, byte, data);
+		}
+		byte = data;
+	} else if (address >= VRAM_START && address < VRAM_START + VRAM_SIZE) {
+		vram.mutable_data()[address - VRAM_START] = data;
+	}
+}
+
+static_assert(MEMORY_PAGE_COUNT <= 64, "Watched pages must fit a mask");
+
+void Memory::watch_range(Address start, Address end) {
+	if (start < MEMORY_PAGED_START || end > 0xFFFE || start > end) {
+		Log::warn("Only RAM from 0xC000 to 0xFFFE can be watched");
+		start = std::max(start, Address{MEMORY_PAGED_START});
+		end = std::min(end, Address{0xFFFE});
+		if (start > end) {
+			return;
+		}
+	}
+
+	// Echo RAM is written through to the Work RAM 0x2000 below it, which is
+	// where writes are recorded, so watch that instead
+	if (start <= 0xFDFF && end >= 0xE000) {
+		if (start < 0xE000) {
+			watch_range(start, 0xDFFF);
+		}
+		if (end > 0xFDFF) {
+			watch_range(0xFE00, end);
+		}
+		start = std::max(start, Address{0xE000}) - 0x2000;
+		end = std::min(end, Address{0xFDFF}) - 0x2000;
+	}
+
+	if (!watch) {
+		watch = std::make_unique<MemoryWatch>();
+	}
+	watch->add(start, end);
+
+	auto first_page = (start - MEMORY_PAGED_START) / MEMORY_PAGE_SIZE;
+	auto last_page = (end - MEMORY_PAGED_START) / MEMORY_PAGE_SIZE;
+	for (auto page = first_page; page <= last_page; ++page) {
+		watched_pages |= uint64_t{1} << page;
+	}
+}
+
+void Memory::clear_watches() {
+	watch.reset();
+	watched_pages = 0;
+}
+
+const std::vector<MemoryChange> &Memory::get_changes() const {
+	static const auto none = std::vector<MemoryChange>();
+	return watch ? watch->get_changes() : none;
+}
+
+void Memory::clear_changes() {
+	if (watch) {
+		watch->clear_changes();
+	}
+}
+
 void Memory::dma_transfer(uint8_t offset) {
 	// The DMA routine transfers the 160 byte block at the given address to the
 	// corresponding block in high RAM (+ 0xFE00). We copy each byte in the
@@ -333,8 +511,8 @@ void Memory::dma_transfer(uint8_t offset) {
 		Address source = dma_start + i;
 		Address destination = 0xFE00 + i;
 
-		memory[destination] = memory[source];
+		set_byte(destination, get_byte(source));
 	}
 }
 
-} // namespace memory
\ No newline at end of file
+} // namespace memory
@@ -0,0 +1,58 @@
+/**
+ * @file memory_watch.cpp
+ * Defines the MemoryWatch class
+ */
+
+#include "memory/memory_watch.h"
+
+namespace memory {
+
+/**
+ * Values of a slot that has no change
+ */
+constexpr uint16_t SLOT_UNWATCHED = 0;
+constexpr uint16_t SLOT_WATCHED = 1;
+
+/**
+ * Value of a slot added to the index of its change
+ */
+constexpr uint16_t SLOT_CHANGE = 2;
+
+MemoryWatch::MemoryWatch()
+    : slots(MEMORY_SIZE - MEMORY_PAGED_START, SLOT_UNWATCHED),
+      watched_count(0) {}
+
+void MemoryWatch::add(Address start, Address end) {
+	for (auto address = std::size_t{start}; address <= end; ++address) {
+		auto &slot = slots[address - MEMORY_PAGED_START];
+		if (slot == SLOT_UNWATCHED) {
+			slot = SLOT_WATCHED;
+			watched_count++;
+		}
+	}
+	changes.reserve(watched_count);
+}
+
+void MemoryWatch::record(Address address, uint8_t old_value,
+                         uint8_t new_value) {
+	auto &slot = slots[address - MEMORY_PAGED_START];
+	if (slot >= SLOT_CHANGE) {
+		changes[slot - SLOT_CHANGE].new_value = new_value;
+	} else if (slot == SLOT_WATCHED && old_value != new_value) {
+		slot = SLOT_CHANGE + changes.size();
+		changes.push_back(MemoryChange{address, old_value, new_value});
+	}
+}
+
+const std::vector<MemoryChange> &MemoryWatch::get_changes() const {
+	return changes;
+}
+
+void MemoryWatch::clear_changes() {
+	for (auto &change : changes) {
+		slots[change.address - MEMORY_PAGED_START] = SLOT_WATCHED;
+	}
+	changes.clear();
+}
+
+} // namespace memory
@@ -0,0 +1,49 @@
+/**
+ * @file delta.h
+ * Declares helpers for storing the difference between two blocks of memory
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * XOR two blocks of memory together. The result is zero wherever they are
+ * the same, and XORing it into either block gives the other one back.
+ *
+ * @param first First block
+ * @param second Second block
+ * @param out Where to write the result, which may be either input
+ * @param size Size of each block, in bytes
+ */
+void xor_bytes(const uint8_t *first, const uint8_t *second, uint8_t *out,
+               std::size_t size);
+
+/**
+ * Compress an XOR delta, which is mostly runs of zeros.
+ *
+ * The output is a series of records, each one the length of a run of zeros,
+ * the length of the literal bytes that follow it, and the bytes themselves.
+ * Both lengths are unsigned LEB128 numbers. Zeros are found 8 bytes at a
+ * time, so unchanged memory is skipped over quickly.
+ *
+ * @param delta Delta to compress
+ * @param size Size of the delta, in bytes
+ * @param out Compressed delta. Anything already in it is replaced.
+ */
+void compress_delta(const uint8_t *delta, std::size_t size,
+                    std::vector<uint8_t> &out);
+
+/**
+ * XOR a compressed delta into a block of memory, without expanding it
+ * first. Runs of zeros are skipped, since they change nothing.
+ *
+ * @param compressed Delta made by compress_delta
+ * @param target Block to XOR into
+ * @param size Size of the block, in bytes
+ * @return false if the delta is malformed or doesn't fit the block
+ */
+bool apply_delta(const std::vector<uint8_t> &compressed, uint8_t *target,
+                 std::size_t size);
@@ -0,0 +1,181 @@
+/**
+ * @file frame_pacer.h
+ * Declares the FramePacer class, that keeps emulation in step with real time
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Summary of how closely frames have kept to their intended interval
+ */
+struct PacingStats {
+	/**
+	 * Number of frame intervals measured
+	 */
+	uint64_t frames;
+
+	/**
+	 * Mean difference between the real and intended frame interval, in
+	 * microseconds
+	 */
+	double mean_error_us;
+
+	/**
+	 * 99th percentile of the difference between the real and intended frame
+	 * interval, in microseconds
+	 */
+	double p99_error_us;
+};
+
+/**
+ * Paces emulation to real time, based on the number of emulated clock cycles.
+ *
+ * Every emulated cycle moves a deadline forward by its real duration, and
+ * pace() waits for that deadline. The wait sleeps until shortly before the
+ * deadline, since the OS can wake a sleeping thread late, and spins for the
+ * rest of it. Speed and turbo are atomics, so that they can be changed from
+ * the UI thread while the emulation thread is running.
+ */
+class FramePacer {
+  public:
+	/**
+	 * Slowest and fastest allowed speed multipliers
+	 */
+	static constexpr double MIN_SPEED = 0.25;
+	static constexpr double MAX_SPEED = 64.0;
+
+  private:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Time before the deadline at which sleeping stops and spinning starts
+	 */
+	static constexpr auto SPIN_TIME = std::chrono::microseconds(1500);
+
+	/**
+	 * If emulation falls further behind than this, the pacer gives up on
+	 * catching up and starts again from the current time
+	 */
+	static constexpr auto MAX_LAG = std::chrono::milliseconds(100);
+
+	/**
+	 * Number of recent frame intervals kept for the stats
+	 */
+	static constexpr std::size_t HISTORY_SIZE = 1024;
+
+	/**
+	 * Number of emulated clock cycles in one second at normal speed
+	 */
+	uint64_t clock_speed;
+
+	/**
+	 * Speed multiplier, where 1 is the real hardware speed
+	 */
+	std::atomic<double> speed;
+
+	/**
+	 * If set, pace() never waits
+	 */
+	std::atomic<bool> turbo;
+
+	/**
+	 * Time at which the emulated cycles so far should be done
+	 */
+	Clock::time_point deadline;
+
+	/**
+	 * Time at which the last call to pace() returned
+	 */
+	Clock::time_point last_wake;
+
+	/**
+	 * Set if the last call to pace() found its deadline already passed
+	 */
+	bool late;
+
+	/**
+	 * Guards the stats below, which are read from other threads
+	 */
+	mutable std::mutex stats_mutex;
+
+	/**
+	 * Absolute frame interval errors of recent frames, in nanoseconds
+	 */
+	std::array<int64_t, HISTORY_SIZE> errors;
+
+	/**
+	 * Total number of frame intervals measured. The newest error is at
+	 * (frames - 1) % HISTORY_SIZE
+	 */
+	uint64_t frames;
+
+	/**
+	 * Wait until the given time, sleeping for as much of it as is safe
+	 */
+	static void wait_until(Clock::time_point time);
+
+	/**
+	 * Record the error of one frame interval
+	 */
+	void record(Clock::duration interval, Clock::duration target);
+
+  public:
+	/**
+	 * Constructor
+	 *
+	 * @param clock_speed Number of emulated clock cycles in one second
+	 */
+	FramePacer(uint64_t clock_speed);
+
+	/**
+	 * Account for some emulated clock cycles, and wait until real time has
+	 * caught up with them. Called by the emulation thread after every frame.
+	 *
+	 * @param cycles Number of cycles emulated since the last call
+	 */
+	void pace(uint64_t cycles);
+
+	/**
+	 * Set the speed multiplier. It is clamped between MIN_SPEED and MAX_SPEED
+	 */
+	void set_speed(double speed);
+
+	/**
+	 * Get the speed multiplier
+	 */
+	double get_speed() const;
+
+	/**
+	 * Turn turbo on or off. In turbo mode emulation runs as fast as it can
+	 */
+	void set_turbo(bool turbo);
+
+	/**
+	 * Check if turbo mode is on
+	 */
+	bool get_turbo() const;
+
+	/**
+	 * Check if emulation is behind real time, which is when the last call to
+	 * pace() didn't have to wait. Turbo mode always counts as late, since it
+	 * never waits for real time.
+	 */
+	bool is_late() const;
+
+	/**
+	 * Get the time at which the emulated cycles so far should be done. It
+	 * starts at the time the pacer was created.
+	 */
+	std::chrono::steady_clock::time_point get_deadline() const;
+
+	/**
+	 * Get stats on the recent frame intervals
+	 */
+	PacingStats get_stats() const;
+};
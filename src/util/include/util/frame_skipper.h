@@ -0,0 +1,54 @@
+/**
+ * @file frame_skipper.h
+ * Declares the FrameSkipper class, that picks which frames to render
+ */
+
+#pragma once
+
+/**
+ * Decides which frames are rendered, and which are only emulated.
+ *
+ * Either a fixed number of frames is skipped after every rendered frame, or
+ * in automatic mode, frames are skipped while emulation is behind real time.
+ */
+class FrameSkipper {
+  public:
+	/**
+	 * Most frames that automatic mode will skip in a row, so that the screen
+	 * still updates when emulation can never catch up
+	 */
+	static constexpr unsigned int MAX_AUTO_SKIP = 8;
+
+  private:
+	/**
+	 * Number of frames skipped after every rendered frame
+	 */
+	unsigned int frameskip;
+
+	/**
+	 * If set, frames are skipped based on timing instead of frameskip
+	 */
+	bool automatic;
+
+	/**
+	 * Number of frames skipped since the last rendered frame. It starts out
+	 * at frameskip, so that a fixed frameskip renders the first frame.
+	 */
+	unsigned int skipped;
+
+  public:
+	/**
+	 * Constructor
+	 *
+	 * @param frameskip Number of frames to skip after every rendered frame
+	 * @param automatic Skip frames only when emulation is running late
+	 */
+	FrameSkipper(unsigned int frameskip = 0, bool automatic = false);
+
+	/**
+	 * Decide whether the next frame should be rendered
+	 *
+	 * @param late True if emulation is behind real time
+	 */
+	bool should_render(bool late);
+};
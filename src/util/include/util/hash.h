@@ -0,0 +1,23 @@
+/**
+ * @file hash.h
+ * Declares a fast non-cryptographic hash, for comparing blocks of memory
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Hash a block of memory with XXH64.
+ *
+ * It is used to tell if frames or emulator state have changed without
+ * keeping a copy of the previous one. Reading 8 byte words in four
+ * independent lanes makes it about as fast as a plain memcmp. The input is
+ * read as little endian, so hashes only match across little endian hosts.
+ *
+ * @param data Start of the memory to hash
+ * @param size Size of the memory, in bytes
+ * @param seed Seed for the hash
+ */
+uint64_t hash_bytes(const void *data, std::size_t size, uint64_t seed = 0);
@@ -28,6 +28,10 @@ class Log {
 	static void Enable();
 	static void Disable();
 
+	/// True if messages are printed. Callers on hot paths check this before
+	/// building a message, which allocates even when it is thrown away.
+	static bool is_enabled() { return enabled; }
+
 	/// Log something. Defaults to LogLevel::INFO if no level given
 	static void log(std::string message, LogLevel log_level = LogLevel::INFO);
 
@@ -0,0 +1,111 @@
+/**
+ * @file spsc_queue.h
+ * Declares the SPSCQueue class, a bounded queue between two threads
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Lock-free, bounded, single-producer single-consumer queue.
+ *
+ * Exactly one thread may push, and exactly one other thread may pop. The
+ * capacity must be a power of two. Pushing to a full queue fails instead of
+ * blocking, so the producer never waits on the consumer.
+ */
+template <typename T, std::size_t Capacity> class SPSCQueue {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+	              "SPSCQueue capacity must be a power of two");
+
+  private:
+	/**
+	 * Ring buffer of queued elements
+	 */
+	std::array<T, Capacity> elements;
+
+	/**
+	 * Count of elements pushed so far. Only written by the producer. Kept on
+	 * its own cache line so that the two threads don't contend on it.
+	 */
+	alignas(64) std::atomic<std::size_t> tail;
+
+	/**
+	 * Count of elements popped so far. Only written by the consumer
+	 */
+	alignas(64) std::atomic<std::size_t> head;
+
+  public:
+	SPSCQueue() : elements({}), tail(0), head(0) {}
+
+	/**
+	 * Add an element to the back of the queue. Producer only
+	 *
+	 * @param element Element to add
+	 * @return false if the queue was full, and the element was dropped
+	 */
+	bool push(const T &element) {
+		auto current_tail = tail.load(std::memory_order_relaxed);
+		if (current_tail - head.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+
+		elements[current_tail % Capacity] = element;
+		tail.store(current_tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Get the element at the front of the queue without removing it.
+	 * Consumer only
+	 *
+	 * @return Pointer to the front element, or nullptr if the queue is empty
+	 */
+	const T *peek() const {
+		auto current_head = head.load(std::memory_order_relaxed);
+		if (current_head == tail.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+
+		return &elements[current_head % Capacity];
+	}
+
+	/**
+	 * Remove the element at the front of the queue. Consumer only
+	 *
+	 * @param element Set to the removed element
+	 * @return false if the queue was empty
+	 */
+	bool pop(T &element) {
+		auto front = peek();
+		if (front == nullptr) {
+			return false;
+		}
+
+		element = *front;
+		return pop();
+	}
+
+	/**
+	 * Remove the element at the front of the queue without copying it, after
+	 * it has been used through peek(). Consumer only
+	 *
+	 * @return false if the queue was empty
+	 */
+	bool pop() {
+		if (empty()) {
+			return false;
+		}
+
+		head.store(head.load(std::memory_order_relaxed) + 1,
+		           std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Check if the queue is empty. Only exact when called by the consumer
+	 */
+	bool empty() const { return peek() == nullptr; }
+};
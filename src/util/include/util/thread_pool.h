@@ -0,0 +1,159 @@
+/**
+ * @file thread_pool.h
+ * Declares the ThreadPool class
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A small pool of worker threads for splitting one job into parallel parts.
+ *
+ * The threads are started once and reused for every job, so handing out work
+ * costs a wakeup instead of a thread creation.
+ */
+class ThreadPool {
+  private:
+	/**
+	 * Worker threads. The thread calling parallel_for also does work, so
+	 * there is one less worker than the thread count
+	 */
+	std::vector<std::thread> workers;
+
+	/**
+	 * Guards all the job state below
+	 */
+	std::mutex mutex;
+
+	/**
+	 * Signalled when a new job is available, or the pool is stopping
+	 */
+	std::condition_variable job_ready;
+
+	/**
+	 * Signalled when the last part of a job is finished
+	 */
+	std::condition_variable job_done;
+
+	/**
+	 * Function for the current job, called with the index of each part
+	 */
+	const std::function<void(std::size_t)> *job;
+
+	/**
+	 * Set when the current job is run once on every thread, with the index
+	 * of the thread, instead of being split into parts
+	 */
+	bool each_thread;
+
+	/**
+	 * Number of parts in the current job
+	 */
+	std::size_t part_count;
+
+	/**
+	 * Index of the next part to be picked up
+	 */
+	std::size_t next_part;
+
+	/**
+	 * Number of parts that haven't finished yet
+	 */
+	std::size_t parts_left;
+
+	/**
+	 * Incremented for every job, so that workers can tell a new job apart
+	 * from a spurious wakeup
+	 */
+	uint64_t generation;
+
+	/**
+	 * Set when the pool is being destroyed
+	 */
+	bool stopping;
+
+	/**
+	 * Set once pin_threads has pinned the workers, after which the calling
+	 * thread is pinned for its share of run_on_each jobs too
+	 */
+	bool pinned;
+
+	/**
+	 * Run the calling thread's share of a run_on_each job. Once the workers
+	 * are pinned, the calling thread is held on the first core while it does,
+	 * and given back the cores it was allowed on afterwards.
+	 */
+	void run_caller_share(const std::function<void(std::size_t)> &function);
+
+	/**
+	 * Pick up and run parts of the current job until there are none left.
+	 * Must be called with the lock held
+	 */
+	void run_parts(std::unique_lock<std::mutex> &lock);
+
+	/**
+	 * Main loop of each worker thread
+	 *
+	 * @param index Index of the thread, from 1 since the calling thread is 0
+	 */
+	void worker_loop(std::size_t index);
+
+  public:
+	/**
+	 * Start a pool that runs jobs on the given number of threads, including
+	 * the calling thread
+	 *
+	 * @param thread_count Number of threads. 0 uses one per hardware thread
+	 */
+	ThreadPool(std::size_t thread_count = 0);
+
+	/**
+	 * Stop and join all the worker threads
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &other) = delete;
+	ThreadPool &operator=(const ThreadPool &other) = delete;
+
+	/**
+	 * Run a job split into parts across the pool, and wait for all of them
+	 * to finish. Parts may run in any order.
+	 *
+	 * @param parts Number of parts
+	 * @param function Called once for each part, with the part index
+	 */
+	void parallel_for(std::size_t parts,
+	                  const std::function<void(std::size_t)> &function);
+
+	/**
+	 * Run a job once on every thread, and wait for all of them to finish.
+	 * Each thread is given its own index, and the calling thread is 0, so
+	 * work split up by index always lands on the same thread.
+	 *
+	 * @param function Called once on each thread, with the thread index
+	 */
+	void run_on_each(const std::function<void(std::size_t)> &function);
+
+	/**
+	 * Pin each thread to its own CPU core, so that the work it is given by
+	 * run_on_each stays in that core's caches. Thread index i runs on core i,
+	 * wrapping around if there are more threads than cores. The calling
+	 * thread is only held on the first core while it runs its share of a
+	 * run_on_each job. Only supported on Linux.
+	 *
+	 * @return false if the threads could not be pinned
+	 */
+	bool pin_threads();
+
+	/**
+	 * Get the number of threads that run jobs, including the calling thread
+	 */
+	std::size_t get_thread_count() const;
+};
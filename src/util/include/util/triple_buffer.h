@@ -0,0 +1,93 @@
+/**
+ * @file triple_buffer.h
+ * Declares the TripleBuffer class, for handing values between two threads
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free triple buffer for passing the latest value from one producer
+ * thread to one consumer thread.
+ *
+ * The producer writes into the back buffer and publishes it, and the consumer
+ * takes the most recently published buffer as its front buffer. A third
+ * buffer sits between the two, so neither side ever waits for the other. If
+ * the producer publishes faster than the consumer reads, the older values are
+ * simply overwritten.
+ */
+template <typename T> class TripleBuffer {
+  private:
+	/**
+	 * Flag set in the shared index when it holds a value not yet consumed
+	 */
+	static constexpr uint8_t FRESH = 0x4;
+
+	/**
+	 * Mask to extract the buffer index from the shared index
+	 */
+	static constexpr uint8_t INDEX_MASK = 0x3;
+
+	/**
+	 * Storage for all three buffers
+	 */
+	std::array<T, 3> buffers;
+
+	/**
+	 * Index of the buffer in the middle, shared between both threads. Also
+	 * holds the FRESH flag
+	 */
+	std::atomic<uint8_t> middle;
+
+	/**
+	 * Index of the buffer being written to. Only used by the producer
+	 */
+	uint8_t back;
+
+	/**
+	 * Index of the buffer being read from. Only used by the consumer
+	 */
+	uint8_t front;
+
+  public:
+	TripleBuffer() : buffers({}), middle(1), back(0), front(2) {}
+
+	/**
+	 * Get the buffer to write the next value to. Producer only
+	 */
+	T &get_back() { return buffers[back]; }
+
+	/**
+	 * Publish the back buffer, making it the latest value. The producer gets
+	 * a new back buffer to write to. Producer only
+	 */
+	void publish() {
+		auto fresh_back = static_cast<uint8_t>(back | FRESH);
+		auto previous = middle.exchange(fresh_back, std::memory_order_acq_rel);
+		back = previous & INDEX_MASK;
+	}
+
+	/**
+	 * Make the latest published value the front buffer, if there is one that
+	 * hasn't been seen yet. Consumer only
+	 *
+	 * @return true if the front buffer changed
+	 */
+	bool update() {
+		if (!(middle.load(std::memory_order_acquire) & FRESH)) {
+			return false;
+		}
+
+		auto previous = middle.exchange(front, std::memory_order_acq_rel);
+		front = previous & INDEX_MASK;
+		return true;
+	}
+
+	/**
+	 * Get the buffer with the last value taken by update(). Consumer only
+	 */
+	const T &get_front() const { return buffers[front]; }
+};
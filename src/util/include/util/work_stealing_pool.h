@@ -0,0 +1,96 @@
+/**
+ * @file work_stealing_pool.h
+ * Declares the WorkStealingPool class
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Runs a batch of independent tasks across threads, when tasks take very
+ * different amounts of time.
+ *
+ * Each thread starts with its own share of the tasks, in order, and works
+ * through them from the front. A thread that runs out steals from the back of
+ * another thread's share. Threads hardly ever touch the same queue, and a
+ * thread that picked up long tasks has the rest of its share taken off it.
+ *
+ * Unlike ThreadPool, which is made for many short jobs, threads are started
+ * for each run, since a run is expected to last a long time.
+ */
+class WorkStealingPool {
+  private:
+	/**
+	 * The tasks still waiting in one thread's share
+	 */
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<std::size_t> tasks;
+	};
+
+	/**
+	 * Number of threads that run tasks, including the calling thread
+	 */
+	std::size_t thread_count;
+
+	/**
+	 * One queue for each thread, during a run
+	 */
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+
+	/**
+	 * Number of tasks stolen during the last run
+	 */
+	std::atomic<uint64_t> steals;
+
+	/**
+	 * Take the next task for a thread, stealing one if its own queue is empty
+	 *
+	 * @param worker Index of the thread
+	 * @param task Where to put the task
+	 * @return false once there are no tasks left anywhere
+	 */
+	bool take_task(std::size_t worker, std::size_t &task);
+
+  public:
+	/**
+	 * Make a pool that runs tasks on the given number of threads, including
+	 * the calling thread
+	 *
+	 * @param thread_count Number of threads. 0 uses one per hardware thread
+	 */
+	WorkStealingPool(std::size_t thread_count = 0);
+
+	WorkStealingPool(const WorkStealingPool &other) = delete;
+	WorkStealingPool &operator=(const WorkStealingPool &other) = delete;
+
+	/**
+	 * Run every task, and wait for all of them to finish. A thread runs the
+	 * tasks of its own share in order, but tasks may run in any order
+	 * overall.
+	 *
+	 * @param tasks Number of tasks
+	 * @param function Called once for each task, with the task index and the
+	 * index of the thread running it, which is below get_thread_count
+	 */
+	void run(std::size_t tasks,
+	         const std::function<void(std::size_t, std::size_t)> &function);
+
+	/**
+	 * Get the number of threads that run tasks, including the calling thread
+	 */
+	std::size_t get_thread_count() const;
+
+	/**
+	 * Get the number of tasks that were stolen during the last run
+	 */
+	uint64_t get_steal_count() const;
+};
@@ -0,0 +1,128 @@
+/**
+ * @file delta.cpp
+ * Defines helpers for storing the difference between two blocks of memory
+ */
+
+#include "util/delta.h"
+
+#include <cstring>
+
+/**
+ * Append an unsigned LEB128 number
+ */
+static void put_varint(std::vector<uint8_t> &out, std::size_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * Read an unsigned LEB128 number at pos, and move past it
+ */
+static bool get_varint(const std::vector<uint8_t> &in, std::size_t &pos,
+                       std::size_t &value) {
+	value = 0;
+	for (auto shift = 0u; shift < 64 && pos < in.size(); shift += 7) {
+		auto byte = in[pos++];
+		value |= std::size_t{byte & 0x7Fu} << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Find the end of the run of zeros starting at pos
+ */
+static std::size_t skip_zeros(const uint8_t *data, std::size_t pos,
+                              std::size_t size) {
+	while (pos + 8 <= size) {
+		uint64_t word;
+		std::memcpy(&word, data + pos, sizeof(word));
+		if (word != 0) {
+			break;
+		}
+		pos += 8;
+	}
+
+	while (pos < size && data[pos] == 0) {
+		pos++;
+	}
+	return pos;
+}
+
+/**
+ * Find the end of the literal bytes starting at pos. A literal only ends at
+ * a run of at least 8 zeros, since a shorter run costs more to encode than
+ * to copy.
+ */
+static std::size_t skip_literal(const uint8_t *data, std::size_t pos,
+                                std::size_t size) {
+	auto zeros = std::size_t{0};
+	while (pos < size) {
+		zeros = data[pos] == 0 ? zeros + 1 : 0;
+		pos++;
+		if (zeros == 8) {
+			return pos - zeros;
+		}
+	}
+	return pos - zeros;
+}
+
+void xor_bytes(const uint8_t *first, const uint8_t *second, uint8_t *out,
+               std::size_t size) {
+	// Work a word at a time. Each word is read before it is written, so the
+	// output may be one of the inputs.
+	auto i = std::size_t{0};
+	for (; i + 8 <= size; i += 8) {
+		uint64_t a, b;
+		std::memcpy(&a, first + i, sizeof(a));
+		std::memcpy(&b, second + i, sizeof(b));
+		a ^= b;
+		std::memcpy(out + i, &a, sizeof(a));
+	}
+
+	for (; i < size; ++i) {
+		out[i] = first[i] ^ second[i];
+	}
+}
+
+void compress_delta(const uint8_t *delta, std::size_t size,
+                    std::vector<uint8_t> &out) {
+	out.clear();
+
+	auto pos = std::size_t{0};
+	while (pos < size) {
+		auto literal_start = skip_zeros(delta, pos, size);
+		auto literal_end = skip_literal(delta, literal_start, size);
+
+		put_varint(out, literal_start - pos);
+		put_varint(out, literal_end - literal_start);
+		out.insert(out.end(), delta + literal_start, delta + literal_end);
+		pos = literal_end;
+	}
+}
+
+bool apply_delta(const std::vector<uint8_t> &compressed, uint8_t *target,
+                 std::size_t size) {
+	auto in = std::size_t{0};
+	auto pos = std::size_t{0};
+	while (in < compressed.size()) {
+		std::size_t zeros, literal;
+		if (!get_varint(compressed, in, zeros) ||
+		    !get_varint(compressed, in, literal) || zeros > size - pos ||
+		    literal > size - pos - zeros ||
+		    literal > compressed.size() - in) {
+			return false;
+		}
+
+		pos += zeros;
+		xor_bytes(target + pos, compressed.data() + in, target + pos, literal);
+		pos += literal;
+		in += literal;
+	}
+	return true;
+}
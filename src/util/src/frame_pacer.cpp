@@ -0,0 +1,128 @@
+/**
+ * @file frame_pacer.cpp
+ * Defines the FramePacer class
+ */
+
+#include "util/frame_pacer.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+using namespace std::chrono;
+
+FramePacer::FramePacer(uint64_t clock_speed)
+    : clock_speed(clock_speed), speed(1.0), turbo(false),
+      deadline(Clock::now()), last_wake(deadline), late(false), errors({}),
+      frames(0) {}
+
+void FramePacer::wait_until(Clock::time_point time) {
+	auto sleep_end = time - SPIN_TIME;
+
+	if (Clock::now() < sleep_end) {
+#if defined(__linux__)
+		// steady_clock is CLOCK_MONOTONIC on Linux, so the deadline can be
+		// slept to directly without drifting by the time taken to compute a
+		// relative delay
+		auto since_epoch = sleep_end.time_since_epoch();
+		auto secs = duration_cast<seconds>(since_epoch);
+		auto nanos = duration_cast<nanoseconds>(since_epoch - secs);
+		auto request = timespec{};
+		request.tv_sec = secs.count();
+		request.tv_nsec = nanos.count();
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &request,
+		                       nullptr) != 0) {
+			// Interrupted by a signal, keep sleeping
+		}
+#else
+		std::this_thread::sleep_until(sleep_end);
+#endif
+	}
+
+	while (Clock::now() < time) {
+		std::this_thread::yield();
+	}
+}
+
+void FramePacer::record(Clock::duration interval, Clock::duration target) {
+	auto error = duration_cast<nanoseconds>(interval - target).count();
+
+	auto lock = std::lock_guard<std::mutex>(stats_mutex);
+	errors[frames % HISTORY_SIZE] = error < 0 ? -error : error;
+	frames++;
+}
+
+void FramePacer::pace(uint64_t cycles) {
+	auto now = Clock::now();
+
+	if (turbo) {
+		deadline = now;
+		last_wake = now;
+		late = true;
+		return;
+	}
+
+	auto frame_time = duration_cast<Clock::duration>(duration<double>(
+	    static_cast<double>(cycles) / (clock_speed * speed.load())));
+	deadline += frame_time;
+	late = now >= deadline;
+
+	// After a stall (or coming out of turbo), start pacing again from now
+	// instead of running fast until the lost time is made up
+	if (now - deadline > MAX_LAG) {
+		deadline = now + frame_time;
+	}
+
+	wait_until(deadline);
+
+	auto wake = Clock::now();
+	record(wake - last_wake, frame_time);
+	last_wake = wake;
+}
+
+void FramePacer::set_speed(double speed) {
+	this->speed = std::clamp(speed, MIN_SPEED, MAX_SPEED);
+}
+
+double FramePacer::get_speed() const { return speed; }
+
+void FramePacer::set_turbo(bool turbo) { this->turbo = turbo; }
+
+bool FramePacer::get_turbo() const { return turbo; }
+
+bool FramePacer::is_late() const { return late; }
+
+FramePacer::Clock::time_point FramePacer::get_deadline() const {
+	return deadline;
+}
+
+PacingStats FramePacer::get_stats() const {
+	auto recent = std::vector<int64_t>();
+	auto stats = PacingStats{0, 0.0, 0.0};
+	{
+		auto lock = std::lock_guard<std::mutex>(stats_mutex);
+		auto count = std::min<uint64_t>(frames, HISTORY_SIZE);
+		recent.assign(errors.begin(), errors.begin() + count);
+		stats.frames = frames;
+	}
+
+	if (recent.empty()) {
+		return stats;
+	}
+
+	auto total = 0.0;
+	for (auto error : recent) {
+		total += error;
+	}
+	stats.mean_error_us = total / recent.size() / 1000.0;
+
+	auto p99 = recent.begin() + (recent.size() * 99) / 100;
+	std::nth_element(recent.begin(), p99, recent.end());
+	stats.p99_error_us = *p99 / 1000.0;
+
+	return stats;
+}
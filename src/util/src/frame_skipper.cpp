@@ -0,0 +1,21 @@
+/**
+ * @file frame_skipper.cpp
+ * Defines the FrameSkipper class
+ */
+
+#include "util/frame_skipper.h"
+
+FrameSkipper::FrameSkipper(unsigned int frameskip, bool automatic)
+    : frameskip(frameskip), automatic(automatic), skipped(frameskip) {}
+
+bool FrameSkipper::should_render(bool late) {
+	auto limit = automatic ? (late ? MAX_AUTO_SKIP : 0) : frameskip;
+
+	if (skipped < limit) {
+		skipped++;
+		return false;
+	}
+
+	skipped = 0;
+	return true;
+}
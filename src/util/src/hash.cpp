@@ -0,0 +1,101 @@
+/**
+ * @file hash.cpp
+ * Defines the XXH64 hash
+ */
+
+#include "util/hash.h"
+
+#include <cstring>
+
+static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotate_left(uint64_t value, int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t read_64(const uint8_t *data) {
+	uint64_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static inline uint32_t read_32(const uint8_t *data) {
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+/**
+ * Mix one 8 byte word into a lane
+ */
+static inline uint64_t mix_round(uint64_t lane, uint64_t input) {
+	lane += input * PRIME_2;
+	lane = rotate_left(lane, 31);
+	return lane * PRIME_1;
+}
+
+/**
+ * Fold a lane into the final hash
+ */
+static inline uint64_t merge_round(uint64_t hash, uint64_t lane) {
+	hash ^= mix_round(0, lane);
+	return hash * PRIME_1 + PRIME_4;
+}
+
+uint64_t hash_bytes(const void *data, std::size_t size, uint64_t seed) {
+	auto input = static_cast<const uint8_t *>(data);
+	auto end = input + size;
+	auto hash = uint64_t{0};
+
+	if (size >= 32) {
+		// Main loop, with four lanes that don't depend on each other
+		uint64_t lanes[4] = {seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed,
+		                     seed - PRIME_1};
+
+		for (; input + 32 <= end; input += 32) {
+			for (auto i = 0; i < 4; ++i) {
+				lanes[i] = mix_round(lanes[i], read_64(input + i * 8));
+			}
+		}
+
+		hash = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7) +
+		       rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+		for (auto lane : lanes) {
+			hash = merge_round(hash, lane);
+		}
+	} else {
+		hash = seed + PRIME_5;
+	}
+
+	hash += size;
+
+	// Mix in the bytes left over from the main loop
+	for (; input + 8 <= end; input += 8) {
+		hash ^= mix_round(0, read_64(input));
+		hash = rotate_left(hash, 27) * PRIME_1 + PRIME_4;
+	}
+
+	if (input + 4 <= end) {
+		hash ^= read_32(input) * PRIME_1;
+		hash = rotate_left(hash, 23) * PRIME_2 + PRIME_3;
+		input += 4;
+	}
+
+	for (; input < end; ++input) {
+		hash ^= *input * PRIME_5;
+		hash = rotate_left(hash, 11) * PRIME_1;
+	}
+
+	// Final avalanche, so that every input bit affects every output bit
+	hash ^= hash >> 33;
+	hash *= PRIME_2;
+	hash ^= hash >> 29;
+	hash *= PRIME_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file thread_pool.cpp
+ * Defines the ThreadPool class
+ */
+
+#include "util/thread_pool.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * Pin a thread to one core
+ *
+ * @return false if the thread could not be pinned
+ */
+static bool pin_to_core(pthread_t thread, std::size_t core) {
+	auto cpus = cpu_set_t();
+	CPU_ZERO(&cpus);
+	CPU_SET(core, &cpus);
+	return pthread_setaffinity_np(thread, sizeof(cpus), &cpus) == 0;
+}
+#endif
+
+ThreadPool::ThreadPool(std::size_t thread_count)
+    : job(nullptr), each_thread(false), part_count(0), next_part(0),
+      parts_left(0), generation(0), stopping(false), pinned(false) {
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (std::size_t i = 1; i < thread_count; ++i) {
+		workers.emplace_back([this, i] { worker_loop(i); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		auto lock = std::unique_lock<std::mutex>(mutex);
+		stopping = true;
+	}
+	job_ready.notify_all();
+
+	for (auto &worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::parallel_for(
+    std::size_t parts, const std::function<void(std::size_t)> &function) {
+	if (parts == 0) {
+		return;
+	}
+
+	auto lock = std::unique_lock<std::mutex>(mutex);
+	job = &function;
+	each_thread = false;
+	part_count = parts;
+	next_part = 0;
+	parts_left = parts;
+	generation++;
+	job_ready.notify_all();
+
+	// Help out with the job, then wait for the workers to finish theirs
+	run_parts(lock);
+	job_done.wait(lock, [this] { return parts_left == 0; });
+	job = nullptr;
+}
+
+void ThreadPool::run_on_each(
+    const std::function<void(std::size_t)> &function) {
+	auto lock = std::unique_lock<std::mutex>(mutex);
+	job = &function;
+	each_thread = true;
+	part_count = 0;
+	next_part = 0;
+	parts_left = get_thread_count();
+	generation++;
+	job_ready.notify_all();
+
+	// Do the calling thread's share, then wait for the workers to finish
+	lock.unlock();
+	run_caller_share(function);
+	lock.lock();
+	parts_left--;
+	job_done.wait(lock, [this] { return parts_left == 0; });
+	job = nullptr;
+}
+
+bool ThreadPool::pin_threads() {
+#if defined(__linux__)
+	auto cores = std::max(1u, std::thread::hardware_concurrency());
+	auto all_pinned = true;
+	for (std::size_t i = 0; i < workers.size(); ++i) {
+		// Worker i has index i + 1, and the calling thread takes the first
+		// core for index 0
+		all_pinned &= pin_to_core(workers[i].native_handle(), (i + 1) % cores);
+	}
+	pinned = all_pinned;
+	return pinned;
+#else
+	return false;
+#endif
+}
+
+std::size_t ThreadPool::get_thread_count() const { return workers.size() + 1; }
+
+void ThreadPool::run_caller_share(
+    const std::function<void(std::size_t)> &function) {
+#if defined(__linux__)
+	auto self = pthread_self();
+	auto allowed = cpu_set_t();
+	auto pin = pinned &&
+	           pthread_getaffinity_np(self, sizeof(allowed), &allowed) == 0 &&
+	           pin_to_core(self, 0);
+	function(0);
+	if (pin) {
+		pthread_setaffinity_np(self, sizeof(allowed), &allowed);
+	}
+#else
+	function(0);
+#endif
+}
+
+void ThreadPool::run_parts(std::unique_lock<std::mutex> &lock) {
+	while (job != nullptr && next_part < part_count) {
+		auto part = next_part++;
+		auto function = job;
+
+		lock.unlock();
+		(*function)(part);
+		lock.lock();
+
+		if (--parts_left == 0) {
+			job_done.notify_all();
+		}
+	}
+}
+
+void ThreadPool::worker_loop(std::size_t index) {
+	auto lock = std::unique_lock<std::mutex>(mutex);
+	// Start from the generation that the pool was made with, so that a job
+	// handed out before this thread got going isn't missed
+	auto seen_generation = uint64_t{0};
+
+	while (true) {
+		job_ready.wait(lock, [&] {
+			return stopping || generation != seen_generation;
+		});
+
+		if (stopping) {
+			return;
+		}
+
+		seen_generation = generation;
+		if (each_thread) {
+			auto function = job;
+			lock.unlock();
+			(*function)(index);
+			lock.lock();
+
+			if (--parts_left == 0) {
+				job_done.notify_all();
+			}
+		} else {
+			run_parts(lock);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/**
+ * @file work_stealing_pool.cpp
+ * Defines the WorkStealingPool class
+ */
+
+#include "util/work_stealing_pool.h"
+
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(std::size_t thread_count)
+    : thread_count(thread_count), steals(0) {
+	if (this->thread_count == 0) {
+		this->thread_count =
+		    std::max(1u, std::thread::hardware_concurrency());
+	}
+}
+
+void WorkStealingPool::run(
+    std::size_t tasks,
+    const std::function<void(std::size_t, std::size_t)> &function) {
+	steals = 0;
+	if (tasks == 0) {
+		return;
+	}
+
+	// Deal out the tasks in blocks, so that each thread's share is in order
+	queues.clear();
+	for (auto worker = std::size_t{0}; worker < thread_count; ++worker) {
+		auto queue = std::make_unique<WorkQueue>();
+		auto begin = worker * tasks / thread_count;
+		auto end = (worker + 1) * tasks / thread_count;
+		for (auto task = begin; task < end; ++task) {
+			queue->tasks.push_back(task);
+		}
+		queues.push_back(std::move(queue));
+	}
+
+	auto work = [&](std::size_t worker) {
+		auto task = std::size_t{0};
+		while (take_task(worker, task)) {
+			function(task, worker);
+		}
+	};
+
+	// The calling thread is worker 0
+	auto threads = std::vector<std::thread>();
+	for (auto worker = std::size_t{1}; worker < thread_count; ++worker) {
+		threads.emplace_back(work, worker);
+	}
+	work(0);
+
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	queues.clear();
+}
+
+bool WorkStealingPool::take_task(std::size_t worker, std::size_t &task) {
+	{
+		auto &own = *queues[worker];
+		auto lock = std::unique_lock<std::mutex>(own.mutex);
+		if (!own.tasks.empty()) {
+			task = own.tasks.front();
+			own.tasks.pop_front();
+			return true;
+		}
+	}
+
+	// Tasks are never added during a run, so once every queue has been seen
+	// empty there is nothing left to do
+	for (auto i = std::size_t{1}; i < thread_count; ++i) {
+		auto &victim = *queues[(worker + i) % thread_count];
+		auto lock = std::unique_lock<std::mutex>(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = victim.tasks.back();
+			victim.tasks.pop_back();
+			steals++;
+			return true;
+		}
+	}
+	return false;
+}
+
+std::size_t WorkStealingPool::get_thread_count() const { return thread_count; }
+
+uint64_t WorkStealingPool::get_steal_count() const { return steals; }
@@ -0,0 +1,59 @@
+/**
+ * @file buffer_video.h
+ * Declares the BufferVideo class, a Video driver without a display
+ */
+#pragma once
+
+#include "gpu/utils.h"
+#include "video/video_interface.h"
+
+#include <cstdint>
+
+namespace video {
+
+/**
+ * Headless Video driver. Instead of drawing to a window, it keeps a copy of
+ * the last painted frame around so that it can be handed back to the caller.
+ * Painting never blocks, so the emulator runs unthrottled with this driver.
+ */
+class BufferVideo : public VideoInterface {
+  private:
+	/**
+	 * Contents of the most recently painted frame
+	 */
+	gpu::VideoBuffer buffer;
+
+	/**
+	 * Number of frames painted or repeated so far
+	 */
+	uint64_t frame_count;
+
+  public:
+	/**
+	 * Constructor
+	 */
+	BufferVideo();
+
+	/**
+	 * @see VideoInterface#paint
+	 */
+	void paint(gpu::VideoBuffer &v_buffer,
+	           const gpu::FrameInfo &info) override;
+
+	/**
+	 * @see VideoInterface#repeat
+	 */
+	void repeat(const gpu::FrameInfo &info) override;
+
+	/**
+	 * Get the most recently painted frame
+	 */
+	const gpu::VideoBuffer &get_buffer() const;
+
+	/**
+	 * Get the number of frames painted or repeated so far
+	 */
+	uint64_t get_frame_count() const;
+};
+
+} // namespace video
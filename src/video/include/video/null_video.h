@@ -0,0 +1,30 @@
+/**
+ * @file null_video.h
+ * Declares the NullVideo class, a Video driver that drops every frame
+ */
+#pragma once
+
+#include "gpu/utils.h"
+#include "video/video_interface.h"
+
+namespace video {
+
+/**
+ * Video driver that keeps nothing, for Gameboys whose frames are only ever
+ * drawn into a render target, or not at all
+ */
+class NullVideo : public VideoInterface {
+  public:
+	/**
+	 * @see VideoInterface#paint
+	 */
+	void paint(gpu::VideoBuffer &v_buffer,
+	           const gpu::FrameInfo &info) override;
+
+	/**
+	 * @see VideoInterface#repeat
+	 */
+	void repeat(const gpu::FrameInfo &info) override;
+};
+
+} // namespace video
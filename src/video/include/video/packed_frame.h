@@ -0,0 +1,31 @@
+/**
+ * @file packed_frame.h
+ * Declares the PackedFrame type, a frame stored at 2 bits per pixel
+ */
+#pragma once
+
+#include "gpu/utils.h"
+
+#include <array>
+#include <cstdint>
+
+namespace video {
+
+/**
+ * A frame with 4 pixels packed into every byte, with the first pixel in the
+ * lowest 2 bits. It is a quarter of the size of a VideoBuffer, which makes it
+ * cheaper to queue, store and send.
+ */
+using PackedFrame = std::array<uint8_t, gpu::PIXEL_COUNT / 4>;
+
+/**
+ * Pack a frame into 2 bits per pixel
+ */
+void pack_frame(const gpu::VideoBuffer &frame, PackedFrame &packed);
+
+/**
+ * Unpack a frame packed with pack_frame
+ */
+void unpack_frame(const PackedFrame &packed, gpu::VideoBuffer &frame);
+
+} // namespace video
@@ -0,0 +1,27 @@
+/**
+ * @file palette.h
+ * Declares the colors that frames are displayed in
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace video {
+
+/**
+ * RGBA colors for each of the 4 pixel shades, indexed by the Pixel value
+ */
+using Palette = std::array<std::array<uint8_t, 4>, 4>;
+
+/**
+ * Shades of grey that frames are shown and recorded in
+ */
+const Palette DEFAULT_PALETTE = {{
+    {255, 255, 255, 255}, // Pixel::ZERO
+    {85, 85, 85, 255},    // Pixel::ONE
+    {170, 170, 170, 255}, // Pixel::TWO
+    {0, 0, 0, 255},       // Pixel::THREE
+}};
+
+} // namespace video
@@ -0,0 +1,200 @@
+/**
+ * @file recording_video.h
+ * Declares the RecordingVideo class, a Video driver that records to a file
+ */
+#pragma once
+
+#include "gpu/utils.h"
+#include "util/spsc_queue.h"
+#include "video/packed_frame.h"
+#include "video/video_interface.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace video {
+
+/**
+ * File formats that frames can be recorded in
+ */
+enum class RecordFormat {
+	/**
+	 * YUV4MPEG2 video in greyscale, which most video tools can read
+	 */
+	Y4M,
+	/**
+	 * Raw RGBA frames one after the other, for piping into other programs
+	 */
+	RGBA,
+	/**
+	 * Compact tvp format. A "TVPV" header and a version byte, followed by
+	 * records. An 'F' record is a frame packed at 2 bits per pixel, and an
+	 * 'R' record is a little endian uint32 count of times that the previous
+	 * frame is repeated.
+	 */
+	PACKED
+};
+
+/**
+ * Pick a record format from the extension of a file name: .y4m, .rgba, or
+ * .tvpv for the packed format
+ */
+std::optional<RecordFormat> get_record_format(const std::string &path);
+
+/**
+ * A frame waiting to be written, along with the number of times that it is
+ * repeated after it is first shown
+ */
+struct RecordedFrame {
+	PackedFrame pixels;
+	uint32_t repeats;
+};
+
+/**
+ * Video driver that records every frame to a file, and passes it on to
+ * another driver to be displayed.
+ *
+ * The emulation thread only packs each frame and puts it in a queue, and a
+ * writer thread converts the frames and writes them out in large blocks, so
+ * that recording costs the emulator as little time as possible.
+ */
+class RecordingVideo : public VideoInterface {
+  private:
+	/**
+	 * Number of frames that can wait for the writer before painting blocks
+	 */
+	static constexpr std::size_t QUEUE_SIZE = 64;
+
+	/**
+	 * Amount of output that is collected before it is written to the file
+	 */
+	static constexpr std::size_t WRITE_SIZE = 1 << 20;
+
+	/**
+	 * Driver that frames are passed on to
+	 */
+	std::unique_ptr<VideoInterface> output;
+
+	/**
+	 * Format of the recording
+	 */
+	RecordFormat format;
+
+	/**
+	 * File being recorded to
+	 */
+	std::ofstream file;
+
+	/**
+	 * Frames passed from the emulation thread to the writer thread
+	 */
+	SPSCQueue<RecordedFrame, QUEUE_SIZE> queue;
+
+	/**
+	 * The last painted frame. It is held back until the next frame is
+	 * painted, so that any repeats in between can be counted first.
+	 */
+	RecordedFrame pending;
+
+	/**
+	 * Set once the first frame has been painted
+	 */
+	bool has_pending;
+
+	/**
+	 * Output collected by the writer thread, waiting to be written
+	 */
+	std::vector<char> write_buffer;
+
+	/**
+	 * Output bytes for each packed byte of a frame, which holds 4 pixels.
+	 * Converting through this is much faster than unpacking the frame first.
+	 */
+	std::vector<uint8_t> byte_table;
+
+	/**
+	 * Scratch space for the writer thread to convert frames in
+	 */
+	std::vector<uint8_t> converted;
+
+	/**
+	 * Set when the writer thread should finish up and exit
+	 */
+	std::atomic<bool> stopping;
+
+	/**
+	 * Thread that converts and writes frames
+	 */
+	std::thread writer;
+
+	/**
+	 * Queue the pending frame for the writer, waiting if the queue is full
+	 */
+	void queue_pending();
+
+	/**
+	 * Main loop of the writer thread
+	 */
+	void writer_loop();
+
+	/**
+	 * Convert a frame to the record format and add it to the output
+	 */
+	void write_frame(const RecordedFrame &frame);
+
+	/**
+	 * Add some bytes to the output, writing it out if it is large enough
+	 */
+	void write(const void *data, std::size_t size);
+
+	/**
+	 * Write all the collected output to the file
+	 */
+	void flush();
+
+  public:
+	/**
+	 * Start recording to a file
+	 *
+	 * @param output Driver that frames are passed on to
+	 * @param path Path of the file to record to
+	 * @param format Format to record in
+	 */
+	RecordingVideo(std::unique_ptr<VideoInterface> output,
+	               const std::string &path, RecordFormat format);
+
+	/**
+	 * Write out any frames still in the queue, and close the file
+	 */
+	~RecordingVideo();
+
+	/**
+	 * Check if the file was opened successfully
+	 */
+	bool is_open() const;
+
+	/**
+	 * Get the driver that frames are passed on to
+	 */
+	VideoInterface *get_output() const;
+
+	/**
+	 * @see VideoInterface#paint
+	 */
+	void paint(gpu::VideoBuffer &v_buffer,
+	           const gpu::FrameInfo &info) override;
+
+	/**
+	 * @see VideoInterface#repeat
+	 */
+	void repeat(const gpu::FrameInfo &info) override;
+};
+
+} // namespace video
@@ -0,0 +1,223 @@
+/**
+ * @file scaler.h
+ * Declares the pixel art scalers, and the ScalerPipeline that runs them
+ */
+#pragma once
+
+#include "gpu/utils.h"
+#include "util/thread_pool.h"
+#include "video/palette.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace video {
+
+/**
+ * The available scaling algorithms
+ */
+enum class ScalerType {
+	/**
+	 * Don't scale at all, leave it to the window
+	 */
+	NONE,
+	/**
+	 * Repeat every pixel by an integer factor
+	 */
+	NEAREST,
+	/**
+	 * Scale2x (AdvMAME2x) edge smoothing
+	 */
+	SCALE2X,
+	/**
+	 * Scale3x (AdvMAME3x) edge smoothing
+	 */
+	SCALE3X
+};
+
+/**
+ * Get the ScalerType for a name given on the command line
+ */
+std::optional<ScalerType> get_scaler_type(const std::string &name);
+
+/**
+ * Interface for algorithms that scale up a frame by an integer factor.
+ *
+ * Scalers work on Pixel values rather than colors, since a GameBoy frame only
+ * has 4 of them. Rows are independent of each other, so a frame can be split
+ * into strips and scaled on several threads at once.
+ */
+class ScalerInterface {
+  public:
+	virtual ~ScalerInterface(){};
+
+	/**
+	 * Get the factor that both dimensions are scaled up by
+	 */
+	virtual unsigned int get_factor() const = 0;
+
+	/**
+	 * Scale some rows of a frame
+	 *
+	 * @param input The whole frame to scale
+	 * @param output Output frame, get_factor() times wider and taller
+	 * @param row_start First input row to scale
+	 * @param row_end One past the last input row to scale
+	 */
+	virtual void scale_rows(const gpu::VideoBuffer &input, gpu::Pixel *output,
+	                        unsigned int row_start,
+	                        unsigned int row_end) const = 0;
+};
+
+/**
+ * Nearest neighbour scaler, which turns every pixel into a square block
+ */
+class NearestScaler : public ScalerInterface {
+  private:
+	/**
+	 * Scale factor
+	 */
+	unsigned int factor;
+
+  public:
+	/**
+	 * Constructor
+	 */
+	NearestScaler(unsigned int factor);
+
+	/**
+	 * @see ScalerInterface#get_factor
+	 */
+	unsigned int get_factor() const override;
+
+	/**
+	 * @see ScalerInterface#scale_rows
+	 */
+	void scale_rows(const gpu::VideoBuffer &input, gpu::Pixel *output,
+	                unsigned int row_start,
+	                unsigned int row_end) const override;
+};
+
+/**
+ * Scale2x scaler, which rounds off diagonal edges while doubling the size
+ */
+class Scale2xScaler : public ScalerInterface {
+  public:
+	/**
+	 * @see ScalerInterface#get_factor
+	 */
+	unsigned int get_factor() const override;
+
+	/**
+	 * @see ScalerInterface#scale_rows
+	 */
+	void scale_rows(const gpu::VideoBuffer &input, gpu::Pixel *output,
+	                unsigned int row_start,
+	                unsigned int row_end) const override;
+};
+
+/**
+ * Scale3x scaler, which rounds off diagonal edges while tripling the size
+ */
+class Scale3xScaler : public ScalerInterface {
+  public:
+	/**
+	 * @see ScalerInterface#get_factor
+	 */
+	unsigned int get_factor() const override;
+
+	/**
+	 * @see ScalerInterface#scale_rows
+	 */
+	void scale_rows(const gpu::VideoBuffer &input, gpu::Pixel *output,
+	                unsigned int row_start,
+	                unsigned int row_end) const override;
+};
+
+/**
+ * Create a scaler
+ *
+ * @param type Algorithm to use
+ * @param factor Scale factor, only used by the nearest neighbour scaler
+ */
+std::unique_ptr<ScalerInterface> make_scaler(ScalerType type,
+                                             unsigned int factor);
+
+/**
+ * Turns frames into scaled RGBA images ready to be uploaded to a texture.
+ *
+ * The frame is split into horizontal strips which are scaled and colored on
+ * a thread pool, so that the cost of the bigger scalers is spread over the
+ * cores of the machine instead of adding to the frame time of one thread.
+ */
+class ScalerPipeline {
+  private:
+	/**
+	 * The scaling algorithm
+	 */
+	std::unique_ptr<ScalerInterface> scaler;
+
+	/**
+	 * Colors that each Pixel value is converted to
+	 */
+	Palette palette;
+
+	/**
+	 * Threads that the strips are processed on
+	 */
+	ThreadPool pool;
+
+	/**
+	 * Number of input rows in each strip
+	 */
+	unsigned int strip_rows;
+
+	/**
+	 * Scaled frame, before colors are applied
+	 */
+	std::vector<gpu::Pixel> scaled;
+
+	/**
+	 * Scaled frame in RGBA
+	 */
+	std::vector<uint8_t> rgba;
+
+	/**
+	 * Scale and color one strip of the frame
+	 */
+	void process_strip(const gpu::VideoBuffer &frame, unsigned int strip);
+
+  public:
+	/**
+	 * Constructor
+	 *
+	 * @param scaler The scaling algorithm
+	 * @param palette Colors for each Pixel value
+	 * @param thread_count Threads to use, 0 for one per hardware thread
+	 */
+	ScalerPipeline(std::unique_ptr<ScalerInterface> scaler,
+	               const Palette &palette, unsigned int thread_count = 0);
+
+	/**
+	 * Scale a frame and convert it to RGBA
+	 *
+	 * @return Pointer to get_width() * get_height() RGBA pixels, valid until
+	 *         the next call
+	 */
+	const uint8_t *process(const gpu::VideoBuffer &frame);
+
+	/**
+	 * Get the width of the output, in pixels
+	 */
+	unsigned int get_width() const;
+
+	/**
+	 * Get the height of the output, in pixels
+	 */
+	unsigned int get_height() const;
+};
+
+} // namespace video
@@ -0,0 +1,167 @@
+/**
+ * @file shared_frames.h
+ * Declares the layout of the shared memory frame ring, and a reader for it
+ */
+#pragma once
+
+#include "gpu/utils.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace video {
+
+/**
+ * Magic number at the start of the shared memory, "TVPS" in little endian
+ */
+const uint32_t SHARED_FRAMES_MAGIC = 0x53505654;
+
+/**
+ * Version of the shared memory layout
+ */
+const uint32_t SHARED_FRAMES_VERSION = 2;
+
+/**
+ * Flag set on a slot whose pixels are the same as the frame before, because
+ * the frame was repeated or skipped
+ */
+const uint32_t SHARED_FRAME_UNCHANGED = 1;
+
+// The atomics below are used by several processes through shared memory,
+// which only works if they are implemented without locks
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "Shared frames need lock-free atomics");
+
+/**
+ * Header at the start of the shared memory. The slots follow right after it.
+ */
+struct alignas(64) SharedFramesHeader {
+	uint32_t magic;
+	uint32_t version;
+
+	/**
+	 * Number of slots in the ring
+	 */
+	uint32_t slot_count;
+
+	/**
+	 * Size of each slot in bytes, including padding
+	 */
+	uint32_t slot_size;
+
+	/**
+	 * Size of the frames, in pixels
+	 */
+	uint32_t width;
+	uint32_t height;
+
+	/**
+	 * Number of frames published so far. The newest frame is in slot
+	 * (frames_published - 1) % slot_count
+	 */
+	std::atomic<uint64_t> frames_published;
+};
+
+/**
+ * One slot of the ring, holding a frame.
+ *
+ * The slot is protected by a seqlock. The sequence is odd while the frame is
+ * being written, and increases again once it is done. A reader reads the
+ * sequence, then the frame, then the sequence again, and the frame is only
+ * valid if both reads match and are even. Readers can work on the frame in
+ * place this way, without copying it out first.
+ */
+struct alignas(64) SharedFrameSlot {
+	std::atomic<uint32_t> sequence;
+
+	/**
+	 * SHARED_FRAME_UNCHANGED or 0. The pixels are always the whole frame, so
+	 * readers can use this to skip work, or ignore it.
+	 */
+	uint32_t flags;
+
+	/**
+	 * Frame number and timestamp of the frame
+	 */
+	uint64_t number;
+	uint64_t cycles;
+
+	/**
+	 * Pixels of the frame, one Pixel value per byte
+	 */
+	gpu::VideoBuffer pixels;
+};
+
+/**
+ * Get the size of shared memory needed for a ring with some number of slots
+ */
+std::size_t get_shared_frames_size(uint32_t slot_count);
+
+/**
+ * Turn a name into a valid POSIX shared memory name, which starts with a /
+ */
+std::string get_shared_memory_name(const std::string &name);
+
+/**
+ * Maps a shared memory frame ring read-only, and reads frames from it. Any
+ * number of readers can read the same ring, and they never slow down the
+ * emulator.
+ */
+class SharedFrameReader {
+  private:
+	/**
+	 * Start of the mapping, or nullptr if it couldn't be opened
+	 */
+	const SharedFramesHeader *header;
+
+	/**
+	 * Size of the mapping
+	 */
+	std::size_t size;
+
+  public:
+	/**
+	 * Open and map a ring by name
+	 */
+	SharedFrameReader(const std::string &name);
+
+	/**
+	 * Unmap the ring
+	 */
+	~SharedFrameReader();
+
+	SharedFrameReader(const SharedFrameReader &other) = delete;
+	SharedFrameReader &operator=(const SharedFrameReader &other) = delete;
+
+	/**
+	 * Check if the ring was mapped successfully
+	 */
+	bool is_open() const;
+
+	/**
+	 * Get the header of the ring
+	 */
+	const SharedFramesHeader *get_header() const;
+
+	/**
+	 * Get a slot of the ring
+	 */
+	const SharedFrameSlot *get_slot(uint32_t index) const;
+
+	/**
+	 * Copy out the newest frame
+	 *
+	 * @param frame Set to the pixels of the frame
+	 * @param info Set to the frame number and timestamp
+	 * @param unchanged If not null, set if the pixels are the same as the
+	 * frame before
+	 * @return false if no frame has been published yet
+	 */
+	bool read_latest(gpu::VideoBuffer &frame, gpu::FrameInfo &info,
+	                 bool *unchanged = nullptr) const;
+};
+
+} // namespace video
@@ -0,0 +1,120 @@
+/**
+ * @file shared_memory_video.h
+ * Declares the SharedMemoryVideo class, a Video driver that publishes frames
+ * to shared memory
+ */
+#pragma once
+
+#include "gpu/utils.h"
+#include "video/shared_frames.h"
+#include "video/video_interface.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace video {
+
+/**
+ * Video driver that publishes every frame into a ring of slots in POSIX
+ * shared memory, and passes it on to another driver to be displayed. Frames
+ * that are repeated or skipped are published too, marked as unchanged, so
+ * readers see the frame number and timestamp keep moving.
+ *
+ * Other processes can map the ring with a SharedFrameReader, or directly
+ * using the layout in shared_frames.h. Publishing never waits for readers.
+ * A reader that falls behind by more than the ring size simply misses
+ * frames, and one that is reading a slot while it is rewritten will see the
+ * sequence change and retry.
+ */
+class SharedMemoryVideo : public VideoInterface {
+  public:
+	/**
+	 * Default number of slots in the ring
+	 */
+	static constexpr uint32_t DEFAULT_SLOTS = 8;
+
+  private:
+	/**
+	 * Driver that frames are passed on to
+	 */
+	std::unique_ptr<VideoInterface> output;
+
+	/**
+	 * POSIX name of the shared memory
+	 */
+	std::string name;
+
+	/**
+	 * Start of the mapping, or nullptr if it couldn't be created
+	 */
+	SharedFramesHeader *header;
+
+	/**
+	 * Size of the mapping
+	 */
+	std::size_t size;
+
+	/**
+	 * Get a slot of the ring
+	 */
+	SharedFrameSlot *get_slot(uint32_t index);
+
+	/**
+	 * Publish a frame into the next slot
+	 *
+	 * @param pixels Pixels of the frame, or nullptr if they are unchanged
+	 * @param info Frame number and timestamp
+	 */
+	void publish(const gpu::VideoBuffer *pixels, const gpu::FrameInfo &info);
+
+  public:
+	/**
+	 * Create the shared memory and start publishing to it. The name must not
+	 * be in use already, by another emulator or one that didn't exit cleanly.
+	 *
+	 * @param output Driver that frames are passed on to
+	 * @param name Name of the shared memory
+	 * @param slot_count Number of slots in the ring
+	 */
+	SharedMemoryVideo(std::unique_ptr<VideoInterface> output,
+	                  const std::string &name,
+	                  uint32_t slot_count = DEFAULT_SLOTS);
+
+	/**
+	 * Unmap and remove the shared memory. Readers that still have it mapped
+	 * can keep reading the last frames.
+	 */
+	~SharedMemoryVideo();
+
+	SharedMemoryVideo(const SharedMemoryVideo &other) = delete;
+	SharedMemoryVideo &operator=(const SharedMemoryVideo &other) = delete;
+
+	/**
+	 * Check if the shared memory was created successfully
+	 */
+	bool is_open() const;
+
+	/**
+	 * Get the driver that frames are passed on to
+	 */
+	VideoInterface *get_output() const;
+
+	/**
+	 * Publish a frame, then pass it on
+	 *
+	 * @see VideoInterface#paint
+	 */
+	void paint(gpu::VideoBuffer &v_buffer,
+	           const gpu::FrameInfo &info) override;
+
+	/**
+	 * Publish a frame marked as unchanged, then pass it on
+	 *
+	 * @see VideoInterface#repeat
+	 */
+	void repeat(const gpu::FrameInfo &info) override;
+};
+
+} // namespace video
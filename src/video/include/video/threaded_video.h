@@ -0,0 +1,132 @@
+/**
+ * @file threaded_video.h
+ * Declares the ThreadedVideo class, which hands frames to another thread
+ */
+#pragma once
+
+#include "controller/utils.h"
+#include "gpu/utils.h"
+#include "util/frame_pacer.h"
+#include "util/triple_buffer.h"
+#include "video/video_interface.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace video {
+
+/**
+ * Video driver for running the emulator and the display on separate threads.
+ *
+ * The emulation thread paints frames into a triple buffer, and never waits on
+ * the display. The display thread picks up the newest finished frame whenever
+ * it is ready to draw, and sends input events back through a queue. The
+ * events are stamped with the cycle that the emulator is running as they are
+ * sent, worked out from the newest frame and the time since it, so that they
+ * land at the same point in the game however late the emulation thread
+ * picks them up.
+ */
+class ThreadedVideo : public VideoInterface {
+  private:
+	/**
+	 * Frames passed from the emulation thread to the display thread
+	 */
+	TripleBuffer<gpu::VideoBuffer> frames;
+
+	/**
+	 * Queue that input events are sent to the emulation thread through
+	 */
+	controller::InputQueue *inputs;
+
+	/**
+	 * Pacer of the emulation thread, for the speed that cycles go by at
+	 */
+	const FramePacer *pacer;
+
+	/**
+	 * Cycle count of the newest frame, and the time it was finished at, in
+	 * nanoseconds of the steady clock
+	 */
+	std::atomic<uint64_t> frame_cycles;
+	std::atomic<int64_t> frame_time;
+
+	/**
+	 * Note the cycle count and time of a finished frame
+	 */
+	void finish_frame(const gpu::FrameInfo &info);
+
+	/**
+	 * Set while the user holds the rewind key
+	 */
+	std::atomic<bool> rewinding;
+
+  public:
+	/**
+	 * Constructor
+	 *
+	 * @param inputs Queue for sending input events to the emulator
+	 * @param pacer Pacer of the emulation thread
+	 */
+	ThreadedVideo(controller::InputQueue *inputs, const FramePacer *pacer);
+
+	/**
+	 * Publish a finished frame. Called on the emulation thread.
+	 *
+	 * @see VideoInterface#paint
+	 */
+	void paint(gpu::VideoBuffer &v_buffer,
+	           const gpu::FrameInfo &info) override;
+
+	/**
+	 * Note the cycle count of the repeated frame. Called on the emulation
+	 * thread.
+	 *
+	 * @see VideoInterface#repeat
+	 */
+	void repeat(const gpu::FrameInfo &info) override;
+
+	/**
+	 * Get the newest frame, if one was painted since the last call. Called on
+	 * the display thread.
+	 *
+	 * @return Pointer to the new frame, or nullptr if there isn't one
+	 */
+	const gpu::VideoBuffer *get_new_frame();
+
+	/**
+	 * Queue an input event for the emulation thread. Called on the display
+	 * thread.
+	 *
+	 * @param button Button that changed
+	 * @param pressed True if the button was pressed, false if released
+	 * @return false if the queue was full, and the event was dropped
+	 */
+	bool send_input(controller::Button button, bool pressed);
+
+	/**
+	 * Work out the cycle that the emulator is running at a time, from the
+	 * newest frame and the speed of the pacer. It is never more than a frame
+	 * past the newest frame, so that input isn't held back for longer than
+	 * that when emulation falls behind. In turbo mode there is no telling,
+	 * so it is the cycle of the newest frame.
+	 *
+	 * @param now Time to work out the cycle for
+	 */
+	uint64_t project_cycle(std::chrono::steady_clock::time_point now) const;
+
+	/**
+	 * Start or stop rewinding. Called on the display thread.
+	 *
+	 * @param rewind True while the rewind key is held
+	 */
+	void set_rewinding(bool rewind);
+
+	/**
+	 * Check if the emulator should be rewinding. Called on the emulation
+	 * thread.
+	 */
+	bool is_rewinding() const;
+};
+
+} // namespace video
@@ -5,17 +5,23 @@
 #pragma once
 
 #include "cartridge/cartridge_metadata.h"
-#include "controller/controller_interface.h"
 #include "gpu/utils.h"
-#include "video/video_interface.h"
+#include "util/frame_pacer.h"
+#include "video/scaler.h"
+#include "video/threaded_video.h"
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
-#include <array>
+#include <memory>
 
 namespace video {
 
-class Video : public VideoInterface {
+/**
+ * The SFML window that displays the emulator output. It runs on its own
+ * thread, which owns all the SFML state, and takes frames from the emulation
+ * thread through a ThreadedVideo driver.
+ */
+class Video {
   private:
 	/**
 	 * Window context that the application will be rendered in
@@ -23,24 +29,31 @@ class Video : public VideoInterface {
 	std::unique_ptr<sf::RenderWindow> window;
 
 	/**
-	 * Window texture, that serves as an in-memory buffer of the output pixels
+	 * Window texture, that holds the output of the scaler. It is updated in
+	 * place every frame, and stretched to the window size by the sprite.
 	 */
 	std::unique_ptr<sf::Texture> window_texture;
 
 	/**
-	 * Window image, that the texture is loaded
+	 * Window sprite that the texture is loaded to
 	 */
-	std::unique_ptr<sf::Image> window_image;
+	std::unique_ptr<sf::Sprite> window_sprite;
 
 	/**
-	 * Window sprite that the texture is loaded to
+	 * Scales and colors each new frame before it is uploaded to the texture
 	 */
-	std::unique_ptr<sf::Sprite> window_sprite;
+	ScalerPipeline scaler;
+
+	/**
+	 * Driver that the emulation thread paints frames to, and that input
+	 * events are sent through
+	 */
+	ThreadedVideo *emulator_video;
 
 	/**
-	 * Pointer to controller instance
+	 * Pacer of the emulation thread, controlled from the keyboard
 	 */
-	controller::ControllerInterface *controller;
+	FramePacer *pacer;
 
 	/**
 	 * Pointer to cartridge instance
@@ -52,17 +65,42 @@ class Video : public VideoInterface {
 	 */
 	void event_handler();
 
+	/**
+	 * Handle the keys that control emulation speed
+	 *
+	 * @return true if the key was a speed control
+	 */
+	bool handle_speed_key(sf::Keyboard::Key key);
+
+	/**
+	 * Set the window title to the game title, and the speed if it isn't 1x
+	 */
+	void update_title();
+
   public:
 	/**
 	 * Constructor
+	 *
+	 * @param emulator_video Driver that the emulator paints to
+	 * @param pacer Pacer of the emulation thread
+	 * @param cartridge_metadata Metadata of the running cartridge
+	 * @param scaler_type Algorithm that frames are scaled up with
+	 * @param scale Size of the window, as a multiple of the LCD size
+	 */
+	Video(ThreadedVideo *emulator_video, FramePacer *pacer,
+	      cartridge::CartridgeMetadata *cartridge_metadata,
+	      ScalerType scaler_type = ScalerType::NONE, unsigned int scale = 3);
+
+	/**
+	 * Check if the window is still open
 	 */
-	Video(controller::ControllerInterface *controller,
-	      cartridge::CartridgeMetadata *cartridge_metadata);
+	bool is_open() const;
 
 	/**
-	 * Print the contents of the buffer to the terminal
+	 * Handle window events, upload the newest frame from the emulator if
+	 * there is one, and display the window. Blocks on vertical sync.
 	 */
-	void paint(gpu::VideoBuffer &v_buffer);
+	void present();
 };
 
 } // namespace video
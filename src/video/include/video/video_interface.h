@@ -12,12 +12,28 @@ namespace video {
 
 class VideoInterface {
   public:
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~VideoInterface(){};
+
 	/**
 	 * This method takes a VideoBuffer array, and outputs it to the display
 	 *
 	 * @param v_buffer Buffer to display
+	 * @param info Frame number and timestamp of the buffer
+	 */
+	virtual void paint(gpu::VideoBuffer &v_buffer,
+	                   const gpu::FrameInfo &info) = 0;
+
+	/**
+	 * Called instead of paint when a frame is the same as the last painted
+	 * one, or was skipped and not rendered at all. The display keeps showing
+	 * the last frame.
+	 *
+	 * @param info Frame number and timestamp of the repeated frame
 	 */
-	virtual void paint(gpu::VideoBuffer &v_buffer) = 0;
+	virtual void repeat(const gpu::FrameInfo &info) = 0;
 };
 
 } // namespace video
@@ -0,0 +1,25 @@
+/**
+ * @file buffer_video.cpp
+ * Defines the headless BufferVideo driver
+ */
+
+#include "video/buffer_video.h"
+
+using namespace gpu;
+
+namespace video {
+
+BufferVideo::BufferVideo() : buffer({}), frame_count(0) {}
+
+void BufferVideo::paint(VideoBuffer &v_buffer, const FrameInfo &) {
+	buffer = v_buffer;
+	frame_count++;
+}
+
+void BufferVideo::repeat(const FrameInfo &) { frame_count++; }
+
+const VideoBuffer &BufferVideo::get_buffer() const { return buffer; }
+
+uint64_t BufferVideo::get_frame_count() const { return frame_count; }
+
+} // namespace video
@@ -0,0 +1,16 @@
+/**
+ * @file null_video.cpp
+ * Defines the NullVideo driver
+ */
+
+#include "video/null_video.h"
+
+using namespace gpu;
+
+namespace video {
+
+void NullVideo::paint(VideoBuffer &, const FrameInfo &) {}
+
+void NullVideo::repeat(const FrameInfo &) {}
+
+} // namespace video
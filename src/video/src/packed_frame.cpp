@@ -0,0 +1,30 @@
+/**
+ * @file packed_frame.cpp
+ * Defines packing and unpacking of frames
+ */
+
+#include "video/packed_frame.h"
+
+using namespace gpu;
+
+namespace video {
+
+void pack_frame(const VideoBuffer &frame, PackedFrame &packed) {
+	auto pixels = reinterpret_cast<const uint8_t *>(frame.data());
+
+	for (auto i = 0u; i < packed.size(); ++i) {
+		packed[i] = (pixels[i * 4] & 0x3) | (pixels[i * 4 + 1] & 0x3) << 2 |
+		            (pixels[i * 4 + 2] & 0x3) << 4 |
+		            (pixels[i * 4 + 3] & 0x3) << 6;
+	}
+}
+
+void unpack_frame(const PackedFrame &packed, VideoBuffer &frame) {
+	for (auto i = 0u; i < packed.size(); ++i) {
+		for (auto j = 0u; j < 4; ++j) {
+			frame[i * 4 + j] = static_cast<Pixel>((packed[i] >> (j * 2)) & 0x3);
+		}
+	}
+}
+
+} // namespace video
@@ -0,0 +1,208 @@
+/**
+ * @file recording_video.cpp
+ * Defines the RecordingVideo driver
+ */
+
+#include "video/recording_video.h"
+#include "util/log.h"
+#include "video/palette.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace gpu;
+
+namespace video {
+
+/**
+ * Header of a Y4M recording. The frame rate is the exact GameBoy frame rate,
+ * the clock speed over the number of cycles in a frame
+ */
+const std::string Y4M_HEADER = "YUV4MPEG2 W160 H144 F4194304:70224 Ip A1:1 "
+                               "Cmono\n";
+const std::string Y4M_FRAME = "FRAME\n";
+
+/**
+ * Header of a packed recording, and the version of the format
+ */
+const std::string PACKED_HEADER = "TVPV";
+const uint8_t PACKED_VERSION = 1;
+
+/**
+ * Convert a packed frame through a table of output bytes for each packed byte
+ *
+ * @tparam Size Number of output bytes for each packed byte
+ */
+template <std::size_t Size>
+static void expand_frame(const PackedFrame &packed, const uint8_t *table,
+                         uint8_t *output) {
+	for (auto i = 0u; i < packed.size(); ++i) {
+		std::memcpy(output + i * Size, table + packed[i] * Size, Size);
+	}
+}
+
+static bool ends_with(const std::string &text, const std::string &suffix) {
+	return text.size() >= suffix.size() &&
+	       text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+	           0;
+}
+
+std::optional<RecordFormat> get_record_format(const std::string &path) {
+	if (ends_with(path, ".y4m")) {
+		return RecordFormat::Y4M;
+	} else if (ends_with(path, ".rgba")) {
+		return RecordFormat::RGBA;
+	} else if (ends_with(path, ".tvpv")) {
+		return RecordFormat::PACKED;
+	}
+
+	return {};
+}
+
+RecordingVideo::RecordingVideo(std::unique_ptr<VideoInterface> output,
+                               const std::string &path, RecordFormat format)
+    : output(std::move(output)), format(format),
+      file(path, std::ios::out | std::ios::binary), pending({}),
+      has_pending(false), stopping(false) {
+	if (!file.is_open()) {
+		Log::error("Could not open " + path + " for recording");
+		return;
+	}
+
+	write_buffer.reserve(WRITE_SIZE * 2);
+
+	// Y4M only has the luma plane, and the palette is grey anyway
+	auto channels = format == RecordFormat::Y4M ? 1u : 4u;
+	byte_table.resize(256 * 4 * channels);
+	for (auto byte = 0u; byte < 256; ++byte) {
+		for (auto pixel = 0u; pixel < 4; ++pixel) {
+			auto &color = DEFAULT_PALETTE[(byte >> (pixel * 2)) & 0x3];
+			std::memcpy(&byte_table[(byte * 4 + pixel) * channels],
+			            color.data(), channels);
+		}
+	}
+	converted.resize(PIXEL_COUNT * channels);
+
+	if (format == RecordFormat::Y4M) {
+		write(Y4M_HEADER.data(), Y4M_HEADER.size());
+	} else if (format == RecordFormat::PACKED) {
+		write(PACKED_HEADER.data(), PACKED_HEADER.size());
+		write(&PACKED_VERSION, sizeof(PACKED_VERSION));
+	}
+
+	writer = std::thread([this] { writer_loop(); });
+}
+
+RecordingVideo::~RecordingVideo() {
+	if (!writer.joinable()) {
+		return;
+	}
+
+	queue_pending();
+	stopping = true;
+	writer.join();
+}
+
+bool RecordingVideo::is_open() const { return file.is_open(); }
+
+VideoInterface *RecordingVideo::get_output() const { return output.get(); }
+
+void RecordingVideo::paint(VideoBuffer &v_buffer, const FrameInfo &info) {
+	if (writer.joinable()) {
+		queue_pending();
+		pack_frame(v_buffer, pending.pixels);
+		pending.repeats = 0;
+		has_pending = true;
+	}
+
+	output->paint(v_buffer, info);
+}
+
+void RecordingVideo::repeat(const FrameInfo &info) {
+	if (has_pending) {
+		pending.repeats++;
+	}
+
+	output->repeat(info);
+}
+
+void RecordingVideo::queue_pending() {
+	if (!has_pending) {
+		return;
+	}
+
+	// Frames are never dropped. If the writer has fallen this far behind,
+	// the emulator waits for it.
+	while (!queue.push(pending)) {
+		std::this_thread::yield();
+	}
+}
+
+void RecordingVideo::writer_loop() {
+	while (true) {
+		if (auto frame = queue.peek()) {
+			write_frame(*frame);
+			queue.pop();
+			continue;
+		}
+
+		// Everything has been queued before stopping is set, so the queue
+		// only has to be checked once more
+		if (stopping && queue.empty()) {
+			break;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	flush();
+}
+
+void RecordingVideo::write_frame(const RecordedFrame &frame) {
+	if (format == RecordFormat::PACKED) {
+		write("F", 1);
+		write(frame.pixels.data(), frame.pixels.size());
+
+		if (frame.repeats > 0) {
+			uint8_t count[4];
+			for (auto i = 0; i < 4; ++i) {
+				count[i] = (frame.repeats >> (i * 8)) & 0xFF;
+			}
+			write("R", 1);
+			write(count, sizeof(count));
+		}
+		return;
+	}
+
+	if (format == RecordFormat::Y4M) {
+		expand_frame<4>(frame.pixels, byte_table.data(), converted.data());
+	} else {
+		expand_frame<16>(frame.pixels, byte_table.data(), converted.data());
+	}
+
+	// The other formats have no way of marking repeats, so write the frame
+	// again for each one
+	for (auto i = 0u; i <= frame.repeats; ++i) {
+		if (format == RecordFormat::Y4M) {
+			write(Y4M_FRAME.data(), Y4M_FRAME.size());
+		}
+		write(converted.data(), converted.size());
+	}
+}
+
+void RecordingVideo::write(const void *data, std::size_t size) {
+	auto bytes = static_cast<const char *>(data);
+	write_buffer.insert(write_buffer.end(), bytes, bytes + size);
+
+	if (write_buffer.size() >= WRITE_SIZE) {
+		flush();
+	}
+}
+
+void RecordingVideo::flush() {
+	file.write(write_buffer.data(), write_buffer.size());
+	file.flush();
+	write_buffer.clear();
+}
+
+} // namespace video
@@ -0,0 +1,252 @@
+/**
+ * @file scaler.cpp
+ * Defines the pixel art scalers, and the ScalerPipeline that runs them
+ */
+
+#include "video/scaler.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace gpu;
+
+namespace video {
+
+/**
+ * Get a row of the input. Rows outside the frame are clamped to the nearest
+ * edge, so that the scalers can look at the rows above and below any row
+ */
+static const Pixel *get_row(const VideoBuffer &input, int row) {
+	row = std::clamp(row, 0, SCREEN_HEIGHT - 1);
+	return &input[row * SCREEN_WIDTH];
+}
+
+// The per pixel functions below are branch free so that the row loops calling
+// them can be vectorized by the compiler. The four neighbour comparisons are
+// done once and shared, and they are combined with & instead of &&, which
+// would add branches.
+
+/**
+ * Scale2x one pixel E into a 2x2 block
+ *
+ *   B       E0 E1
+ * D E F  => E2 E3
+ *   H
+ */
+static inline void scale2x_pixel(Pixel b, Pixel d, Pixel e, Pixel f, Pixel h,
+                                 Pixel *top, Pixel *bottom) {
+	auto db = d == b;
+	auto bf = b == f;
+	auto dh = d == h;
+	auto hf = h == f;
+
+	top[0] = (db & !bf & !dh) ? d : e;
+	top[1] = (bf & !db & !hf) ? f : e;
+	bottom[0] = (dh & !db & !hf) ? d : e;
+	bottom[1] = (hf & !dh & !bf) ? f : e;
+}
+
+/**
+ * Scale3x one pixel E into a 3x3 block
+ *
+ * A B C    E0 E1 E2
+ * D E F => E3 E4 E5
+ * G H I    E6 E7 E8
+ */
+static inline void scale3x_pixel(const Pixel *up, const Pixel *mid,
+                                 const Pixel *down, Pixel *top, Pixel *center,
+                                 Pixel *bottom) {
+	auto a = up[0], b = up[1], c = up[2];
+	auto d = mid[0], e = mid[1], f = mid[2];
+	auto g = down[0], h = down[1], i = down[2];
+
+	auto db = d == b;
+	auto bf = b == f;
+	auto dh = d == h;
+	auto hf = h == f;
+
+	// Which of the four corners have an edge running across them
+	auto top_left = db & !bf & !dh;
+	auto top_right = bf & !db & !hf;
+	auto bottom_left = dh & !db & !hf;
+	auto bottom_right = hf & !dh & !bf;
+
+	top[0] = top_left ? d : e;
+	top[1] = ((top_left & (e != c)) | (top_right & (e != a))) ? b : e;
+	top[2] = top_right ? f : e;
+	center[0] = ((top_left & (e != g)) | (bottom_left & (e != a))) ? d : e;
+	center[1] = e;
+	center[2] = ((top_right & (e != i)) | (bottom_right & (e != c))) ? f : e;
+	bottom[0] = bottom_left ? d : e;
+	bottom[1] = ((bottom_left & (e != i)) | (bottom_right & (e != g))) ? h : e;
+	bottom[2] = bottom_right ? f : e;
+}
+
+std::optional<ScalerType> get_scaler_type(const std::string &name) {
+	if (name == "none") {
+		return ScalerType::NONE;
+	} else if (name == "nearest") {
+		return ScalerType::NEAREST;
+	} else if (name == "scale2x") {
+		return ScalerType::SCALE2X;
+	} else if (name == "scale3x") {
+		return ScalerType::SCALE3X;
+	}
+
+	return {};
+}
+
+NearestScaler::NearestScaler(unsigned int factor)
+    : factor(std::max(factor, 1u)) {}
+
+unsigned int NearestScaler::get_factor() const { return factor; }
+
+void NearestScaler::scale_rows(const VideoBuffer &input, Pixel *output,
+                               unsigned int row_start,
+                               unsigned int row_end) const {
+	auto out_width = SCREEN_WIDTH * factor;
+
+	for (auto row = row_start; row < row_end; ++row) {
+		auto source = &input[row * SCREEN_WIDTH];
+		auto first = output + row * factor * out_width;
+
+		// Widen the row once, then repeat it for the other output rows
+		for (auto x = 0u; x < out_width; ++x) {
+			first[x] = source[x / factor];
+		}
+
+		for (auto i = 1u; i < factor; ++i) {
+			std::memcpy(first + i * out_width, first, out_width);
+		}
+	}
+}
+
+unsigned int Scale2xScaler::get_factor() const { return 2; }
+
+void Scale2xScaler::scale_rows(const VideoBuffer &input, Pixel *output,
+                               unsigned int row_start,
+                               unsigned int row_end) const {
+	const auto out_width = SCREEN_WIDTH * 2;
+	const auto last = SCREEN_WIDTH - 1;
+
+	for (auto row = row_start; row < row_end; ++row) {
+		auto up = get_row(input, static_cast<int>(row) - 1);
+		auto mid = get_row(input, static_cast<int>(row));
+		auto down = get_row(input, static_cast<int>(row) + 1);
+
+		auto top = output + row * 2 * out_width;
+		auto bottom = top + out_width;
+
+		// The edge pixels repeat themselves in place of the missing neighbour
+		scale2x_pixel(up[0], mid[0], mid[0], mid[1], down[0], top, bottom);
+		for (auto x = 1; x < last; ++x) {
+			scale2x_pixel(up[x], mid[x - 1], mid[x], mid[x + 1], down[x],
+			              top + x * 2, bottom + x * 2);
+		}
+		scale2x_pixel(up[last], mid[last - 1], mid[last], mid[last],
+		              down[last], top + last * 2, bottom + last * 2);
+	}
+}
+
+unsigned int Scale3xScaler::get_factor() const { return 3; }
+
+void Scale3xScaler::scale_rows(const VideoBuffer &input, Pixel *output,
+                               unsigned int row_start,
+                               unsigned int row_end) const {
+	const auto out_width = SCREEN_WIDTH * 3;
+	const auto last = SCREEN_WIDTH - 1;
+
+	for (auto row = row_start; row < row_end; ++row) {
+		auto up = get_row(input, static_cast<int>(row) - 1);
+		auto mid = get_row(input, static_cast<int>(row));
+		auto down = get_row(input, static_cast<int>(row) + 1);
+
+		auto top = output + row * 3 * out_width;
+		auto center = top + out_width;
+		auto bottom = center + out_width;
+
+		// Edge pixels need their missing neighbour filled in, so they are
+		// scaled from small copies of their surroundings
+		for (auto x : {0, last}) {
+			auto left = std::max(x - 1, 0);
+			auto right = std::min(x + 1, last);
+			Pixel up3[] = {up[left], up[x], up[right]};
+			Pixel mid3[] = {mid[left], mid[x], mid[right]};
+			Pixel down3[] = {down[left], down[x], down[right]};
+
+			scale3x_pixel(up3, mid3, down3, top + x * 3, center + x * 3,
+			              bottom + x * 3);
+		}
+
+		for (auto x = 1; x < last; ++x) {
+			scale3x_pixel(up + x - 1, mid + x - 1, down + x - 1, top + x * 3,
+			              center + x * 3, bottom + x * 3);
+		}
+	}
+}
+
+std::unique_ptr<ScalerInterface> make_scaler(ScalerType type,
+                                             unsigned int factor) {
+	switch (type) {
+	case ScalerType::NEAREST:
+		return std::make_unique<NearestScaler>(factor);
+	case ScalerType::SCALE2X:
+		return std::make_unique<Scale2xScaler>();
+	case ScalerType::SCALE3X:
+		return std::make_unique<Scale3xScaler>();
+	case ScalerType::NONE:
+	default:
+		return std::make_unique<NearestScaler>(1);
+	}
+}
+
+ScalerPipeline::ScalerPipeline(std::unique_ptr<ScalerInterface> scaler,
+                               const Palette &palette,
+                               unsigned int thread_count)
+    : scaler(std::move(scaler)), palette(palette), pool(thread_count) {
+	auto factor = this->scaler->get_factor();
+	auto strips = static_cast<unsigned int>(pool.get_thread_count());
+	strip_rows = (SCREEN_HEIGHT + strips - 1) / strips;
+
+	scaled.resize(PIXEL_COUNT * factor * factor);
+	rgba.resize(scaled.size() * 4);
+}
+
+void ScalerPipeline::process_strip(const VideoBuffer &frame,
+                                   unsigned int strip) {
+	auto row_start = strip * strip_rows;
+	auto row_end = std::min(row_start + strip_rows,
+	                        static_cast<unsigned int>(SCREEN_HEIGHT));
+	if (row_start >= row_end) {
+		return;
+	}
+
+	scaler->scale_rows(frame, scaled.data(), row_start, row_end);
+
+	// Color the output rows that this strip produced
+	auto factor = scaler->get_factor();
+	auto first = row_start * factor * get_width();
+	auto last = row_end * factor * get_width();
+	for (auto i = first; i < last; ++i) {
+		auto &color = palette[static_cast<uint8_t>(scaled[i])];
+		std::memcpy(&rgba[i * 4], color.data(), color.size());
+	}
+}
+
+const uint8_t *ScalerPipeline::process(const VideoBuffer &frame) {
+	auto strips = (SCREEN_HEIGHT + strip_rows - 1) / strip_rows;
+	pool.parallel_for(strips,
+	                  [&](std::size_t strip) { process_strip(frame, strip); });
+
+	return rgba.data();
+}
+
+unsigned int ScalerPipeline::get_width() const {
+	return SCREEN_WIDTH * scaler->get_factor();
+}
+
+unsigned int ScalerPipeline::get_height() const {
+	return SCREEN_HEIGHT * scaler->get_factor();
+}
+
+} // namespace video
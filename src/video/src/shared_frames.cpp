@@ -0,0 +1,127 @@
+/**
+ * @file shared_frames.cpp
+ * Defines the reader for the shared memory frame ring
+ */
+
+#include "video/shared_frames.h"
+#include "util/log.h"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TVP_HAS_SHARED_MEMORY
+#endif
+
+using namespace gpu;
+
+namespace video {
+
+/**
+ * Number of times a reader retries a slot that is being rewritten before
+ * giving up
+ */
+const int READ_ATTEMPTS = 16;
+
+std::size_t get_shared_frames_size(uint32_t slot_count) {
+	return sizeof(SharedFramesHeader) + slot_count * sizeof(SharedFrameSlot);
+}
+
+std::string get_shared_memory_name(const std::string &name) {
+	if (!name.empty() && name[0] == '/') {
+		return name;
+	}
+	return "/" + name;
+}
+
+SharedFrameReader::SharedFrameReader(const std::string &name)
+    : header(nullptr), size(0) {
+#ifdef TVP_HAS_SHARED_MEMORY
+	auto fd = shm_open(get_shared_memory_name(name).c_str(), O_RDONLY, 0);
+	if (fd < 0) {
+		Log::error("Could not open shared frames " + name);
+		return;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 &&
+	    static_cast<std::size_t>(info.st_size) >= sizeof(SharedFramesHeader)) {
+		size = info.st_size;
+		auto mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (mapping != MAP_FAILED) {
+			header = static_cast<const SharedFramesHeader *>(mapping);
+		}
+	}
+	close(fd);
+
+	auto valid = header != nullptr && header->magic == SHARED_FRAMES_MAGIC &&
+	             header->version == SHARED_FRAMES_VERSION &&
+	             size >= get_shared_frames_size(header->slot_count);
+	if (header != nullptr && !valid) {
+		Log::error("Shared frames " + name + " has an unknown layout");
+		munmap(const_cast<SharedFramesHeader *>(header), size);
+		header = nullptr;
+	}
+#else
+	Log::error("Shared memory is not supported on this platform");
+#endif
+}
+
+SharedFrameReader::~SharedFrameReader() {
+#ifdef TVP_HAS_SHARED_MEMORY
+	if (header != nullptr) {
+		munmap(const_cast<SharedFramesHeader *>(header), size);
+	}
+#endif
+}
+
+bool SharedFrameReader::is_open() const { return header != nullptr; }
+
+const SharedFramesHeader *SharedFrameReader::get_header() const {
+	return header;
+}
+
+const SharedFrameSlot *SharedFrameReader::get_slot(uint32_t index) const {
+	auto slots = reinterpret_cast<const uint8_t *>(header + 1);
+	return reinterpret_cast<const SharedFrameSlot *>(
+	    slots + index * sizeof(SharedFrameSlot));
+}
+
+bool SharedFrameReader::read_latest(VideoBuffer &frame, FrameInfo &info,
+                                    bool *unchanged) const {
+	for (auto attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+		auto published =
+		    header->frames_published.load(std::memory_order_acquire);
+		if (published == 0) {
+			return false;
+		}
+
+		auto slot = get_slot((published - 1) % header->slot_count);
+		auto before = slot->sequence.load(std::memory_order_acquire);
+		if (before % 2 != 0) {
+			continue;
+		}
+
+		std::memcpy(frame.data(), slot->pixels.data(), frame.size());
+		info.number = slot->number;
+		info.cycles = slot->cycles;
+		auto flags = slot->flags;
+
+		// If the writer came around to this slot while it was being copied,
+		// the copy may be torn, so try again
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot->sequence.load(std::memory_order_relaxed) == before) {
+			if (unchanged != nullptr) {
+				*unchanged = flags & SHARED_FRAME_UNCHANGED;
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+} // namespace video
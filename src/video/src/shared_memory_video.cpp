@@ -0,0 +1,139 @@
+/**
+ * @file shared_memory_video.cpp
+ * Defines the SharedMemoryVideo driver
+ */
+
+#include "video/shared_memory_video.h"
+#include "util/log.h"
+
+#include <cerrno>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define TVP_HAS_SHARED_MEMORY
+#endif
+
+using namespace gpu;
+
+namespace video {
+
+SharedMemoryVideo::SharedMemoryVideo(std::unique_ptr<VideoInterface> output,
+                                     const std::string &name,
+                                     uint32_t slot_count)
+    : output(std::move(output)), name(get_shared_memory_name(name)),
+      header(nullptr), size(get_shared_frames_size(slot_count)) {
+#ifdef TVP_HAS_SHARED_MEMORY
+	// Memory that already exists belongs to someone else, or was left by a
+	// run that crashed, so it is never taken over
+	auto fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0 && errno == EEXIST) {
+		Log::error("Shared frames " + this->name +
+		           " already exist. If no other emulator is using them, "
+		           "remove them with shm_unlink or from /dev/shm");
+		return;
+	}
+	if (fd < 0) {
+		Log::error("Could not create shared frames " + name);
+		return;
+	}
+
+	if (ftruncate(fd, size) == 0) {
+		auto mapping =
+		    mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (mapping != MAP_FAILED) {
+			header = static_cast<SharedFramesHeader *>(mapping);
+		}
+	}
+	close(fd);
+
+	if (header == nullptr) {
+		Log::error("Could not map shared frames " + name);
+		shm_unlink(this->name.c_str());
+		return;
+	}
+
+	new (header) SharedFramesHeader{};
+	header->version = SHARED_FRAMES_VERSION;
+	header->slot_count = slot_count;
+	header->slot_size = sizeof(SharedFrameSlot);
+	header->width = SCREEN_WIDTH;
+	header->height = SCREEN_HEIGHT;
+	for (auto i = 0u; i < slot_count; ++i) {
+		new (get_slot(i)) SharedFrameSlot{};
+	}
+
+	// Readers check the magic number last, so it goes in once the rest of
+	// the header is ready
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = SHARED_FRAMES_MAGIC;
+#else
+	Log::error("Shared memory is not supported on this platform");
+#endif
+}
+
+SharedMemoryVideo::~SharedMemoryVideo() {
+#ifdef TVP_HAS_SHARED_MEMORY
+	if (header != nullptr) {
+		munmap(header, size);
+		shm_unlink(name.c_str());
+	}
+#endif
+}
+
+bool SharedMemoryVideo::is_open() const { return header != nullptr; }
+
+VideoInterface *SharedMemoryVideo::get_output() const { return output.get(); }
+
+SharedFrameSlot *SharedMemoryVideo::get_slot(uint32_t index) {
+	auto slots = reinterpret_cast<uint8_t *>(header + 1);
+	return reinterpret_cast<SharedFrameSlot *>(slots +
+	                                           index * sizeof(SharedFrameSlot));
+}
+
+void SharedMemoryVideo::publish(const VideoBuffer *pixels,
+                                const FrameInfo &info) {
+	auto published = header->frames_published.load(std::memory_order_relaxed);
+	auto slot = get_slot(published % header->slot_count);
+
+	// Mark the slot as being written, so readers will retry
+	auto sequence = slot->sequence.load(std::memory_order_relaxed);
+	slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot->number = info.number;
+	slot->cycles = info.cycles;
+	if (pixels != nullptr) {
+		slot->flags = 0;
+		slot->pixels = *pixels;
+	} else {
+		// Unchanged pixels are carried over from the slot before, so that the
+		// newest slot always holds the whole frame
+		slot->flags = SHARED_FRAME_UNCHANGED;
+		if (published > 0) {
+			auto previous = get_slot((published - 1) % header->slot_count);
+			slot->pixels = previous->pixels;
+		}
+	}
+
+	slot->sequence.store(sequence + 2, std::memory_order_release);
+	header->frames_published.store(published + 1, std::memory_order_release);
+}
+
+void SharedMemoryVideo::paint(VideoBuffer &v_buffer, const FrameInfo &info) {
+	if (header != nullptr) {
+		publish(&v_buffer, info);
+	}
+	output->paint(v_buffer, info);
+}
+
+void SharedMemoryVideo::repeat(const FrameInfo &info) {
+	if (header != nullptr) {
+		publish(nullptr, info);
+	}
+	output->repeat(info);
+}
+
+} // namespace video
@@ -0,0 +1,69 @@
+/**
+ * @file threaded_video.cpp
+ * Defines the ThreadedVideo driver
+ */
+
+#include "video/threaded_video.h"
+
+#include <algorithm>
+
+using namespace std::chrono;
+using namespace gpu;
+using namespace controller;
+
+namespace video {
+
+ThreadedVideo::ThreadedVideo(InputQueue *inputs, const FramePacer *pacer)
+    : inputs(inputs), pacer(pacer), frame_cycles(0),
+      frame_time(steady_clock::now().time_since_epoch().count()),
+      rewinding(false) {}
+
+void ThreadedVideo::finish_frame(const FrameInfo &info) {
+	auto now = steady_clock::now().time_since_epoch().count();
+	frame_time.store(now, std::memory_order_relaxed);
+	frame_cycles.store(info.cycles, std::memory_order_relaxed);
+}
+
+void ThreadedVideo::paint(VideoBuffer &v_buffer, const FrameInfo &info) {
+	frames.get_back() = v_buffer;
+	frames.publish();
+	finish_frame(info);
+}
+
+void ThreadedVideo::repeat(const FrameInfo &info) { finish_frame(info); }
+
+const VideoBuffer *ThreadedVideo::get_new_frame() {
+	if (!frames.update()) {
+		return nullptr;
+	}
+
+	return &frames.get_front();
+}
+
+bool ThreadedVideo::send_input(Button button, bool pressed) {
+	auto cycle = project_cycle(steady_clock::now());
+	return inputs->push({button, pressed, cycle});
+}
+
+uint64_t ThreadedVideo::project_cycle(steady_clock::time_point now) const {
+	auto cycles = frame_cycles.load(std::memory_order_relaxed);
+	if (pacer->get_turbo()) {
+		return cycles;
+	}
+
+	auto time = steady_clock::time_point(
+	    steady_clock::duration(frame_time.load(std::memory_order_relaxed)));
+	auto elapsed = duration<double>(std::max(now - time, {})).count();
+	auto projected = elapsed * cpu::CLOCK_SPEED * pacer->get_speed();
+	return cycles + std::min(static_cast<uint64_t>(projected), CLOCKS_FRAME);
+}
+
+void ThreadedVideo::set_rewinding(bool rewind) {
+	rewinding.store(rewind, std::memory_order_relaxed);
+}
+
+bool ThreadedVideo::is_rewinding() const {
+	return rewinding.load(std::memory_order_relaxed);
+}
+
+} // namespace video
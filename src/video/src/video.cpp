@@ -17,30 +17,35 @@ using namespace gpu;
 using namespace controller;
 using namespace cartridge;
 
-const auto MULT = 3;
-
 namespace video {
 
-Video::Video(ControllerInterface *controller,
-             CartridgeMetadata *cartridge_metadata)
+Video::Video(ThreadedVideo *emulator_video, FramePacer *pacer,
+             CartridgeMetadata *cartridge_metadata, ScalerType scaler_type,
+             unsigned int scale)
     : window(std::make_unique<sf::RenderWindow>(
-          sf::VideoMode(SCREEN_WIDTH * MULT, SCREEN_HEIGHT * MULT),
+          sf::VideoMode(SCREEN_WIDTH * scale, SCREEN_HEIGHT * scale),
           "Welcome to TVP")),
       window_texture(std::make_unique<sf::Texture>()),
-      window_image(std::make_unique<sf::Image>()),
-      window_sprite(std::make_unique<sf::Sprite>()), controller(controller),
+      window_sprite(std::make_unique<sf::Sprite>()),
+      scaler(make_scaler(scaler_type, scale), DEFAULT_PALETTE),
+      emulator_video(emulator_video), pacer(pacer),
       cartridge_metadata(cartridge_metadata) {
 
-	// Set some window properties
+	// The window only waits on vertical sync. Emulation speed is kept by the
+	// pacer on the emulation thread, so the display rate doesn't affect it.
 	window->setVerticalSyncEnabled(true);
-	window->setFramerateLimit(59.97f);
 
-	// Set the image size
-	window_image->create(SCREEN_WIDTH * MULT, SCREEN_HEIGHT * MULT);
+	// The texture is the size of the scaler output, and the sprite stretches
+	// it over whatever is left to fill the window. It is only bound once, and
+	// updated in place on every frame.
+	window_texture->create(scaler.get_width(), scaler.get_height());
+	window_sprite->setTexture(*(window_texture), true);
+
+	auto sprite_scale = static_cast<float>(SCREEN_WIDTH * scale) /
+	                    static_cast<float>(scaler.get_width());
+	window_sprite->setScale(sprite_scale, sprite_scale);
 
-	// Set the title of the Window if rom_title is not empty
-	if (!cartridge_metadata->title.empty())
-		window->setTitle(cartridge_metadata->title);
+	update_title();
 }
 
 std::optional<Button> get_button_from_code(int64_t code) {
@@ -66,19 +71,69 @@ std::optional<Button> get_button_from_code(int64_t code) {
 	}
 }
 
+bool Video::handle_speed_key(sf::Keyboard::Key key) {
+	switch (key) {
+	case sf::Keyboard::Tab:
+		pacer->set_turbo(!pacer->get_turbo());
+		break;
+	case sf::Keyboard::Equal:
+	case sf::Keyboard::Add:
+		pacer->set_speed(pacer->get_speed() * 2);
+		break;
+	case sf::Keyboard::Dash:
+	case sf::Keyboard::Subtract:
+		pacer->set_speed(pacer->get_speed() / 2);
+		break;
+	case sf::Keyboard::Num0:
+		pacer->set_speed(1.0);
+		break;
+	default:
+		return false;
+	}
+
+	update_title();
+	return true;
+}
+
+void Video::update_title() {
+	auto title = cartridge_metadata->title.empty()
+	                 ? std::string("Welcome to TVP")
+	                 : cartridge_metadata->title;
+
+	if (pacer->get_turbo()) {
+		title += " (turbo)";
+	} else if (pacer->get_speed() != 1.0) {
+		title += " (" + std::to_string(pacer->get_speed()) + "x)";
+	}
+
+	window->setTitle(title);
+}
+
 void Video::event_handler() {
 	sf::Event event;
 	while (window->pollEvent(event)) {
 		// Handle key presses
 		if (event.type == sf::Event::KeyPressed) {
+			if (handle_speed_key(event.key.code)) {
+				continue;
+			}
+
+			if (event.key.code == sf::Keyboard::R) {
+				emulator_video->set_rewinding(true);
+			}
+
 			if (auto button = get_button_from_code(event.key.code)) {
-				controller->press_button(*button);
+				emulator_video->send_input(*button, true);
 			}
 		}
 
 		if (event.type == sf::Event::KeyReleased) {
+			if (event.key.code == sf::Keyboard::R) {
+				emulator_video->set_rewinding(false);
+			}
+
 			if (auto button = get_button_from_code(event.key.code)) {
-				controller->release_button(*button);
+				emulator_video->send_input(*button, false);
 			}
 		}
 
@@ -88,41 +143,20 @@ void Video::event_handler() {
 	}
 }
 
-void Video::paint(VideoBuffer &v_buffer) {
+bool Video::is_open() const { return window->isOpen(); }
+
+void Video::present() {
 	// Handle window events
 	event_handler();
 
-	// Create pixel buffer from input
-	for (int i = 0; i < PIXEL_COUNT; ++i) {
-		auto pixel = v_buffer[i];
-		sf::Color color;
-		switch (pixel) {
-		case Pixel::ZERO:
-			color = sf::Color::White;
-			break;
-		case Pixel::ONE:
-			color = sf::Color(85, 85, 85);
-			break;
-		case Pixel::TWO:
-			color = sf::Color(170, 170, 170);
-			break;
-		case Pixel::THREE:
-			color = sf::Color::Black;
-			break;
-		}
-		for (int k = 0; k < MULT; k++) {
-			for (int l = 0; l < MULT; l++) {
-				auto a = (i % SCREEN_WIDTH) * MULT + k;
-				auto b = (i / SCREEN_WIDTH) * MULT + l;
-				window_image->setPixel(a, b, color);
-			}
-		}
+	// Scale the newest frame, convert it to RGBA and upload it. If the
+	// emulator hasn't finished a new frame, the last one is kept.
+	if (auto v_buffer = emulator_video->get_new_frame()) {
+		window_texture->update(scaler.process(*v_buffer));
 	}
 
 	// Draw window
 	window->clear();
-	window_texture->loadFromImage(*(window_image));
-	window_sprite->setTexture(*(window_texture), true);
 	window->draw(*(window_sprite));
 	window->display();
 }
@@ -0,0 +1,130 @@
+#include "controller/controller.h"
+#include "controller/movie.h"
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+#include "video/buffer_video.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace testing;
+using namespace std;
+using namespace controller;
+using namespace gameboy;
+using namespace video;
+
+class MovieTest : public TestRomTest {};
+
+/**
+ * Read the whole of a file
+ */
+string read_file(const string &path) {
+	auto file = ifstream(path, ios::binary);
+	return string(istreambuf_iterator<char>(file), {});
+}
+
+TEST_F(MovieTest, ButtonMaskRoundTrip) {
+	auto source = Controller();
+	source.press_button(Button::A);
+	source.press_button(Button::LEFT);
+
+	auto target = Controller();
+	target.set_buttons(source.get_buttons());
+	EXPECT_EQ(target.get_buttons(), 0b00010010);
+
+	// Reading the buttons through the joypad register sees the same state
+	source.set_value(0x10);
+	target.set_value(0x10);
+	EXPECT_EQ(target.get_value(), source.get_value());
+	source.set_value(0x20);
+	target.set_value(0x20);
+	EXPECT_EQ(target.get_value(), source.get_value());
+}
+
+TEST_F(MovieTest, SaveAndLoad) {
+	auto path = string("movie_test.tvpm");
+	auto movie = InputMovie(0x1122334455667788, 0xAABBCCDD);
+	for (auto i = 0; i < 1000; ++i) {
+		movie.add_frame(i < 300 ? 0 : 0x10);
+	}
+	movie.add_frame(0x81);
+	ASSERT_TRUE(movie.save(path));
+
+	// Header, version, three uint64s, then three runs. The runs of 300 and
+	// 700 frames take two bytes for their length.
+	EXPECT_EQ(read_file(path).size(), 4u + 1 + 24 + 3 + 3 + 2);
+
+	auto loaded = InputMovie::load(path);
+	remove(path.c_str());
+	ASSERT_TRUE(loaded);
+	EXPECT_EQ(loaded->get_rom_checksum(), 0x1122334455667788u);
+	EXPECT_EQ(loaded->get_initial_state_hash(), 0xAABBCCDDu);
+	ASSERT_EQ(loaded->get_frame_count(), 1001u);
+	for (auto i = 0u; i < 1001; ++i) {
+		EXPECT_EQ(loaded->get_frame(i), movie.get_frame(i));
+	}
+
+	// Nothing is held once the movie is over
+	EXPECT_EQ(loaded->get_frame(1001), 0);
+}
+
+TEST_F(MovieTest, RejectsMalformedFiles) {
+	auto path = string("movie_test_bad.tvpm");
+	auto movie = InputMovie(1, 2);
+	movie.add_frame(3);
+	movie.add_frame(3);
+	ASSERT_TRUE(movie.save(path));
+	auto contents = read_file(path);
+
+	// Cutting off the last run, or the header, is noticed
+	for (auto size : {contents.size() - 1, size_t{4}}) {
+		auto file = ofstream(path, ios::binary | ios::trunc);
+		file.write(contents.data(), size);
+		file.close();
+		EXPECT_FALSE(InputMovie::load(path));
+	}
+
+	remove(path.c_str());
+	EXPECT_FALSE(InputMovie::load(path));
+}
+
+TEST_F(MovieTest, PlaysBackLikeTheRecording) {
+	InputQueue *inputs = nullptr;
+	auto video_factory = [&](InputQueue *queue, CartridgeMetadata *) {
+		inputs = queue;
+		return unique_ptr<VideoInterface>(make_unique<BufferVideo>());
+	};
+	auto recorded = make_unique<Gameboy>(rom_path, video_factory);
+	auto played = make_unique<Gameboy>(rom_path);
+	recorded->skip_boot();
+	played->skip_boot();
+
+	// Record from input events the way the window does. A press and release
+	// in the same frame is never held, so it isn't recorded or pressed.
+	auto movie = InputMovie(0, recorded->get_state_hash());
+	for (auto frame = 0; frame < 60; ++frame) {
+		if (frame == 10) {
+			inputs->push({Button::A, true, 0});
+		} else if (frame == 20) {
+			inputs->push({Button::A, false, 0});
+			inputs->push({Button::START, true, 0});
+		} else if (frame == 30) {
+			inputs->push({Button::START, false, 0});
+			inputs->push({Button::B, true, 0});
+			inputs->push({Button::B, false, 0});
+		}
+		recorded->apply_inputs();
+		movie.add_frame(recorded->controller->get_buttons());
+		recorded->run_frame();
+	}
+
+	for (auto frame = size_t{0}; frame < movie.get_frame_count(); ++frame) {
+		played->set_buttons(movie.get_frame(frame));
+		played->run_frame();
+	}
+	EXPECT_EQ(played->get_state_hash(), recorded->get_state_hash());
+}
@@ -0,0 +1,65 @@
+#include "env/lockstep_env.h"
+#include "env/vec_env.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace env;
+using namespace gameboy;
+
+class LockstepEnvTest : public TestRomTest {};
+
+TEST_F(LockstepEnvTest, MatchesVecEnv) {
+	auto lockstep_env = LockstepEnv(rom_path, 3);
+	auto vec_env = VecEnv(rom_path, 3, 0, 1);
+	auto lockstep_frames = vector<VideoBuffer>(3);
+	auto vec_frames = vector<VideoBuffer>(3);
+	auto actions = vector<uint8_t>{0x00, 0x01, 0x82};
+	bool lockstep_done[3];
+	bool vec_done[3];
+
+	// The lanes run the boot ROM in lockstep, then split up
+	auto steps = vector<unsigned int>{1, 150, 49, 3, 7};
+	for (auto frames : steps) {
+		lockstep_env.step(actions.data(), frames, lockstep_frames.data(),
+		                  lockstep_done);
+		vec_env.step(actions.data(), frames, vec_frames.data(), vec_done);
+
+		for (auto index = size_t{0}; index < 3; ++index) {
+			EXPECT_EQ(lockstep_frames[index], vec_frames[index]);
+			EXPECT_EQ(lockstep_env.get_instance(index)->get_state_hash(),
+			          vec_env.get_instance(index)->get_state_hash());
+		}
+	}
+
+	auto stats = lockstep_env.get_stats();
+	EXPECT_GT(stats.lockstep_instructions, 0u);
+	EXPECT_GT(stats.gathers, 0u);
+	EXPECT_LT(stats.lockstep_instructions, stats.instructions);
+}
+
+TEST_F(LockstepEnvTest, ResetsFinishedEpisodes) {
+	auto lockstep_env = LockstepEnv(rom_path, 2, 250);
+	auto frames = vector<VideoBuffer>(2);
+	auto actions = vector<uint8_t>{0, 0x04};
+	bool done[2];
+	auto initial_hash = lockstep_env.get_instance(0)->get_state_hash();
+
+	lockstep_env.step(actions.data(), 200, frames.data(), done);
+	EXPECT_FALSE(done[0] || done[1]);
+
+	lockstep_env.step(actions.data(), 100, frames.data(), done);
+	EXPECT_TRUE(done[0] && done[1]);
+	EXPECT_EQ(lockstep_env.get_instance(0)->get_state_hash(), initial_hash);
+	EXPECT_EQ(lockstep_env.get_instance(1)->get_state_hash(), initial_hash);
+	EXPECT_NE(frames[0], VideoBuffer{});
+}
+
+TEST_F(LockstepEnvTest, LimitsTheLaneCount) {
+	auto lockstep_env = LockstepEnv(rom_path, MAX_LANES + 4);
+	EXPECT_EQ(lockstep_env.get_count(), MAX_LANES);
+}
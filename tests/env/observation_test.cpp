@@ -0,0 +1,190 @@
+#include "env/observation.h"
+#include "video/packed_frame.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace env;
+using namespace gpu;
+
+class ObservationTest : public Test {
+  protected:
+	/**
+	 * Grey levels of each shade
+	 */
+	const uint8_t grey[4] = {255, 85, 170, 0};
+
+	/**
+	 * A frame that has every shade, in no particular order
+	 */
+	VideoBuffer make_frame() {
+		auto frame = VideoBuffer();
+		for (auto i = 0u; i < frame.size(); ++i) {
+			frame[i] = static_cast<Pixel>((i * 7 + i / SCREEN_WIDTH) % 4);
+		}
+		return frame;
+	}
+
+	/**
+	 * Make one observation of a frame
+	 */
+	vector<uint8_t> observe(ObservationConfig config,
+	                        const VideoBuffer &frame) {
+		auto pipeline = ObservationPipeline(config);
+		auto ring = vector<uint8_t>(pipeline.get_ring_size());
+		pipeline.push(frame, nullptr, ring.data());
+		auto stack = pipeline.get_stack(ring.data());
+		return vector<uint8_t>(stack, stack + pipeline.get_observation_size());
+	}
+};
+
+TEST_F(ObservationTest, KeepsFullFramesAsTheyAre) {
+	auto frame = make_frame();
+	auto config = ObservationConfig();
+
+	auto observation = observe(config, frame);
+	ASSERT_EQ(observation.size(), PIXEL_COUNT);
+	for (auto i = 0u; i < PIXEL_COUNT; ++i) {
+		ASSERT_EQ(observation[i], grey[static_cast<int>(frame[i])]);
+	}
+
+	config.format = ObservationFormat::SHADES;
+	observation = observe(config, frame);
+	for (auto i = 0u; i < PIXEL_COUNT; ++i) {
+		ASSERT_EQ(observation[i], static_cast<int>(frame[i]));
+	}
+
+	config.format = ObservationFormat::PACKED;
+	observation = observe(config, frame);
+	auto packed = video::PackedFrame();
+	video::pack_frame(frame, packed);
+	EXPECT_EQ(observation, vector<uint8_t>(packed.begin(), packed.end()));
+}
+
+TEST_F(ObservationTest, AveragesTheAreaEachPixelCovers) {
+	// Black and white in a checkerboard of single pixels are grey at half
+	// the size
+	auto frame = VideoBuffer();
+	for (auto i = 0u; i < frame.size(); ++i) {
+		auto x = i % SCREEN_WIDTH;
+		auto y = i / SCREEN_WIDTH;
+		frame[i] = (x + y) % 2 ? Pixel::THREE : Pixel::ZERO;
+	}
+	auto config = ObservationConfig();
+	config.width = 80;
+	config.height = 72;
+	for (auto level : observe(config, frame)) {
+		ASSERT_EQ(level, 128);
+	}
+
+	// Sizes that don't divide the screen still split it where they should.
+	// The left half is black, and 42 pixels across is half way.
+	for (auto i = 0u; i < frame.size(); ++i) {
+		auto x = i % SCREEN_WIDTH;
+		frame[i] = x < SCREEN_WIDTH / 2 ? Pixel::THREE : Pixel::TWO;
+	}
+	config.width = 84;
+	config.height = 84;
+	auto observation = observe(config, frame);
+	ASSERT_EQ(observation.size(), 84u * 84u);
+	for (auto i = 0u; i < observation.size(); ++i) {
+		ASSERT_EQ(observation[i], i % 84 < 42 ? 0 : 170) << "at " << i;
+	}
+
+	// A shade that covers part of a pixel is blended in by how much it
+	// covers, and the closest shade is picked from that
+	frame.fill(Pixel::ZERO);
+	frame[0] = Pixel::THREE;
+	config.width = 1;
+	config.height = 1;
+	EXPECT_EQ(observe(config, frame)[0], 255);
+
+	// 89 of the 90 pixels are white
+	config.width = 16;
+	config.height = 16;
+	EXPECT_EQ(observe(config, frame)[0], 252);
+	config.format = ObservationFormat::SHADES;
+	EXPECT_EQ(observe(config, frame)[0], 0);
+}
+
+TEST_F(ObservationTest, PoolsTheDarkerFrame) {
+	auto sprite = VideoBuffer();
+	sprite.fill(Pixel::ZERO);
+	sprite[10 * SCREEN_WIDTH + 10] = Pixel::THREE;
+	auto blank = VideoBuffer();
+	blank.fill(Pixel::ZERO);
+
+	auto config = ObservationConfig();
+	config.max_pool = true;
+	auto pipeline = ObservationPipeline(config);
+	auto ring = vector<uint8_t>(pipeline.get_ring_size());
+
+	// The first frame has nothing to pool with
+	pipeline.push(blank, &sprite, ring.data());
+	EXPECT_EQ(pipeline.get_stack(ring.data())[10 * SCREEN_WIDTH + 10], 255);
+
+	// The sprite shows in both frames it was drawn in and the one after
+	pipeline.push(sprite, &blank, ring.data());
+	EXPECT_EQ(pipeline.get_stack(ring.data())[10 * SCREEN_WIDTH + 10], 0);
+	pipeline.push(blank, &sprite, ring.data());
+	EXPECT_EQ(pipeline.get_stack(ring.data())[10 * SCREEN_WIDTH + 10], 0);
+	pipeline.push(blank, &blank, ring.data());
+	EXPECT_EQ(pipeline.get_stack(ring.data())[10 * SCREEN_WIDTH + 10], 255);
+
+	// Without pooling, the frame before is left out
+	config.max_pool = false;
+	pipeline = ObservationPipeline(config);
+	pipeline.push(blank, nullptr, ring.data());
+	pipeline.push(blank, &sprite, ring.data());
+	EXPECT_EQ(pipeline.get_stack(ring.data())[10 * SCREEN_WIDTH + 10], 255);
+}
+
+TEST_F(ObservationTest, StacksObservationsOldestFirst) {
+	auto config = ObservationConfig();
+	config.width = 1;
+	config.height = 1;
+	config.stack = 3;
+	auto pipeline = ObservationPipeline(config);
+	auto ring = vector<uint8_t>(pipeline.get_ring_size());
+	ASSERT_EQ(ring.size(), 6u);
+
+	auto push = [&](Pixel shade) {
+		auto frame = VideoBuffer();
+		frame.fill(shade);
+		pipeline.push(frame, nullptr, ring.data());
+		auto stack = pipeline.get_stack(ring.data());
+		EXPECT_GE(stack, ring.data());
+		EXPECT_LE(stack + 3, ring.data() + ring.size());
+		return vector<uint8_t>(stack, stack + 3);
+	};
+
+	// A new stack is filled with the first observation
+	EXPECT_EQ(push(Pixel::THREE), (vector<uint8_t>{0, 0, 0}));
+	EXPECT_EQ(push(Pixel::ONE), (vector<uint8_t>{0, 0, 85}));
+	EXPECT_EQ(push(Pixel::TWO), (vector<uint8_t>{0, 85, 170}));
+	EXPECT_EQ(push(Pixel::ZERO), (vector<uint8_t>{85, 170, 255}));
+	EXPECT_EQ(push(Pixel::THREE), (vector<uint8_t>{170, 255, 0}));
+	EXPECT_EQ(push(Pixel::ONE), (vector<uint8_t>{255, 0, 85}));
+
+	pipeline.reset();
+	EXPECT_EQ(push(Pixel::TWO), (vector<uint8_t>{170, 170, 170}));
+	EXPECT_EQ(push(Pixel::ZERO), (vector<uint8_t>{170, 170, 255}));
+}
+
+TEST_F(ObservationTest, ClampsSizes) {
+	auto config = ObservationConfig();
+	config.width = 0;
+	config.height = 500;
+	config.stack = 0;
+	config.format = ObservationFormat::PACKED;
+
+	auto pipeline = ObservationPipeline(config);
+	EXPECT_EQ(pipeline.get_config().width, 1u);
+	EXPECT_EQ(pipeline.get_config().height, SCREEN_HEIGHT);
+	EXPECT_EQ(pipeline.get_config().stack, 1u);
+	EXPECT_EQ(pipeline.get_observation_size(), SCREEN_HEIGHT / 4u);
+	EXPECT_EQ(pipeline.get_ring_size(), SCREEN_HEIGHT / 2u);
+}
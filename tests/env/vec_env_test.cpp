@@ -0,0 +1,141 @@
+#include "env/vec_env.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace env;
+using namespace gameboy;
+
+class VecEnvTest : public TestRomTest {};
+
+TEST_F(VecEnvTest, MatchesSeparateGameboys) {
+	auto vec_env = VecEnv(rom_path, 2, 0, 2);
+	auto frames = vector<VideoBuffer>(2);
+	auto actions = vector<uint8_t>{0x01, 0x82};
+	bool done[2];
+
+	// Get past the boot ROM, then take a few short steps
+	vec_env.step(actions.data(), 200, frames.data(), done);
+	for (auto i = 0; i < 5; ++i) {
+		vec_env.step(actions.data(), 2, frames.data(), done);
+		EXPECT_FALSE(done[0]);
+		EXPECT_FALSE(done[1]);
+	}
+
+	for (auto index = size_t{0}; index < 2; ++index) {
+		auto gameboy = make_unique<Gameboy>(rom_path);
+		for (auto frame = 0; frame < 210; ++frame) {
+			gameboy->set_buttons(actions[index]);
+			gameboy->run_frame();
+		}
+
+		auto video = static_cast<BufferVideo *>(gameboy->video.get());
+		EXPECT_EQ(frames[index], video->get_buffer());
+		EXPECT_EQ(vec_env.get_instance(index)->get_state_hash(),
+		          gameboy->get_state_hash());
+	}
+}
+
+TEST_F(VecEnvTest, ResetsFinishedEpisodes) {
+	auto vec_env = VecEnv(rom_path, 2, 250, 1);
+	auto frames = vector<VideoBuffer>(2);
+	auto actions = vector<uint8_t>{0, 0};
+	bool done[2];
+	auto initial_hash = vec_env.get_instance(0)->get_state_hash();
+
+	vec_env.step(actions.data(), 200, frames.data(), done);
+	EXPECT_FALSE(done[0]);
+	EXPECT_NE(vec_env.get_instance(0)->get_state_hash(), initial_hash);
+
+	vec_env.step(actions.data(), 100, frames.data(), done);
+	EXPECT_TRUE(done[0]);
+	EXPECT_TRUE(done[1]);
+	EXPECT_EQ(vec_env.get_instance(0)->get_state_hash(), initial_hash);
+	EXPECT_EQ(vec_env.get_instance(1)->get_state_hash(), initial_hash);
+
+	// The last frame of the episode is kept, not the blank starting one
+	EXPECT_NE(frames[0], VideoBuffer{});
+}
+
+TEST_F(VecEnvTest, UsesTheDoneCheck) {
+	auto vec_env = VecEnv(rom_path, 3, 0, 2);
+	auto frames = vector<VideoBuffer>(3);
+	auto actions = vector<uint8_t>{0, 0, 0};
+	bool done[3];
+
+	// The episode ends once the boot ROM is done
+	vec_env.set_done_check([](Gameboy &gameboy) {
+		return gameboy.memory->read(0xFF50) == 1;
+	});
+
+	vec_env.step(actions.data(), 10, frames.data(), done);
+	EXPECT_FALSE(done[0] || done[1] || done[2]);
+
+	vec_env.step(actions.data(), 200, frames.data(), done);
+	EXPECT_TRUE(done[0] && done[1] && done[2]);
+}
+
+TEST_F(VecEnvTest, PushesObservations) {
+	auto vec_env = VecEnv(rom_path, 2, 300, 2);
+	auto frames = vector<VideoBuffer>(2);
+	auto actions = vector<uint8_t>{0, 0};
+	bool done[2];
+
+	auto config = ObservationConfig();
+	config.width = 84;
+	config.height = 84;
+	config.stack = 2;
+	auto pipeline = ObservationPipeline(config);
+	auto size = pipeline.get_observation_size();
+	auto rings = vector<uint8_t>(pipeline.get_ring_size() * 2);
+	vec_env.set_observations(config, rings.data());
+
+	// Each stack ends with an observation of the frame that was returned
+	auto observed = vector<vector<uint8_t>>(2);
+	for (auto step = 0; step < 2; ++step) {
+		vec_env.step(actions.data(), 100 + step, frames.data(), done);
+		for (auto index = size_t{0}; index < 2; ++index) {
+			auto expected = vector<uint8_t>(pipeline.get_ring_size());
+			pipeline.reset();
+			pipeline.push(frames[index], nullptr, expected.data());
+			auto stack = vec_env.get_observations(index);
+			EXPECT_TRUE(equal(stack + size, stack + size * 2,
+			                  pipeline.get_stack(expected.data())));
+			if (step == 0) {
+				observed[index].assign(stack, stack + size);
+			} else {
+				auto &first = observed[index];
+				EXPECT_TRUE(equal(stack, stack + size, first.begin()));
+			}
+		}
+	}
+
+	// Once an episode ends, the next step starts a new stack
+	vec_env.step(actions.data(), 100, frames.data(), done);
+	ASSERT_TRUE(done[0]);
+	vec_env.step(actions.data(), 1, frames.data(), done);
+	auto stack = vec_env.get_observations(0);
+	EXPECT_TRUE(equal(stack, stack + size, stack + size));
+
+	// Pooling only ever makes pixels darker
+	config.max_pool = true;
+	vec_env.set_observations(config, rings.data());
+	vec_env.step(actions.data(), 150, frames.data(), done);
+	vec_env.step(actions.data(), 1, frames.data(), done);
+	stack = vec_env.get_observations(0);
+	auto expected = vector<uint8_t>(pipeline.get_ring_size());
+	pipeline.reset();
+	pipeline.push(frames[0], nullptr, expected.data());
+	auto unpooled = pipeline.get_stack(expected.data());
+	for (auto i = size_t{0}; i < size; ++i) {
+		ASSERT_LE(stack[size + i], unpooled[i]);
+	}
+
+	vec_env.set_observations(config, nullptr);
+	EXPECT_EQ(vec_env.get_observations(0), nullptr);
+}
@@ -0,0 +1,82 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+#include "util/allocation_counter.h"
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class FootprintTest : public TestRomTest {
+  protected:
+	shared_ptr<Cartridge> cartridge = make_shared<Cartridge>(rom_path);
+
+	void start_counting() {
+		// The blocks of zeros that new pages share are made by the first
+		// Gameboy in the process and kept for good, so they aren't part of
+		// any one Gameboy's footprint. Make them before counting.
+		static auto first = make_unique<Gameboy>(cartridge, nullptr,
+		                                         Footprint::MINIMAL);
+
+		start_counting_allocations();
+	}
+};
+
+TEST_F(FootprintTest, SharesTheDispatchTables) {
+	// The opcode and cycle tables are static, so the CPU is only registers
+	EXPECT_LE(sizeof(CPU), 256u);
+	EXPECT_LE(sizeof(GPU), 256u);
+	EXPECT_LE(sizeof(Gameboy), 256u);
+
+	// Memory keeps a pointer to each page from Work RAM up, and VRAM
+	EXPECT_LE(sizeof(Memory), 1280u);
+}
+
+TEST_F(FootprintTest, MinimalGameboyFitsIn24KB) {
+	start_counting();
+	auto gameboy = make_unique<Gameboy>(cartridge, nullptr, Footprint::MINIMAL);
+	auto construction = stop_counting_allocations();
+
+	// The objects themselves and their registers, without any frame buffers
+	EXPECT_LE(construction.allocations, 40u);
+	EXPECT_LE(construction.bytes, 4096u);
+
+	// Boot, then write to every byte of Work RAM, VRAM, OAM and High RAM, so
+	// that none of their pages are shared any more
+	start_counting();
+	run_frames(gameboy.get(), 200);
+	auto regions = {make_pair(0xC000, 0xE000), make_pair(0x8000, 0xA000),
+	                make_pair(0xFE00, 0xFEA0), make_pair(0xFF80, 0xFFFF)};
+	for (auto region : regions) {
+		for (auto address = region.first; address < region.second; ++address) {
+			gameboy->memory->write(address, 0x55);
+		}
+	}
+	auto running = stop_counting_allocations();
+
+	EXPECT_LE(running.allocations, 64u);
+	EXPECT_LE(construction.bytes + running.bytes, 24u * 1024);
+}
+
+TEST_F(FootprintTest, MinimalGameboyDrawsIntoARenderTarget) {
+	auto gameboy = make_unique<Gameboy>(cartridge, nullptr, Footprint::MINIMAL);
+	auto full = make_unique<Gameboy>(cartridge);
+	for (auto i = 0; i < 200; ++i) {
+		gameboy->run_frame();
+		full->run_frame();
+	}
+
+	// Frames are skipped without a target, but the state carries on the same
+	EXPECT_EQ(gameboy->get_state_hash(), full->get_state_hash());
+
+	auto frame = VideoBuffer();
+	gameboy->gpu->set_render_target(&frame);
+	gameboy->run_frame();
+	full->run_frame();
+	gameboy->gpu->set_render_target(nullptr);
+
+	auto video = static_cast<BufferVideo *>(full->video.get());
+	EXPECT_EQ(frame, video->get_buffer());
+	EXPECT_EQ(gameboy->get_state_hash(), full->get_state_hash());
+}
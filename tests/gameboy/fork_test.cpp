@@ -0,0 +1,66 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class ForkTest : public TestRomTest {
+  protected:
+	unique_ptr<Gameboy> gameboy;
+
+	void SetUp() override {
+		gameboy = make_unique<Gameboy>(rom_path);
+
+		// Get past the boot ROM, into the program
+		run_frames(gameboy.get(), 200);
+		ASSERT_EQ(gameboy->memory->read(0xFF50), 1);
+	}
+};
+
+TEST_F(ForkTest, CarriesOnTheSame) {
+	auto child = gameboy->fork();
+	EXPECT_EQ(child->get_state_hash(), gameboy->get_state_hash());
+
+	run_frames(gameboy.get(), 30);
+	run_frames(child.get(), 30);
+	EXPECT_EQ(child->get_state_hash(), gameboy->get_state_hash());
+	EXPECT_EQ(child->memory->read(0xC000), gameboy->memory->read(0xC000));
+}
+
+TEST_F(ForkTest, KeepsWritesToItself) {
+	auto child = gameboy->fork();
+	auto work_ram = gameboy->memory->read(0xC100);
+	auto vram = gameboy->memory->read(0x8000);
+
+	child->memory->write(0xC100, work_ram + 1);
+	child->memory->write(0x8000, vram + 1);
+	EXPECT_EQ(child->memory->read(0xC100), static_cast<uint8_t>(work_ram + 1));
+	EXPECT_EQ(child->memory->read(0x8000), static_cast<uint8_t>(vram + 1));
+	EXPECT_EQ(gameboy->memory->read(0xC100), work_ram);
+	EXPECT_EQ(gameboy->memory->read(0x8000), vram);
+
+	// And the other way around
+	gameboy->memory->write(0xC101, 0x42);
+	EXPECT_NE(child->memory->read(0xC101), 0x42);
+}
+
+TEST_F(ForkTest, CopiesOnlyTouchedPages) {
+	auto children = vector<unique_ptr<Gameboy>>();
+	for (auto i = 0; i < 8; ++i) {
+		children.push_back(gameboy->fork());
+	}
+	for (auto &child : children) {
+		EXPECT_EQ(child->memory->get_private_bytes(), 0u);
+	}
+
+	// A frame of the test program touches a counter in work RAM and the
+	// stack, so only a few pages are copied
+	for (auto &child : children) {
+		run_frames(child.get(), 1);
+		EXPECT_GT(child->memory->get_private_bytes(), 0u);
+		EXPECT_LE(child->memory->get_private_bytes(), 4 * MEMORY_PAGE_SIZE);
+	}
+}
@@ -0,0 +1,86 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class ResetTest : public TestRomTest {};
+
+TEST_F(ResetTest, PostBootMatchesRunningTheBootRom) {
+	auto booted = make_unique<Gameboy>(rom_path);
+	while (booted->cpu->get_pc() != 0x100 ||
+	       booted->memory->read(0xFF50) == 0) {
+		booted->step();
+	}
+
+	auto gameboy = make_unique<Gameboy>(rom_path);
+	run_frames(gameboy.get(), 20);
+	ASSERT_TRUE(gameboy->reset(ResetMode::POST_BOOT));
+	EXPECT_EQ(gameboy->get_state_hash(), booted->get_state_hash());
+
+	// Both carry on the same, and draw the same frames
+	run_frames(gameboy.get(), 30);
+	run_frames(booted.get(), 30);
+	EXPECT_EQ(gameboy->get_state_hash(), booted->get_state_hash());
+	auto video = static_cast<BufferVideo *>(gameboy->video.get());
+	auto booted_video = static_cast<BufferVideo *>(booted->video.get());
+	EXPECT_EQ(video->get_buffer(), booted_video->get_buffer());
+}
+
+TEST_F(ResetTest, PowerOnMatchesANewGameboy) {
+	auto gameboy = make_unique<Gameboy>(rom_path);
+	auto initial_hash = gameboy->get_state_hash();
+
+	run_frames(gameboy.get(), 200);
+	ASSERT_TRUE(gameboy->reset(ResetMode::POWER_ON));
+	EXPECT_EQ(gameboy->get_state_hash(), initial_hash);
+	EXPECT_EQ(gameboy->memory->read(0xFF50), 0);
+}
+
+TEST_F(ResetTest, ResetsToTheSnapshot) {
+	auto gameboy = make_unique<Gameboy>(rom_path);
+	EXPECT_FALSE(gameboy->reset(ResetMode::SNAPSHOT));
+
+	run_frames(gameboy.get(), 200);
+	auto snapshot = make_shared<SaveState>();
+	gameboy->save_state(*snapshot);
+	gameboy->set_reset_snapshot(snapshot);
+	auto saved_hash = gameboy->get_state_hash();
+
+	run_frames(gameboy.get(), 10);
+	EXPECT_NE(gameboy->get_state_hash(), saved_hash);
+	ASSERT_TRUE(gameboy->reset(ResetMode::SNAPSHOT));
+	EXPECT_EQ(gameboy->get_state_hash(), saved_hash);
+}
+
+TEST_F(ResetTest, ConcurrentResetsShareOneBoot) {
+	auto gameboys = vector<unique_ptr<Gameboy>>();
+	for (auto i = 0; i < 4; ++i) {
+		gameboys.push_back(make_unique<Gameboy>(rom_path));
+	}
+
+	auto threads = vector<thread>();
+	// A byte each, since vector<bool> packs them into words the threads share
+	auto results = vector<uint8_t>(gameboys.size());
+	for (size_t i = 0; i < gameboys.size(); ++i) {
+		threads.emplace_back([&, i] {
+			results[i] = gameboys[i]->reset(ResetMode::POST_BOOT);
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	for (size_t i = 0; i < gameboys.size(); ++i) {
+		EXPECT_TRUE(results[i]);
+		EXPECT_EQ(gameboys[i]->get_state_hash(),
+		          gameboys[0]->get_state_hash());
+	}
+}
@@ -0,0 +1,115 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/rewind_buffer.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class RewindBufferTest : public TestRomTest {
+  protected:
+	unique_ptr<Gameboy> gameboy;
+	unique_ptr<SaveState> state = make_unique<SaveState>();
+
+	void SetUp() override {
+		gameboy = make_unique<Gameboy>(rom_path);
+		run_frames(gameboy.get(), 200);
+	}
+
+	/**
+	 * Run a frame, push the state, and return its hash
+	 */
+	uint64_t push_frame(RewindBuffer &rewind) {
+		gameboy->run_frame();
+		gameboy->save_state(*state);
+		rewind.push(*state);
+		return gameboy->get_state_hash();
+	}
+};
+
+TEST_F(RewindBufferTest, StepsBackExactly) {
+	auto rewind = RewindBuffer(64 << 20);
+	auto hashes = vector<uint64_t>();
+	for (auto i = 0; i < 50; ++i) {
+		hashes.push_back(push_frame(rewind));
+	}
+	EXPECT_EQ(rewind.get_size(), 50u);
+
+	// Each step gives back the states in reverse, whether or not the
+	// compressor has got to them yet
+	for (auto i = 49; i >= 0; --i) {
+		ASSERT_TRUE(rewind.pop(*state));
+		ASSERT_TRUE(gameboy->load_state(*state));
+		EXPECT_EQ(gameboy->get_state_hash(), hashes[i]);
+	}
+	EXPECT_EQ(rewind.get_size(), 0u);
+	EXPECT_FALSE(rewind.pop(*state));
+}
+
+TEST_F(RewindBufferTest, CarriesOnAfterRewinding) {
+	auto rewind = RewindBuffer(64 << 20);
+	auto first = push_frame(rewind);
+	push_frame(rewind);
+	push_frame(rewind);
+
+	ASSERT_TRUE(rewind.pop(*state));
+	ASSERT_TRUE(rewind.pop(*state));
+	gameboy->load_state(*state);
+	auto replaced = push_frame(rewind);
+
+	ASSERT_TRUE(rewind.pop(*state));
+	gameboy->load_state(*state);
+	EXPECT_EQ(gameboy->get_state_hash(), replaced);
+	ASSERT_TRUE(rewind.pop(*state));
+	gameboy->load_state(*state);
+	EXPECT_EQ(gameboy->get_state_hash(), first);
+}
+
+TEST_F(RewindBufferTest, StaysWithinBudget) {
+	// Room for a couple of uncompressed deltas at most
+	auto budget = 2 * sizeof(SaveState);
+	auto rewind = RewindBuffer(budget);
+	auto hashes = vector<uint64_t>();
+	for (auto i = 0; i < 100; ++i) {
+		hashes.push_back(push_frame(rewind));
+		EXPECT_LE(rewind.get_used(), budget);
+	}
+
+	// The newest states are the ones kept
+	auto size = rewind.get_size();
+	EXPECT_LT(size, 100u);
+	for (auto i = 0u; i < size; ++i) {
+		ASSERT_TRUE(rewind.pop(*state));
+		gameboy->load_state(*state);
+		EXPECT_EQ(gameboy->get_state_hash(), hashes[99 - i]);
+	}
+}
+
+TEST_F(RewindBufferTest, StepsThroughCompressedDeltas) {
+	auto rewind = RewindBuffer(64 << 20);
+	auto hashes = vector<uint64_t>();
+	for (auto i = 0; i < 100; ++i) {
+		hashes.push_back(push_frame(rewind));
+	}
+
+	// Let the compressor catch up, so that steps go through compressed
+	// deltas
+	auto used = size_t{0};
+	while (used != rewind.get_used()) {
+		used = rewind.get_used();
+		this_thread::sleep_for(chrono::milliseconds(20));
+	}
+	EXPECT_LT(used, 100 * sizeof(SaveState) / 4);
+
+	for (auto i = 0; i < 100; ++i) {
+		ASSERT_TRUE(rewind.pop(*state));
+		gameboy->load_state(*state);
+		EXPECT_EQ(gameboy->get_state_hash(), hashes[99 - i]);
+	}
+}
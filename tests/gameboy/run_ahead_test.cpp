@@ -0,0 +1,67 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+#include "video/buffer_video.h"
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class RunAheadTest : public TestRomTest {
+  protected:
+	unique_ptr<Gameboy> ahead;
+	unique_ptr<Gameboy> plain;
+
+	void SetUp() override {
+		ahead = make_unique<Gameboy>(rom_path);
+		plain = make_unique<Gameboy>(rom_path);
+		for (auto i = 0; i < 200; ++i) {
+			ahead->run_frame();
+			plain->run_frame();
+		}
+	}
+
+	BufferVideo *get_video(Gameboy *gameboy) {
+		return static_cast<BufferVideo *>(gameboy->video.get());
+	}
+};
+
+TEST_F(RunAheadTest, ShowsTheFrameAhead) {
+	auto frames_shown = get_video(ahead.get())->get_frame_count();
+	plain->run_frame();
+	plain->run_frame();
+
+	for (auto i = 0; i < 20; ++i) {
+		ahead->run_ahead(2);
+		plain->run_frame();
+
+		// The emulator only moved on by one frame, but shows the frame that
+		// is two further on
+		EXPECT_EQ(get_video(ahead.get())->get_buffer(),
+		          get_video(plain.get())->get_buffer());
+	}
+
+	// The Video driver only saw one frame each time
+	EXPECT_EQ(get_video(ahead.get())->get_frame_count(), frames_shown + 20);
+}
+
+TEST_F(RunAheadTest, LeavesTheStateAsOneFrame) {
+	for (auto i = 0; i < 20; ++i) {
+		ahead->run_ahead(3);
+		plain->run_frame();
+		EXPECT_EQ(ahead->get_state_hash(), plain->get_state_hash());
+	}
+
+	auto stats = ahead->get_run_ahead_stats();
+	EXPECT_EQ(stats.frames, 20u);
+	EXPECT_GT(stats.run_ahead_us, stats.frame_us);
+}
+
+TEST_F(RunAheadTest, NoFramesAheadIsAPlainFrame) {
+	ahead->run_ahead(0);
+	plain->run_frame();
+	EXPECT_EQ(ahead->get_state_hash(), plain->get_state_hash());
+	EXPECT_EQ(get_video(ahead.get())->get_buffer(),
+	          get_video(plain.get())->get_buffer());
+}
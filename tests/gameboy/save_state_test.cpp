@@ -0,0 +1,78 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class SaveStateTest : public TestRomTest {
+  protected:
+	unique_ptr<Gameboy> gameboy;
+
+	void SetUp() override {
+		gameboy = make_unique<Gameboy>(rom_path);
+
+		// Get past the boot ROM, into the program
+		run_frames(gameboy.get(), 200);
+		ASSERT_EQ(gameboy->memory->read(0xFF50), 1);
+	}
+};
+
+TEST_F(SaveStateTest, RestoresExactly) {
+	auto saved = make_unique<SaveState>();
+	gameboy->save_state(*saved);
+	auto saved_hash = gameboy->get_state_hash();
+	auto saved_count = gameboy->memory->read(0xC000);
+
+	run_frames(gameboy.get(), 30);
+	auto hash = gameboy->get_state_hash();
+	EXPECT_NE(hash, saved_hash);
+	EXPECT_NE(gameboy->memory->read(0xC000), saved_count);
+
+	// Loading puts everything back, and the same frames run the same way
+	ASSERT_TRUE(gameboy->load_state(*saved));
+	EXPECT_EQ(gameboy->get_state_hash(), saved_hash);
+	EXPECT_EQ(gameboy->memory->read(0xC000), saved_count);
+
+	auto resaved = make_unique<SaveState>();
+	gameboy->save_state(*resaved);
+	EXPECT_EQ(memcmp(saved.get(), resaved.get(), sizeof(SaveState)), 0);
+
+	run_frames(gameboy.get(), 30);
+	EXPECT_EQ(gameboy->get_state_hash(), hash);
+}
+
+TEST_F(SaveStateTest, RejectsOtherStates) {
+	auto state = make_unique<SaveState>();
+	gameboy->save_state(*state);
+	auto hash = gameboy->get_state_hash();
+	run_frames(gameboy.get(), 1);
+
+	auto other = make_unique<SaveState>(*state);
+	other->version++;
+	EXPECT_FALSE(gameboy->load_state(*other));
+
+	other = make_unique<SaveState>(*state);
+	other->rom_checksum++;
+	EXPECT_FALSE(gameboy->load_state(*other));
+
+	EXPECT_NE(gameboy->get_state_hash(), hash);
+	EXPECT_TRUE(gameboy->load_state(*state));
+	EXPECT_EQ(gameboy->get_state_hash(), hash);
+}
+
+TEST_F(SaveStateTest, RoundTripsLeaveTheStateAlone) {
+	// Saving and loading is done every frame by run-ahead and rewind, so
+	// doing it over and over must not change anything
+	auto state = make_unique<SaveState>();
+	auto hash = gameboy->get_state_hash();
+	for (auto i = 0; i < 100; ++i) {
+		gameboy->save_state(*state);
+		ASSERT_TRUE(gameboy->load_state(*state));
+	}
+	EXPECT_EQ(gameboy->get_state_hash(), hash);
+}
@@ -0,0 +1,76 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class SkipBootTest : public TestRomTest {
+  protected:
+	/**
+	 * Check that two Gameboys are in the same state, apart from how long
+	 * they have run for
+	 */
+	void expect_same_state(Gameboy *gameboy, Gameboy *expected) {
+		auto state = make_unique<SaveState>();
+		auto expected_state = make_unique<SaveState>();
+		gameboy->save_state(*state);
+		expected->save_state(*expected_state);
+
+		auto &cpu = state->cpu;
+		auto &expected_cpu = expected_state->cpu;
+		EXPECT_EQ(cpu.a, expected_cpu.a);
+		EXPECT_EQ(cpu.f, expected_cpu.f);
+		EXPECT_EQ(cpu.b, expected_cpu.b);
+		EXPECT_EQ(cpu.c, expected_cpu.c);
+		EXPECT_EQ(cpu.d, expected_cpu.d);
+		EXPECT_EQ(cpu.e, expected_cpu.e);
+		EXPECT_EQ(cpu.h, expected_cpu.h);
+		EXPECT_EQ(cpu.l, expected_cpu.l);
+		EXPECT_EQ(cpu.sp, expected_cpu.sp);
+		EXPECT_EQ(cpu.pc, expected_cpu.pc);
+		EXPECT_EQ(cpu.interrupt_enable, expected_cpu.interrupt_enable);
+		EXPECT_EQ(cpu.interrupt_flag, expected_cpu.interrupt_flag);
+		EXPECT_EQ(cpu.interrupt_enabled, expected_cpu.interrupt_enabled);
+		EXPECT_EQ(cpu.halted, expected_cpu.halted);
+
+		auto &gpu = state->gpu;
+		auto &expected_gpu = expected_state->gpu;
+		EXPECT_EQ(gpu.registers, expected_gpu.registers);
+		EXPECT_EQ(gpu.mode, expected_gpu.mode);
+		EXPECT_EQ(gpu.lcd_enabled, expected_gpu.lcd_enabled);
+		EXPECT_EQ(gpu.current_cycles, expected_gpu.current_cycles);
+
+		for (auto address = size_t{0}; address < state->memory.size();
+		     ++address) {
+			EXPECT_EQ(state->memory[address], expected_state->memory[address])
+			    << "at " << hex << address;
+		}
+	}
+};
+
+TEST_F(SkipBootTest, MatchesRunningTheBootRom) {
+	auto booted = make_unique<Gameboy>(rom_path);
+	while (booted->cpu->get_pc() != 0x100 ||
+	       booted->memory->read(0xFF50) == 0) {
+		booted->step();
+	}
+
+	auto gameboy = make_unique<Gameboy>(rom_path);
+	gameboy->skip_boot();
+	EXPECT_EQ(gameboy->memory->read(0xFF40), 0x91);
+	EXPECT_EQ(gameboy->memory->read(0xFF47), 0xFC);
+	expect_same_state(gameboy.get(), booted.get());
+
+	// Both carry on the same, and draw the same frames
+	for (auto i = 0; i < 30; ++i) {
+		gameboy->run_frame();
+		booted->run_frame();
+	}
+	expect_same_state(gameboy.get(), booted.get());
+	auto video = static_cast<BufferVideo *>(gameboy->video.get());
+	auto booted_video = static_cast<BufferVideo *>(booted->video.get());
+	EXPECT_EQ(video->get_buffer(), booted_video->get_buffer());
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "gameboy/gameboy.h"
+#include "memory/utils.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * Make a name for a file or other resource that belongs to the running test.
+ * ctest runs every test in its own process, in parallel with -j, so the name
+ * has the test and the process in it.
+ *
+ * @param suffix Added to the end of the name, such as an extension
+ */
+inline std::string get_test_name(const std::string &suffix) {
+	auto info = testing::UnitTest::GetInstance()->current_test_info();
+	auto name = std::string(info->test_suite_name()) + "_" + info->name() +
+	            "_" + std::to_string(getpid()) + suffix;
+	std::replace(name.begin(), name.end(), '/', '_');
+	return name;
+}
+
+/**
+ * Write a 32KB ROM that the boot ROM accepts. Once booted, it counts up at
+ * 0xC000 forever and scrolls the background by the count, so that memory and
+ * the GPU keep changing.
+ *
+ * @param path Path to write the ROM to, by default one for the running test
+ * @return The path, for passing to Gameboy
+ */
+inline std::string
+make_test_rom(const std::string &path = get_test_name(".gb")) {
+	auto rom = std::vector<uint8_t>(0x8000, 0);
+
+	// NOP, then JP 0x0150 past the header
+	const uint8_t entry[] = {0x00, 0xC3, 0x50, 0x01};
+	std::copy(std::begin(entry), std::end(entry), rom.begin() + 0x100);
+
+	// The boot ROM checks the logo against its own copy, and the header
+	// checksum over 0x134 to 0x14C
+	std::copy(boot.begin() + 0xA8, boot.begin() + 0xD8, rom.begin() + 0x104);
+	auto checksum = uint8_t{0};
+	for (auto i = 0x134; i <= 0x14C; ++i) {
+		checksum = checksum - rom[i] - 1;
+	}
+	rom[0x14D] = checksum;
+
+	// LD HL, 0xC000; loop: INC (HL); LD A, (HL); LDH (SCX), A; JR loop
+	const uint8_t program[] = {0x21, 0x00, 0xC0, 0x34, 0x7E,
+	                           0xE0, 0x43, 0x18, 0xFA};
+	std::copy(std::begin(program), std::end(program), rom.begin() + 0x150);
+
+	auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char *>(rom.data()), rom.size());
+	return path;
+}
+
+/**
+ * Base for fixtures that run the test ROM. The ROM is written for each test,
+ * and removed once the test and the fixture's own TearDown are done.
+ */
+class TestRomTest : public testing::Test {
+  protected:
+	std::string rom_path = make_test_rom();
+
+	~TestRomTest() override { std::remove(rom_path.c_str()); }
+};
+
+/**
+ * Run a Gameboy for some frames
+ */
+inline void run_frames(gameboy::Gameboy *target, int frames) {
+	for (auto i = 0; i < frames; ++i) {
+		target->run_frame();
+	}
+}
@@ -0,0 +1,181 @@
+#include "libtvp/tvp.h"
+
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+#include "util/allocation_counter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class TvpTest : public TestRomTest {
+  protected:
+	vector<uint8_t> rom = read_rom();
+	tvp_gameboy *tvp = tvp_create(rom.data(), rom.size(), 0);
+
+	void TearDown() override { tvp_destroy(tvp); }
+
+	vector<uint8_t> read_rom() {
+		auto file = ifstream(rom_path, ios::binary);
+		return vector<uint8_t>(istreambuf_iterator<char>(file),
+		                       istreambuf_iterator<char>());
+	}
+
+	vector<uint8_t> get_frame() {
+		auto frame = tvp_get_frame(tvp);
+		return vector<uint8_t>(
+		    frame, frame + TVP_SCREEN_WIDTH * TVP_SCREEN_HEIGHT);
+	}
+};
+
+TEST_F(TvpTest, MatchesGameboy) {
+	ASSERT_NE(tvp, nullptr);
+	EXPECT_EQ(tvp_api_version(), TVP_API_VERSION);
+
+	auto gameboy = make_unique<Gameboy>(rom_path);
+	auto video = static_cast<BufferVideo *>(gameboy->video.get());
+	auto frame = tvp_get_frame(tvp);
+	auto cycles = uint64_t{0};
+	for (auto i = 0; i < 120; ++i) {
+		auto buttons = static_cast<uint8_t>(i % 3 == 0 ? TVP_BUTTON_A : 0);
+		tvp_set_buttons(tvp, buttons);
+		gameboy->set_buttons(buttons);
+		cycles += tvp_run_frame(tvp);
+		gameboy->run_frame();
+	}
+
+	// The frame is drawn in place, so the pointer never changes
+	EXPECT_EQ(tvp_get_frame(tvp), frame);
+	auto &buffer = video->get_buffer();
+	EXPECT_EQ(memcmp(frame, buffer.data(), buffer.size()), 0);
+	EXPECT_EQ(tvp_get_cycle_count(tvp), cycles);
+	EXPECT_EQ(tvp_read_memory(tvp, 0xC000), gameboy->memory->read(0xC000));
+}
+
+TEST_F(TvpTest, RejectsBadRoms) {
+	EXPECT_EQ(tvp_create(nullptr, rom.size(), 0), nullptr);
+	EXPECT_EQ(tvp_create(rom.data(), 0x4000, 0), nullptr);
+	tvp_destroy(nullptr);
+}
+
+TEST_F(TvpTest, SkipsTheBootRom) {
+	auto skipped = tvp_create(rom.data(), rom.size(), TVP_SKIP_BOOT);
+	ASSERT_NE(skipped, nullptr);
+	EXPECT_EQ(tvp_read_memory(skipped, 0xFF50), 1);
+	EXPECT_EQ(tvp_read_memory(skipped, 0xFF40), 0x91);
+	tvp_destroy(skipped);
+}
+
+TEST_F(TvpTest, SavesIntoCallerBuffers) {
+	for (auto i = 0; i < 30; ++i) {
+		tvp_run_frame(tvp);
+	}
+
+	// One buffer is aligned and one is not, which goes through a copy
+	auto size = tvp_state_size();
+	auto aligned = vector<uint64_t>(size / sizeof(uint64_t) + 1);
+	auto unaligned = vector<uint8_t>(size + 1);
+	EXPECT_EQ(tvp_save_state(tvp, aligned.data(), size - 1), 0);
+	ASSERT_EQ(tvp_save_state(tvp, aligned.data(), size), 1);
+	ASSERT_EQ(tvp_save_state(tvp, unaligned.data() + 1, size), 1);
+	EXPECT_EQ(memcmp(aligned.data(), unaligned.data() + 1, size), 0);
+
+	auto frame = get_frame();
+	auto cycles = tvp_get_cycle_count(tvp);
+	auto counter = tvp_read_memory(tvp, 0xC000);
+	for (auto i = 0; i < 30; ++i) {
+		tvp_run_frame(tvp);
+	}
+	EXPECT_NE(tvp_get_cycle_count(tvp), cycles);
+
+	for (auto buffer : {static_cast<const void *>(aligned.data()),
+	                    static_cast<const void *>(unaligned.data() + 1)}) {
+		EXPECT_EQ(tvp_load_state(tvp, buffer, size - 1), 0);
+		ASSERT_EQ(tvp_load_state(tvp, buffer, size), 1);
+		EXPECT_EQ(get_frame(), frame);
+		EXPECT_EQ(tvp_get_cycle_count(tvp), cycles);
+		EXPECT_EQ(tvp_read_memory(tvp, 0xC000), counter);
+	}
+
+	// A state from another ROM is turned down
+	auto other_rom = rom;
+	other_rom[0x200] = 0xFF;
+	auto other = tvp_create(other_rom.data(), other_rom.size(), 0);
+	EXPECT_EQ(tvp_load_state(other, aligned.data(), size), 0);
+	tvp_destroy(other);
+}
+
+TEST_F(TvpTest, ReadsAndWritesMemory) {
+	tvp_write_memory(tvp, 0xC123, 0x42);
+	EXPECT_EQ(tvp_read_memory(tvp, 0xC123), 0x42);
+
+	// The ROM can be read, but not written
+	EXPECT_EQ(tvp_read_memory(tvp, 0x150), 0x21);
+	tvp_write_memory(tvp, 0x150, 0x00);
+	EXPECT_EQ(tvp_read_memory(tvp, 0x150), 0x21);
+}
+
+TEST_F(TvpTest, ListsMemoryChangesEachFrame) {
+	auto skipped = tvp_create(rom.data(), rom.size(), TVP_SKIP_BOOT);
+	tvp_watch_memory(skipped, 0xC000, 0xC0FF);
+
+	auto count = size_t{0};
+	for (auto i = 0; i < 3; ++i) {
+		auto before = tvp_read_memory(skipped, 0xC000);
+		tvp_run_frame(skipped);
+		auto changes = tvp_get_memory_changes(skipped, &count);
+		ASSERT_EQ(count, 1u);
+		EXPECT_EQ(changes[0].address, 0xC000);
+		EXPECT_EQ(changes[0].old_value, before);
+		EXPECT_EQ(changes[0].new_value, tvp_read_memory(skipped, 0xC000));
+	}
+
+	tvp_clear_memory_watches(skipped);
+	tvp_run_frame(skipped);
+	tvp_get_memory_changes(skipped, &count);
+	EXPECT_EQ(count, 0u);
+	tvp_destroy(skipped);
+}
+
+TEST_F(TvpTest, RunsFramesWithoutAllocating) {
+	// Each loop reads and writes registers that aren't emulated and writes to
+	// ROM, which are only logged when logging is on
+	const uint8_t program[] = {
+	    0x21, 0x00, 0xC0, // LD HL, 0xC000
+	    0x34,             // loop: INC (HL)
+	    0xF0, 0x04,       // LDH A, (DIV)
+	    0x7E,             // LD A, (HL)
+	    0xE0, 0x04,       // LDH (DIV), A
+	    0xE0, 0x12,       // LDH (NR12), A
+	    0xE0, 0x01,       // LDH (SB), A
+	    0xEA, 0x00, 0x20, // LD (0x2000), A
+	    0x18, 0xF1,       // JR loop
+	};
+	auto writer_rom = rom;
+	copy(begin(program), end(program), writer_rom.begin() + 0x150);
+	auto writer =
+	    tvp_create(writer_rom.data(), writer_rom.size(), TVP_SKIP_BOOT);
+	ASSERT_NE(writer, nullptr);
+
+	// The first writes to a page of RAM give it its own copy
+	for (auto i = 0; i < 10; ++i) {
+		tvp_run_frame(writer);
+	}
+	auto counter = tvp_read_memory(writer, 0xC000);
+	start_counting_allocations();
+	for (auto i = 0; i < 60; ++i) {
+		tvp_run_frame(writer);
+	}
+	auto count = stop_counting_allocations();
+	EXPECT_EQ(count.allocations, 0u);
+	EXPECT_NE(tvp_read_memory(writer, 0xC000), counter);
+	tvp_destroy(writer);
+}
@@ -0,0 +1,121 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+using namespace std;
+using namespace gameboy;
+
+class MemoryWatchTest : public TestRomTest {
+  protected:
+	unique_ptr<Gameboy> gameboy = make_unique<Gameboy>(rom_path);
+
+	void SetUp() override { gameboy->skip_boot(); }
+};
+
+TEST_F(MemoryWatchTest, ListsChangesToWatchedAddresses) {
+	auto &memory = *gameboy->memory;
+	memory.watch_range(0xC000, 0xC001);
+	gameboy->run_frame();
+	memory.clear_changes();
+
+	// The test ROM counts up at 0xC000 many times a frame, which is listed
+	// once, from the value before the frame to the one after
+	auto before = memory.read(0xC000);
+	gameboy->run_frame();
+	auto &changes = memory.get_changes();
+	ASSERT_EQ(changes.size(), 1u);
+	EXPECT_EQ(changes[0].address, 0xC000);
+	EXPECT_EQ(changes[0].old_value, before);
+	EXPECT_EQ(changes[0].new_value, memory.read(0xC000));
+
+	// The list never grows past the watched addresses, so it is never moved
+	auto data = changes.data();
+	for (auto i = 0; i < 10; ++i) {
+		memory.clear_changes();
+		gameboy->run_frame();
+		EXPECT_EQ(memory.get_changes().data(), data);
+	}
+}
+
+TEST_F(MemoryWatchTest, OnlyListsWatchedAddressesThatChange) {
+	auto &memory = *gameboy->memory;
+	memory.watch_range(0xC100, 0xC102);
+	memory.watch_range(0xFF80, 0xFF80);
+
+	// Writing what is already there is not a change, and other addresses on
+	// the same page are not watched
+	memory.write(0xC100, memory.read(0xC100));
+	memory.write(0xC103, 0x12);
+	gameboy->run_frame();
+	EXPECT_TRUE(memory.get_changes().empty());
+
+	// Writes through Echo RAM change the Work RAM below it
+	memory.write(0xFF80, 0x34);
+	memory.write(0xE101, 0x56);
+	memory.write(0xC102, 0x78);
+	memory.write(0xC102, 0x00);
+	auto &changes = memory.get_changes();
+	ASSERT_EQ(changes.size(), 3u);
+	EXPECT_EQ(changes[0].address, 0xFF80);
+	EXPECT_EQ(changes[0].new_value, 0x34);
+	EXPECT_EQ(changes[1].address, 0xC101);
+	EXPECT_EQ(changes[1].new_value, 0x56);
+
+	// An address written back to where it started is still listed
+	EXPECT_EQ(changes[2].address, 0xC102);
+	EXPECT_EQ(changes[2].old_value, 0x00);
+	EXPECT_EQ(changes[2].new_value, 0x00);
+
+	memory.clear_changes();
+	EXPECT_TRUE(memory.get_changes().empty());
+	memory.write(0xC101, 0x57);
+	ASSERT_EQ(memory.get_changes().size(), 1u);
+	EXPECT_EQ(memory.get_changes()[0].old_value, 0x56);
+}
+
+TEST_F(MemoryWatchTest, WatchesEchoRamAsWorkRam) {
+	auto &memory = *gameboy->memory;
+	memory.watch_range(0xE100, 0xE100);
+
+	// Writes to either address change the Work RAM byte, and are listed there
+	memory.write(0xE100, 0x12);
+	ASSERT_EQ(memory.get_changes().size(), 1u);
+	EXPECT_EQ(memory.get_changes()[0].address, 0xC100);
+	EXPECT_EQ(memory.get_changes()[0].new_value, 0x12);
+
+	memory.clear_changes();
+	memory.write(0xC100, 0x34);
+	ASSERT_EQ(memory.get_changes().size(), 1u);
+	EXPECT_EQ(memory.get_changes()[0].old_value, 0x12);
+	EXPECT_EQ(memory.get_changes()[0].new_value, 0x34);
+
+	// A range across the start of Echo RAM keeps the Work RAM before it
+	memory.clear_watches();
+	memory.watch_range(0xDFFF, 0xE001);
+	memory.write(0xDFFF, 0x56);
+	memory.write(0xE001, 0x78);
+	memory.write(0xE002, 0x9A);
+	auto &changes = memory.get_changes();
+	ASSERT_EQ(changes.size(), 2u);
+	EXPECT_EQ(changes[0].address, 0xDFFF);
+	EXPECT_EQ(changes[1].address, 0xC001);
+}
+
+TEST_F(MemoryWatchTest, StopsWatching) {
+	auto &memory = *gameboy->memory;
+	memory.watch_range(0xC000, 0xC000);
+	gameboy->run_frame();
+	EXPECT_FALSE(memory.get_changes().empty());
+
+	memory.clear_watches();
+	EXPECT_TRUE(memory.get_changes().empty());
+	gameboy->run_frame();
+	EXPECT_TRUE(memory.get_changes().empty());
+
+	// Addresses outside RAM are left out
+	memory.watch_range(0x8000, 0x9FFF);
+	memory.write(0x8000, 0x12);
+	EXPECT_TRUE(memory.get_changes().empty());
+}
@@ -13,6 +13,8 @@ using namespace memory;
 class MemoryMock : public MemoryInterface {
 	MOCK_CONST_METHOD1(read, uint8_t(Address));
 	MOCK_METHOD2(write, void(Address, uint8_t));
+	MOCK_CONST_METHOD0(get_vram, VRAMSpan());
+	MOCK_CONST_METHOD0(get_oam, OAMSpan());
 	MOCK_METHOD1(set_cpu, void(cpu::CPUInterface *_cpu));
 	MOCK_METHOD1(set_gpu, void(gpu::GPUInterface *_gpu));
 };
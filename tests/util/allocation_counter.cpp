@@ -0,0 +1,35 @@
+#include "util/allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+/**
+ * Allocations made on this thread while counting is on
+ */
+static thread_local bool counting = false;
+static thread_local AllocationCount count;
+
+void *operator new(size_t size) {
+	if (counting) {
+		count.allocations++;
+		count.bytes += size;
+	}
+	if (auto pointer = std::malloc(size)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+
+void start_counting_allocations() {
+	count = AllocationCount();
+	counting = true;
+}
+
+AllocationCount stop_counting_allocations() {
+	counting = false;
+	return count;
+}
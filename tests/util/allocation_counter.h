@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * What operator new handed out on one thread while counting
+ */
+struct AllocationCount {
+	size_t allocations = 0;
+	size_t bytes = 0;
+};
+
+/**
+ * Count the allocations made on this thread from now on. The test binary
+ * replaces the global operator new, so allocations made inside libtvp are
+ * counted too.
+ */
+void start_counting_allocations();
+
+/**
+ * Stop counting the allocations made on this thread
+ *
+ * @return What was allocated since start_counting_allocations
+ */
+AllocationCount stop_counting_allocations();
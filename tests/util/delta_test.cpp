@@ -0,0 +1,63 @@
+#include "util/delta.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+
+TEST(DeltaTest, RoundTrip) {
+	auto before = vector<uint8_t>(10000);
+	for (auto i = 0u; i < before.size(); ++i) {
+		before[i] = static_cast<uint8_t>(i * 7);
+	}
+
+	// Change a few scattered bytes, a short run, and the very last byte
+	auto after = before;
+	after[3] ^= 0x10;
+	after[500] = 0;
+	for (auto i = 4000u; i < 4100; ++i) {
+		after[i] = static_cast<uint8_t>(i);
+	}
+	after.back() ^= 0xFF;
+
+	auto delta = vector<uint8_t>(before.size());
+	xor_bytes(before.data(), after.data(), delta.data(), delta.size());
+
+	auto compressed = vector<uint8_t>();
+	compress_delta(delta.data(), delta.size(), compressed);
+	EXPECT_LT(compressed.size(), 200u);
+
+	// The delta takes either block to the other
+	auto target = before;
+	ASSERT_TRUE(apply_delta(compressed, target.data(), target.size()));
+	EXPECT_EQ(target, after);
+	ASSERT_TRUE(apply_delta(compressed, target.data(), target.size()));
+	EXPECT_EQ(target, before);
+}
+
+TEST(DeltaTest, EmptyDelta) {
+	auto delta = vector<uint8_t>(4096, 0);
+	auto compressed = vector<uint8_t>();
+	compress_delta(delta.data(), delta.size(), compressed);
+	EXPECT_LE(compressed.size(), 3u);
+
+	auto target = vector<uint8_t>(4096, 0xAB);
+	ASSERT_TRUE(apply_delta(compressed, target.data(), target.size()));
+	EXPECT_EQ(target, vector<uint8_t>(4096, 0xAB));
+}
+
+TEST(DeltaTest, RejectsDeltasThatDontFit) {
+	auto delta = vector<uint8_t>(100, 1);
+	auto compressed = vector<uint8_t>();
+	compress_delta(delta.data(), delta.size(), compressed);
+
+	auto target = vector<uint8_t>(50);
+	EXPECT_FALSE(apply_delta(compressed, target.data(), target.size()));
+
+	compressed.pop_back();
+	target = vector<uint8_t>(100);
+	EXPECT_FALSE(apply_delta(compressed, target.data(), target.size()));
+}
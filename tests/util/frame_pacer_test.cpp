@@ -0,0 +1,67 @@
+#include "util/frame_pacer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace testing;
+using namespace std;
+using namespace std::chrono;
+
+TEST(FramePacerTest, ClampsSpeed) {
+	auto pacer = FramePacer(1000);
+
+	pacer.set_speed(1000.0);
+	EXPECT_EQ(pacer.get_speed(), FramePacer::MAX_SPEED);
+
+	pacer.set_speed(0.0);
+	EXPECT_EQ(pacer.get_speed(), FramePacer::MIN_SPEED);
+}
+
+TEST(FramePacerTest, WaitsForEmulatedTime) {
+	// 1000 cycles per second, so 10 cycles take 10ms. The pacer starts
+	// timing from when it is created.
+	auto start = steady_clock::now();
+	auto pacer = FramePacer(1000);
+
+	for (auto i = 0; i < 5; ++i) {
+		pacer.pace(10);
+	}
+	auto elapsed = steady_clock::now() - start;
+
+	EXPECT_GE(elapsed, milliseconds(50));
+	EXPECT_EQ(pacer.get_stats().frames, 5u);
+}
+
+TEST(FramePacerTest, SpeedShortensWait) {
+	auto start = steady_clock::now();
+	auto pacer = FramePacer(1000);
+	auto first_deadline = pacer.get_deadline();
+	pacer.set_speed(4.0);
+
+	for (auto i = 0; i < 4; ++i) {
+		pacer.pace(10);
+	}
+	auto elapsed = steady_clock::now() - start;
+
+	// 40 cycles at 4x speed are due 10ms after the pacer started. How long
+	// the waits really took depends on the machine, so only the deadline is
+	// checked exactly.
+	EXPECT_EQ(pacer.get_deadline() - first_deadline, milliseconds(10));
+	EXPECT_GE(elapsed, milliseconds(10));
+}
+
+TEST(FramePacerTest, TurboNeverWaits) {
+	auto pacer = FramePacer(1000);
+	pacer.set_turbo(true);
+
+	// A million cycles would be due in 1000s, but turbo moves the deadline
+	// to now instead
+	auto before = steady_clock::now();
+	pacer.pace(1000000);
+
+	EXPECT_LE(pacer.get_deadline(), steady_clock::now());
+	EXPECT_GE(pacer.get_deadline(), before);
+	EXPECT_TRUE(pacer.is_late());
+	EXPECT_EQ(pacer.get_stats().frames, 0u);
+}
@@ -0,0 +1,42 @@
+#include "util/frame_skipper.h"
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+using namespace std;
+
+TEST(FrameSkipperTest, RendersEveryFrameByDefault) {
+	auto skipper = FrameSkipper();
+
+	for (auto i = 0; i < 10; ++i) {
+		EXPECT_TRUE(skipper.should_render(true));
+	}
+}
+
+TEST(FrameSkipperTest, FixedSkip) {
+	auto skipper = FrameSkipper(2);
+
+	for (auto i = 0; i < 9; ++i) {
+		EXPECT_EQ(skipper.should_render(false), i % 3 == 0);
+	}
+}
+
+TEST(FrameSkipperTest, AutoSkipsOnlyWhenLate) {
+	auto skipper = FrameSkipper(0, true);
+
+	EXPECT_TRUE(skipper.should_render(false));
+	EXPECT_FALSE(skipper.should_render(true));
+	EXPECT_FALSE(skipper.should_render(true));
+	EXPECT_TRUE(skipper.should_render(false));
+}
+
+TEST(FrameSkipperTest, AutoStillRendersSometimes) {
+	auto skipper = FrameSkipper(0, true);
+
+	auto rendered = 0;
+	for (auto i = 0u; i < FrameSkipper::MAX_AUTO_SKIP * 4; ++i) {
+		rendered += skipper.should_render(true);
+	}
+
+	EXPECT_GE(rendered, 3);
+}
@@ -0,0 +1,32 @@
+#include "util/hash.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+
+TEST(HashTest, MatchesXXH64) {
+	auto hash = [](const string &text) {
+		return hash_bytes(text.data(), text.size());
+	};
+
+	EXPECT_EQ(hash(""), 0xEF46DB3751D8E999ULL);
+	EXPECT_EQ(hash("a"), 0xD24EC4F1A98C6E5BULL);
+	EXPECT_EQ(hash("abc"), 0x44BC2CF5AD770999ULL);
+	EXPECT_EQ(hash("Nobody inspects the spammish repetition"),
+	          0xFBCEA83C8A378BF1ULL);
+}
+
+TEST(HashTest, DetectsSingleByteChange) {
+	auto frame = vector<uint8_t>(160 * 144, 0);
+	auto before = hash_bytes(frame.data(), frame.size());
+
+	frame[12345] = 1;
+	EXPECT_NE(hash_bytes(frame.data(), frame.size()), before);
+
+	frame[12345] = 0;
+	EXPECT_EQ(hash_bytes(frame.data(), frame.size()), before);
+}
@@ -0,0 +1,63 @@
+#include "util/spsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace testing;
+using namespace std;
+
+TEST(SPSCQueueTest, PopsInOrder) {
+	auto queue = SPSCQueue<int, 4>();
+	EXPECT_TRUE(queue.empty());
+
+	EXPECT_TRUE(queue.push(1));
+	EXPECT_TRUE(queue.push(2));
+	EXPECT_FALSE(queue.empty());
+	EXPECT_EQ(*queue.peek(), 1);
+
+	int value = 0;
+	EXPECT_TRUE(queue.pop(value));
+	EXPECT_EQ(value, 1);
+	EXPECT_TRUE(queue.pop(value));
+	EXPECT_EQ(value, 2);
+	EXPECT_FALSE(queue.pop(value));
+	EXPECT_EQ(queue.peek(), nullptr);
+}
+
+TEST(SPSCQueueTest, PushFailsWhenFull) {
+	auto queue = SPSCQueue<int, 4>();
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_TRUE(queue.push(i));
+	}
+	EXPECT_FALSE(queue.push(4));
+
+	int value = 0;
+	EXPECT_TRUE(queue.pop(value));
+	EXPECT_TRUE(queue.push(4));
+}
+
+TEST(SPSCQueueTest, TransfersAllElementsAcrossThreads) {
+	auto queue = SPSCQueue<int, 64>();
+	const int count = 100000;
+
+	auto producer = thread([&] {
+		for (int i = 0; i < count; ++i) {
+			while (!queue.push(i)) {
+				this_thread::yield();
+			}
+		}
+	});
+
+	for (int expected = 0; expected < count;) {
+		int value;
+		if (queue.pop(value)) {
+			EXPECT_EQ(value, expected);
+			expected++;
+		} else {
+			this_thread::yield();
+		}
+	}
+
+	producer.join();
+}
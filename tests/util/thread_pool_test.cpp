@@ -0,0 +1,96 @@
+#include "util/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace testing;
+using namespace std;
+
+TEST(ThreadPoolTest, RunsEveryPartOnce) {
+	auto pool = ThreadPool(4);
+	auto counts = vector<atomic<int>>(100);
+
+	pool.parallel_for(counts.size(), [&](size_t part) { counts[part]++; });
+
+	for (auto &count : counts) {
+		EXPECT_EQ(count, 1);
+	}
+}
+
+TEST(ThreadPoolTest, RunsManyJobs) {
+	auto pool = ThreadPool(3);
+	auto total = atomic<size_t>(0);
+
+	for (auto job = 0; job < 200; ++job) {
+		pool.parallel_for(8, [&](size_t part) { total += part; });
+	}
+
+	EXPECT_EQ(total, 200u * 28u);
+}
+
+TEST(ThreadPoolTest, RunsOnEachThread) {
+	auto pool = ThreadPool(4);
+	auto threads = vector<thread::id>(pool.get_thread_count());
+	auto same_thread = atomic<bool>(true);
+
+	// Every index runs once per job, and always on the same thread
+	for (auto job = 0; job < 50; ++job) {
+		pool.run_on_each([&](size_t index) {
+			if (job == 0) {
+				threads[index] = this_thread::get_id();
+			} else if (threads[index] != this_thread::get_id()) {
+				same_thread = false;
+			}
+		});
+	}
+
+	EXPECT_TRUE(same_thread);
+	EXPECT_EQ(threads[0], this_thread::get_id());
+	for (auto i = size_t{1}; i < threads.size(); ++i) {
+		EXPECT_NE(threads[i], threads[0]);
+	}
+}
+
+#if defined(__linux__)
+TEST(ThreadPoolTest, PinsEveryIndexToItsCore) {
+	auto pool = ThreadPool(4);
+	auto before = cpu_set_t();
+	pthread_getaffinity_np(pthread_self(), sizeof(before), &before);
+	if (!pool.pin_threads()) {
+		// Only some cores may be used here, so there's nothing to check
+		return;
+	}
+
+	// The calling thread's index is pinned for the job as well
+	auto cores = vector<int>(pool.get_thread_count());
+	pool.run_on_each([&](size_t index) { cores[index] = sched_getcpu(); });
+	auto core_count = max(1u, thread::hardware_concurrency());
+	for (auto i = size_t{0}; i < cores.size(); ++i) {
+		EXPECT_EQ(cores[i], static_cast<int>(i % core_count));
+	}
+
+	// It gets back the cores it was allowed on afterwards
+	auto after = cpu_set_t();
+	pthread_getaffinity_np(pthread_self(), sizeof(after), &after);
+	EXPECT_TRUE(CPU_EQUAL(&before, &after));
+}
+#endif
+
+TEST(ThreadPoolTest, SingleThread) {
+	auto pool = ThreadPool(1);
+	auto total = 0;
+
+	pool.parallel_for(10, [&](size_t) { total++; });
+
+	EXPECT_EQ(pool.get_thread_count(), 1u);
+	EXPECT_EQ(total, 10);
+}
@@ -0,0 +1,63 @@
+#include "util/triple_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace testing;
+using namespace std;
+
+TEST(TripleBufferTest, NoValueBeforePublish) {
+	auto buffer = TripleBuffer<int>();
+	EXPECT_FALSE(buffer.update());
+}
+
+TEST(TripleBufferTest, ReadsPublishedValue) {
+	auto buffer = TripleBuffer<int>();
+
+	buffer.get_back() = 42;
+	buffer.publish();
+
+	EXPECT_TRUE(buffer.update());
+	EXPECT_EQ(buffer.get_front(), 42);
+
+	// The same value is not seen twice
+	EXPECT_FALSE(buffer.update());
+	EXPECT_EQ(buffer.get_front(), 42);
+}
+
+TEST(TripleBufferTest, KeepsOnlyLatestValue) {
+	auto buffer = TripleBuffer<int>();
+
+	for (int i = 1; i <= 5; ++i) {
+		buffer.get_back() = i;
+		buffer.publish();
+	}
+
+	EXPECT_TRUE(buffer.update());
+	EXPECT_EQ(buffer.get_front(), 5);
+}
+
+TEST(TripleBufferTest, ValuesNeverGoBackwardsAcrossThreads) {
+	auto buffer = TripleBuffer<int>();
+	const int count = 100000;
+
+	auto producer = thread([&] {
+		for (int i = 1; i <= count; ++i) {
+			buffer.get_back() = i;
+			buffer.publish();
+		}
+	});
+
+	int last = 0;
+	while (last != count) {
+		if (buffer.update()) {
+			EXPECT_GT(buffer.get_front(), last);
+			last = buffer.get_front();
+		} else {
+			this_thread::yield();
+		}
+	}
+
+	producer.join();
+}
@@ -0,0 +1,60 @@
+#include "util/work_stealing_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce) {
+	auto pool = WorkStealingPool(4);
+	auto counts = vector<atomic<int>>(100);
+	auto bad_worker = atomic<bool>(false);
+
+	pool.run(counts.size(), [&](size_t task, size_t worker) {
+		counts[task]++;
+		if (worker >= pool.get_thread_count()) {
+			bad_worker = true;
+		}
+	});
+
+	for (auto &count : counts) {
+		EXPECT_EQ(count, 1);
+	}
+	EXPECT_FALSE(bad_worker);
+}
+
+TEST(WorkStealingPoolTest, StealsFromSlowThreads) {
+	auto pool = WorkStealingPool(2);
+	auto ran_by = vector<atomic<size_t>>(20);
+
+	// The first share is all slow tasks, so the second thread finishes its
+	// own share first and takes over the rest of the first
+	pool.run(ran_by.size(), [&](size_t task, size_t worker) {
+		if (task < ran_by.size() / 2) {
+			this_thread::sleep_for(chrono::milliseconds(5));
+		}
+		ran_by[task] = worker;
+	});
+
+	EXPECT_GT(pool.get_steal_count(), 0u);
+	EXPECT_EQ(ran_by[0], 0u);
+	EXPECT_EQ(ran_by[ran_by.size() / 2 - 1], 1u);
+}
+
+TEST(WorkStealingPoolTest, SingleThreadRunsInOrder) {
+	auto pool = WorkStealingPool(1);
+	auto order = vector<size_t>();
+
+	pool.run(10, [&](size_t task, size_t) { order.push_back(task); });
+
+	ASSERT_EQ(order.size(), 10u);
+	for (auto i = size_t{0}; i < order.size(); ++i) {
+		EXPECT_EQ(order[i], i);
+	}
+	EXPECT_EQ(pool.get_steal_count(), 0u);
+}
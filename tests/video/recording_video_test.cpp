@@ -0,0 +1,106 @@
+#include "video/buffer_video.h"
+#include "video/packed_frame.h"
+#include "video/recording_video.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace gpu;
+using namespace video;
+
+/**
+ * Make a frame with a different pattern for each seed
+ */
+VideoBuffer make_frame(unsigned int seed) {
+	auto frame = VideoBuffer();
+	for (auto i = 0u; i < PIXEL_COUNT; ++i) {
+		frame[i] = static_cast<Pixel>((i * seed + i / 7) % 4);
+	}
+	return frame;
+}
+
+/**
+ * Paint two frames with repeats in between through a RecordingVideo, and
+ * return the contents of the recording
+ */
+string record(const string &path, RecordFormat format, BufferVideo **output) {
+	{
+		auto buffer_video = make_unique<BufferVideo>();
+		*output = buffer_video.get();
+		auto recorder = RecordingVideo(move(buffer_video), path, format);
+		EXPECT_TRUE(recorder.is_open());
+
+		auto first = make_frame(1);
+		auto second = make_frame(3);
+		recorder.paint(first, {0, 0});
+		recorder.repeat({1, 1});
+		recorder.repeat({2, 2});
+		recorder.paint(second, {3, 3});
+
+		// The output driver is still painted to
+		EXPECT_EQ(recorder.get_output(), *output);
+		EXPECT_EQ((*output)->get_frame_count(), 4u);
+	}
+
+	auto file = ifstream(path, ios::binary);
+	auto contents = string(istreambuf_iterator<char>(file), {});
+	remove(path.c_str());
+	return contents;
+}
+
+TEST(RecordingVideoTest, PackRoundTrip) {
+	auto frame = make_frame(5);
+	auto packed = PackedFrame();
+	auto unpacked = VideoBuffer();
+
+	pack_frame(frame, packed);
+	unpack_frame(packed, unpacked);
+
+	EXPECT_EQ(frame, unpacked);
+}
+
+TEST(RecordingVideoTest, PicksFormatFromExtension) {
+	EXPECT_EQ(get_record_format("a.y4m"), RecordFormat::Y4M);
+	EXPECT_EQ(get_record_format("a.rgba"), RecordFormat::RGBA);
+	EXPECT_EQ(get_record_format("a.tvpv"), RecordFormat::PACKED);
+	EXPECT_FALSE(get_record_format("a.mp4"));
+}
+
+TEST(RecordingVideoTest, PackedStoresRepeats) {
+	BufferVideo *output;
+	auto contents =
+	    record("recording_test.tvpv", RecordFormat::PACKED, &output);
+	auto frame_size = PIXEL_COUNT / 4;
+
+	ASSERT_EQ(contents.size(), 5 + (1 + frame_size) + 5 + (1 + frame_size));
+	EXPECT_EQ(contents.substr(0, 4), "TVPV");
+	EXPECT_EQ(contents[4], 1);
+	EXPECT_EQ(contents[5], 'F');
+
+	auto repeat = 5 + 1 + frame_size;
+	EXPECT_EQ(contents[repeat], 'R');
+	EXPECT_EQ(contents[repeat + 1], 2);
+	EXPECT_EQ(contents[repeat + 5], 'F');
+
+	auto packed = PackedFrame();
+	auto unpacked = VideoBuffer();
+	std::copy_n(contents.begin() + repeat + 6, frame_size, packed.begin());
+	unpack_frame(packed, unpacked);
+	EXPECT_EQ(unpacked, make_frame(3));
+}
+
+TEST(RecordingVideoTest, Y4MWritesEveryFrame) {
+	BufferVideo *output;
+	auto contents = record("recording_test.y4m", RecordFormat::Y4M, &output);
+	auto header_end = contents.find('\n') + 1;
+
+	EXPECT_EQ(contents.substr(0, 9), "YUV4MPEG2");
+	EXPECT_EQ(contents.size(), header_end + 4 * (6 + PIXEL_COUNT));
+}
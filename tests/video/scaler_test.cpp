@@ -0,0 +1,93 @@
+#include "video/scaler.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace std;
+using namespace gpu;
+using namespace video;
+
+/**
+ * Scale a frame with a single strip, and return the output
+ */
+vector<Pixel> scale(const ScalerInterface &scaler, const VideoBuffer &frame) {
+	auto factor = scaler.get_factor();
+	auto output = vector<Pixel>(PIXEL_COUNT * factor * factor);
+	scaler.scale_rows(frame, output.data(), 0, SCREEN_HEIGHT);
+	return output;
+}
+
+TEST(ScalerTest, NearestRepeatsPixels) {
+	auto frame = VideoBuffer();
+	frame.fill(Pixel::ZERO);
+	frame[SCREEN_WIDTH + 1] = Pixel::THREE;
+
+	auto output = scale(NearestScaler(3), frame);
+	auto width = SCREEN_WIDTH * 3;
+
+	for (auto y = 3; y < 6; ++y) {
+		for (auto x = 3; x < 6; ++x) {
+			EXPECT_EQ(output[y * width + x], Pixel::THREE);
+		}
+	}
+	EXPECT_EQ(output[2 * width + 3], Pixel::ZERO);
+	EXPECT_EQ(output[3 * width + 6], Pixel::ZERO);
+}
+
+TEST(ScalerTest, Scale2xFlatFrameIsUnchanged) {
+	auto frame = VideoBuffer();
+	frame.fill(Pixel::TWO);
+
+	for (auto pixel : scale(Scale2xScaler(), frame)) {
+		EXPECT_EQ(pixel, Pixel::TWO);
+	}
+}
+
+TEST(ScalerTest, Scale2xSmoothsDiagonal) {
+	// A staircase of ONE below a diagonal line, on a ZERO background
+	auto frame = VideoBuffer();
+	frame.fill(Pixel::ZERO);
+	for (auto y = 0; y < SCREEN_HEIGHT; ++y) {
+		for (auto x = 0; x < y && x < SCREEN_WIDTH; ++x) {
+			frame[y * SCREEN_WIDTH + x] = Pixel::ONE;
+		}
+	}
+
+	auto output = scale(Scale2xScaler(), frame);
+	auto width = SCREEN_WIDTH * 2;
+
+	// Pixel (5, 5) is the ZERO just right of the step, so its bottom left
+	// corner gets filled in from the ONE on the left and below
+	EXPECT_EQ(output[10 * width + 10], Pixel::ZERO);
+	EXPECT_EQ(output[10 * width + 11], Pixel::ZERO);
+	EXPECT_EQ(output[11 * width + 10], Pixel::ONE);
+	EXPECT_EQ(output[11 * width + 11], Pixel::ZERO);
+}
+
+TEST(ScalerTest, PipelineMatchesSingleThread) {
+	auto frame = VideoBuffer();
+	for (auto i = 0u; i < PIXEL_COUNT; ++i) {
+		frame[i] = static_cast<Pixel>((i * 7 + i / 13) % 4);
+	}
+
+	auto palette = Palette{{
+	    {0, 0, 0, 255},
+	    {1, 1, 1, 255},
+	    {2, 2, 2, 255},
+	    {3, 3, 3, 255},
+	}};
+	auto expected = scale(Scale3xScaler(), frame);
+
+	auto pipeline = ScalerPipeline(make_scaler(ScalerType::SCALE3X, 0),
+	                               palette, 4);
+	auto rgba = pipeline.process(frame);
+
+	ASSERT_EQ(pipeline.get_width(), SCREEN_WIDTH * 3u);
+	ASSERT_EQ(pipeline.get_height(), SCREEN_HEIGHT * 3u);
+	for (auto i = 0u; i < expected.size(); ++i) {
+		ASSERT_EQ(rgba[i * 4], static_cast<uint8_t>(expected[i]));
+		ASSERT_EQ(rgba[i * 4 + 3], 255);
+	}
+}
@@ -0,0 +1,81 @@
+#include "gameboy/test_rom.h"
+#include "video/buffer_video.h"
+#include "video/shared_frames.h"
+#include "video/shared_memory_video.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace testing;
+using namespace std;
+using namespace gpu;
+using namespace video;
+
+TEST(SharedMemoryVideoTest, ReaderSeesLatestFrame) {
+	auto shm_name = get_test_name("");
+	auto writer = SharedMemoryVideo(make_unique<BufferVideo>(), shm_name, 4);
+	ASSERT_TRUE(writer.is_open());
+
+	auto reader = SharedFrameReader(shm_name);
+	ASSERT_TRUE(reader.is_open());
+	EXPECT_EQ(reader.get_header()->slot_count, 4u);
+	EXPECT_EQ(reader.get_header()->width, SCREEN_WIDTH);
+
+	auto frame = VideoBuffer();
+	auto info = FrameInfo{};
+	EXPECT_FALSE(reader.read_latest(frame, info));
+
+	// Go around the ring a couple of times
+	auto painted = VideoBuffer();
+	for (auto i = 0u; i < 10; ++i) {
+		painted.fill(static_cast<Pixel>(i % 4));
+		writer.paint(painted, {i, i * 100});
+	}
+
+	ASSERT_TRUE(reader.read_latest(frame, info));
+	EXPECT_EQ(frame, painted);
+	EXPECT_EQ(info.number, 9u);
+	EXPECT_EQ(info.cycles, 900u);
+	EXPECT_EQ(reader.get_header()->frames_published, 10u);
+
+	// Repeats are published as unchanged, with the pixels from before, and
+	// passed on
+	auto unchanged = false;
+	writer.repeat({10, 1000});
+	auto output = static_cast<BufferVideo *>(writer.get_output());
+	EXPECT_EQ(output->get_frame_count(), 11u);
+	EXPECT_EQ(reader.get_header()->frames_published, 11u);
+	ASSERT_TRUE(reader.read_latest(frame, info, &unchanged));
+	EXPECT_TRUE(unchanged);
+	EXPECT_EQ(frame, painted);
+	EXPECT_EQ(info.number, 10u);
+	EXPECT_EQ(info.cycles, 1000u);
+
+	writer.paint(painted, {11, 1100});
+	ASSERT_TRUE(reader.read_latest(frame, info, &unchanged));
+	EXPECT_FALSE(unchanged);
+	EXPECT_EQ(info.number, 11u);
+}
+
+TEST(SharedMemoryVideoTest, NameInUseFailsToOpen) {
+	auto shm_name = get_test_name("");
+	auto writer =
+	    make_unique<SharedMemoryVideo>(make_unique<BufferVideo>(), shm_name);
+	ASSERT_TRUE(writer->is_open());
+
+	// A second writer would take over the first one's frames
+	auto other = SharedMemoryVideo(make_unique<BufferVideo>(), shm_name);
+	EXPECT_FALSE(other.is_open());
+
+	// Once the first writer is gone, the name can be used again
+	writer.reset();
+	writer =
+	    make_unique<SharedMemoryVideo>(make_unique<BufferVideo>(), shm_name);
+	EXPECT_TRUE(writer->is_open());
+}
+
+TEST(SharedMemoryVideoTest, MissingRingFailsToOpen) {
+	auto reader = SharedFrameReader("tvp_no_such_shared_frames");
+	EXPECT_FALSE(reader.is_open());
+}
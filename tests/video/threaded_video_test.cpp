@@ -0,0 +1,113 @@
+#include "gameboy/gameboy.h"
+#include "gameboy/test_rom.h"
+#include "video/threaded_video.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace testing;
+using namespace std;
+using namespace std::chrono;
+using namespace gpu;
+using namespace video;
+using namespace gameboy;
+using namespace controller;
+
+class ThreadedVideoTest : public TestRomTest {};
+
+TEST_F(ThreadedVideoTest, ProjectsCyclesFromTheNewestFrame) {
+	auto inputs = InputQueue();
+	auto pacer = FramePacer(cpu::CLOCK_SPEED);
+	auto video = ThreadedVideo(&inputs, &pacer);
+
+	auto before = steady_clock::now();
+	video.repeat({1, 10000});
+	auto after = steady_clock::now();
+
+	// 10ms after the frame is 41943 cycles on, give or take how long the
+	// frame took to note
+	auto cycles_in = [](steady_clock::duration time) {
+		return static_cast<uint64_t>(duration<double>(time).count() *
+		                             cpu::CLOCK_SPEED);
+	};
+	auto projected = video.project_cycle(after + milliseconds(10));
+	EXPECT_GE(projected, 10000 + cycles_in(milliseconds(10)) - 1);
+	EXPECT_LE(projected,
+	          10000 + cycles_in(milliseconds(10) + (after - before)));
+
+	pacer.set_speed(2.0);
+	EXPECT_GE(video.project_cycle(after + milliseconds(5)),
+	          10000 + cycles_in(milliseconds(10)) - 1);
+
+	// Emulation that falls behind holds input back for a frame at most
+	EXPECT_EQ(video.project_cycle(after + seconds(1)), 10000 + CLOCKS_FRAME);
+
+	pacer.set_turbo(true);
+	EXPECT_EQ(video.project_cycle(after + milliseconds(10)), 10000u);
+}
+
+TEST_F(ThreadedVideoTest, PressLandsOnTheStampedCycle) {
+	auto pacer = FramePacer(cpu::CLOCK_SPEED);
+	InputQueue *inputs = nullptr;
+	ThreadedVideo *video = nullptr;
+	auto video_factory = [&](InputQueue *queue, CartridgeMetadata *) {
+		auto driver = make_unique<ThreadedVideo>(queue, &pacer);
+		inputs = queue;
+		video = driver.get();
+		return unique_ptr<VideoInterface>(move(driver));
+	};
+	auto gameboy = make_unique<Gameboy>(rom_path, video_factory);
+	gameboy->skip_boot();
+	gameboy->run_frame();
+	auto frame_end = gameboy->get_cycle_count();
+
+	// Skipping the boot ROM loads a state, after which the first tick flushes
+	// any input, so get that out of the way
+	gameboy->tick();
+
+	// The press is stamped after the frame, since time has gone by
+	ASSERT_TRUE(video->send_input(Button::A, true));
+	auto stamp = inputs->peek()->cycle;
+	EXPECT_GE(stamp, frame_end);
+	EXPECT_LE(stamp, frame_end + CLOCKS_FRAME);
+
+	// Each tick runs one instruction, which is a few cycles, so the press
+	// must land on the first tick at or past its stamp
+	auto last_cycle = gameboy->get_cycle_count();
+	while (!(gameboy->controller->get_buttons() & 0x10)) {
+		last_cycle = gameboy->get_cycle_count();
+		ASSERT_LT(last_cycle, stamp + CLOCKS_FRAME);
+		gameboy->tick();
+	}
+	EXPECT_GE(last_cycle, stamp);
+	EXPECT_LT(last_cycle, stamp + 24);
+}
+
+TEST_F(ThreadedVideoTest, RunAheadTakesInputOnTheNextFrame) {
+	auto pacer = FramePacer(cpu::CLOCK_SPEED);
+	ThreadedVideo *video = nullptr;
+	auto video_factory = [&](InputQueue *queue, CartridgeMetadata *) {
+		auto driver = make_unique<ThreadedVideo>(queue, &pacer);
+		video = driver.get();
+		return unique_ptr<VideoInterface>(move(driver));
+	};
+	auto gameboy = make_unique<Gameboy>(rom_path, video_factory);
+	gameboy->skip_boot();
+	for (auto i = 0; i < 3; ++i) {
+		gameboy->apply_inputs(CLOCKS_FRAME);
+		gameboy->run_ahead(1, true);
+	}
+
+	// The frame shown is a frame ahead, but it is stamped where the Gameboy
+	// is, so a press part way through the frame is taken at the start of the
+	// next one
+	this_thread::sleep_for(milliseconds(2));
+	EXPECT_LE(video->project_cycle(steady_clock::now()),
+	          gameboy->get_cycle_count() + CLOCKS_FRAME);
+	ASSERT_TRUE(video->send_input(Button::A, true));
+	gameboy->apply_inputs(CLOCKS_FRAME);
+	gameboy->run_ahead(1, true);
+	EXPECT_TRUE(gameboy->controller->get_buttons() & 0x10);
+}